@@ -0,0 +1,615 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <graph_lib/apsp.hpp>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/compressed_graph.hpp>
+#include <graph_lib/contraction_hierarchy.hpp>
+#include <graph_lib/dense_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/disk_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/incremental.hpp>
+#include <graph_lib/khop.hpp>
+#include <graph_lib/max_flow.hpp>
+#include <graph_lib/partitioning.hpp>
+#include <graph_lib/random.hpp>
+#include <graph_lib/random_walk.hpp>
+#include <graph_lib/reorder.hpp>
+#include <graph_lib/shortest_path.hpp>
+#include <graph_lib/spanning_forest.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+#ifndef GRAPH_LIB_BENCH_MAX_EDGES
+#define GRAPH_LIB_BENCH_MAX_EDGES 10000000
+#endif
+
+namespace
+{
+constexpr int64_t kMinEdges = 1000;
+constexpr int64_t kMaxEdges = GRAPH_LIB_BENCH_MAX_EDGES;
+
+//! \brief Average out-degree of the benchmark graphs.
+constexpr int64_t kAverageDegree = 8;
+
+//! \brief Bytes currently held by the global allocator.
+std::atomic<int64_t> live_bytes{0};
+
+// Every allocation carries a header holding its size so that delete can
+// subtract exactly what new added.
+constexpr std::size_t kHeaderSize = alignof(std::max_align_t);
+
+int64_t vertexCount(int64_t edges) { return std::max<int64_t>(edges / kAverageDegree, 2); }
+
+//! \brief Deterministic edge list with roughly kAverageDegree out-edges per vertex.
+std::vector<std::pair<int64_t, int64_t>> makeEdges(int64_t edges)
+{
+  const int64_t vertices = vertexCount(edges);
+  std::vector<std::pair<int64_t, int64_t>> result;
+  result.reserve(edges);
+
+  uint64_t state = 0x9E3779B97F4A7C15ull;
+  for (int64_t i = 0; i < edges; i++)
+  {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    result.emplace_back(i % vertices, (state >> 33) % vertices);
+  }
+  return result;
+}
+
+template <typename G>
+bool addEdge(G& graph, unsigned int origin, unsigned int dest)
+{
+  if constexpr (G::is_weighted) { return graph.addEdge(origin, dest, 1.0f); }
+  else { return graph.addEdge(origin, dest); }
+}
+
+template <typename G>
+std::vector<unsigned int> addVertices(G& graph, int64_t count)
+{
+  std::vector<unsigned int> ids;
+  ids.reserve(count);
+  for (int64_t i = 0; i < count; i++) { ids.push_back(*graph.addVertex(static_cast<int>(i))); }
+  return ids;
+}
+
+template <typename G>
+std::vector<unsigned int> buildGraph(G& graph, int64_t edges)
+{
+  auto ids = addVertices(graph, vertexCount(edges));
+  for (auto [origin, dest] : makeEdges(edges)) { addEdge(graph, ids[origin], ids[dest]); }
+  return ids;
+}
+
+template <typename G, typename Begin, typename End>
+void traverse(benchmark::State& state, Begin begin, End end)
+{
+  G graph;
+  buildGraph(graph, state.range(0));
+
+  for (auto _ : state)
+  {
+    size_t count = 0;
+    const auto last = (graph.*end)();
+    for (auto itr = (graph.*begin)(); itr != last; ++itr) { benchmark::DoNotOptimize(*itr); count++; }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * graph.getSize());
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  void* block = std::malloc(size + kHeaderSize);
+  if (block == nullptr) { throw std::bad_alloc(); }
+  *static_cast<std::size_t*>(block) = size;
+  live_bytes.fetch_add(size, std::memory_order_relaxed);
+  return static_cast<char*>(block) + kHeaderSize;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr == nullptr) { return; }
+  void* block = static_cast<char*>(ptr) - kHeaderSize;
+  live_bytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+  std::free(block);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+
+
+template <typename G>
+static void BM_AddVertex(benchmark::State& state)
+{
+  const int64_t count = vertexCount(state.range(0));
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    {
+      G graph;
+      state.ResumeTiming();
+      benchmark::DoNotOptimize(addVertices(graph, count));
+      state.PauseTiming();
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename G>
+static void BM_AddEdge(benchmark::State& state)
+{
+  const auto edges = makeEdges(state.range(0));
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    {
+      G graph;
+      auto ids = addVertices(graph, vertexCount(state.range(0)));
+      state.ResumeTiming();
+      for (auto [origin, dest] : edges) { benchmark::DoNotOptimize(addEdge(graph, ids[origin], ids[dest])); }
+      state.PauseTiming();
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! \brief BM_AddEdge with the incoming edge index kept, to measure what maintaining it costs.
+template <typename G>
+static void BM_AddEdgeIncoming(benchmark::State& state)
+{
+  const auto edges = makeEdges(state.range(0));
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    {
+      G graph;
+      auto ids = addVertices(graph, vertexCount(state.range(0)));
+      graph.enableIncomingIndex();
+      state.ResumeTiming();
+      for (auto [origin, dest] : edges) { benchmark::DoNotOptimize(addEdge(graph, ids[origin], ids[dest])); }
+      state.PauseTiming();
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename G>
+static void BM_GetVertex(benchmark::State& state)
+{
+  G graph;
+  const auto ids = buildGraph(graph, state.range(0));
+
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(graph.getVertex(ids[i]));
+    i = (i + 7919) % ids.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename G>
+static void BM_Iterate(benchmark::State& state) { traverse<G>(state, &G::begin, &G::end); }
+
+template <typename G>
+static void BM_DFS(benchmark::State& state) { traverse<G>(state, &G::dfs_begin, &G::dfs_end); }
+
+template <typename G>
+static void BM_BFS(benchmark::State& state) { traverse<G>(state, &G::bfs_begin, &G::bfs_end); }
+
+template <typename G>
+static void BM_MemoryPerEdge(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    const int64_t before = live_bytes.load();
+    G graph;
+    buildGraph(graph, state.range(0));
+    const int64_t used = live_bytes.load() - before;
+
+    state.counters["bytes"] = static_cast<double>(used);
+    state.counters["bytes_per_edge"] = static_cast<double>(used) / state.range(0);
+    state.counters["bytes_per_vertex"] = static_cast<double>(used) / vertexCount(state.range(0));
+    state.counters["reported_bytes_per_edge"] = static_cast<double>(graph.memoryUsage().total()) / state.range(0);
+  }
+}
+
+//! \brief BFS from every unvisited vertex of an R-MAT CompactGraph.
+//! The second argument is the ReorderMethod applied first, or -1 to keep the insertion order.
+static void BM_CompactBFS(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {1});
+  auto graph = graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list);
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  if (state.range(1) >= 0) { graph_lib::reorder(compact, static_cast<graph_lib::ReorderMethod>(state.range(1))); }
+
+  std::vector<graph_lib::CompactGraph::Index> queue(compact.vertexCount());
+  std::vector<bool> visited;
+  for (auto _ : state)
+  {
+    visited.assign(compact.vertexCount(), false);
+    for (graph_lib::CompactGraph::Index start = 0; start < compact.vertexCount(); start++)
+    {
+      if (visited[start]) { continue; }
+      size_t head = 0, tail = 0;
+      queue[tail++] = start;
+      visited[start] = true;
+      while (head < tail)
+      {
+        for (auto u : compact.neighbors(queue[head++])) { if (!visited[u]) { visited[u] = true; queue[tail++] = u; } }
+      }
+    }
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetItemsProcessed(state.iterations() * compact.edgeCount());
+}
+
+BENCHMARK(BM_CompactBFS)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges, 10), {-1, 0, 1, 2, 3}})
+  ->ArgNames({"edges", "order"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief A batch of 1024 2-hop queries over 256 distinct seeds of an R-MAT CompactGraph.
+//! The second argument is the number of threads.
+static void BM_KHopBatch(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {1});
+  auto graph = graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list);
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+
+  std::vector<graph_lib::KHopQuery> queries;
+  for (unsigned i = 0; i < 1024; i++) { queries.push_back({compact.externalId((i % 256) * 7919 % compact.vertexCount()), 2}); }
+  size_t answered = 0;
+  for (auto _ : state)
+  {
+    auto results = graph_lib::kHopNeighborhoods(compact, queries, {.threads = static_cast<unsigned>(state.range(1))});
+    answered = results.totalVertices();
+    benchmark::DoNotOptimize(results);
+  }
+  state.counters["vertices_per_batch"] = answered;
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_KHopBatch)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges, 10), {1, 4}})
+  ->ArgNames({"edges", "threads"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief Random s-t queries on a weighted grid, a stand-in for a road network.
+//! The second argument selects bidirectional Dijkstra (0) or the contraction hierarchy (1).
+static void BM_PointToPoint(benchmark::State& state)
+{
+  const uint64_t side = std::max<uint64_t>(2, static_cast<uint64_t>(std::sqrt(vertexCount(state.range(0)))));
+  auto list = graph_lib::gridEdges(side, side, {.seed = 1, .weights = graph_lib::WeightDistribution::uniform(1, 10)});
+  auto compact = graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list));
+  graph_lib::ShortestPathEngine engine(compact);
+  const auto hierarchy = state.range(1) == 1 ? graph_lib::ContractionHierarchy::build(compact) : graph_lib::ContractionHierarchy();
+
+  graph_lib::CounterRng rng(2);
+  uint64_t counter = 0;
+  for (auto _ : state)
+  {
+    const auto source = compact.externalId(rng.below(counter, compact.vertexCount(), 0));
+    const auto target = compact.externalId(rng.below(counter++, compact.vertexCount(), 1));
+    auto result = state.range(1) == 1 ? hierarchy.query(source, target) : engine.bidirectionalDijkstra(source, target);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PointToPoint)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges, 10), {0, 1}})
+  ->ArgNames({"edges", "ch"})
+  ->Unit(benchmark::kMicrosecond);
+
+//! \brief All-pairs shortest paths on a weighted Erdos-Renyi graph of average degree 8.
+//! The second argument is the ApspMethod: Floyd-Warshall (1) or Dijkstra from every vertex (2).
+static void BM_AllPairs(benchmark::State& state)
+{
+  const auto n = static_cast<uint64_t>(state.range(0));
+  auto list = graph_lib::erdosRenyiEdges(n, n * kAverageDegree, {.seed = 4, .weights = graph_lib::WeightDistribution::uniform(1, 10)});
+  auto compact = graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<int>>(list));
+  const auto method = static_cast<graph_lib::ApspMethod>(state.range(1));
+  for (auto _ : state)
+  {
+    auto matrix = graph_lib::allPairsShortestPaths(compact, {.method = method});
+    benchmark::DoNotOptimize(matrix);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+BENCHMARK(BM_AllPairs)
+  ->ArgsProduct({{256, 1024, 2048}, {1, 2}})
+  ->ArgNames({"vertices", "method"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief Minimum spanning forest of a weighted undirected R-MAT graph.
+//! The second argument is the number of threads.
+static void BM_SpanningForest(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {.seed = 1, .weights = graph_lib::WeightDistribution::uniform(1, 100)});
+  auto compact = graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list));
+  for (auto _ : state)
+  {
+    auto forest = graph_lib::minimumSpanningForest(compact, {.threads = static_cast<unsigned>(state.range(1))});
+    benchmark::DoNotOptimize(forest);
+  }
+  state.SetItemsProcessed(state.iterations() * compact.edgeCount() / 2);
+}
+
+BENCHMARK(BM_SpanningForest)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges, 10), {1, 4}})
+  ->ArgNames({"edges", "threads"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief Maximum flow between the two highest-degree vertices of a weighted directed R-MAT graph.
+//! The second argument is the FlowMethod: push-relabel (0) or Dinic (1).
+static void BM_MaxFlow(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {.seed = 1, .weights = graph_lib::WeightDistribution::uniform(1, 100)});
+  graph_lib::FlowNetwork network(graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<int>>(list)));
+  const auto& graph = network.graph();
+  std::vector<graph_lib::CompactGraph::Index> order(graph.vertexCount());
+  std::iota(order.begin(), order.end(), 0);
+  std::partial_sort(order.begin(), order.begin() + 2, order.end(), [&](auto a, auto b) { return graph.degree(a) > graph.degree(b); });
+
+  const auto method = static_cast<graph_lib::FlowMethod>(state.range(1));
+  for (auto _ : state)
+  {
+    auto result = network.maxFlow(graph.externalId(order[0]), graph.externalId(order[1]), method);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+BENCHMARK(BM_MaxFlow)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges / 10, 10), {0, 1}})
+  ->ArgNames({"edges", "method"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief BFS over a random directed graph where every edge exists with probability 1/2.
+//! Runs on the hash adjacency lists and on the bit matrix with the same edges.
+template <typename G>
+static void BM_DenseBFS(benchmark::State& state)
+{
+  const auto n = static_cast<unsigned>(state.range(0));
+  graph_lib::CounterRng rng(3);
+  G graph;
+  auto ids = addVertices(graph, n);
+  int64_t edges = 0;
+  for (unsigned i = 0; i < n; i++)
+  {
+    for (unsigned j = 0; j < n; j++)
+    {
+      if (i != j && rng.below(uint64_t{i} * n + j, 2, 0) == 0) { edges += graph.addEdge(ids[i], ids[j]); }
+    }
+  }
+
+  for (auto _ : state)
+  {
+    size_t visited = 0;
+    const auto last = graph.bfs_end();
+    for (auto itr = graph.bfs_begin(); itr != last; ++itr) { visited++; }
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetItemsProcessed(state.iterations() * edges);
+}
+
+BENCHMARK_TEMPLATE(BM_DenseBFS, graph_lib::UnweightedDirectedGraph<int>)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DenseBFS, graph_lib::DenseUnweightedDirectedGraph<int>)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+//! \brief BFS from every unvisited vertex of an R-MAT graph with compressed adjacency.
+//! The second argument is the AdjacencyEncoding, or -1 for the uncompressed CompactGraph.
+//! Reports the adjacency bytes per edge next to the throughput.
+static void BM_CompressedBFS(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {1});
+  auto compact = graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+  std::optional<graph_lib::CompressedGraph> compressed;
+  if (state.range(1) >= 0)
+  {
+    compressed = graph_lib::CompressedGraph::fromCompact(compact, {.encoding = static_cast<graph_lib::AdjacencyEncoding>(state.range(1))});
+  }
+
+  std::vector<graph_lib::CompactGraph::Index> queue(compact.vertexCount());
+  std::vector<bool> visited;
+  for (auto _ : state)
+  {
+    visited.assign(compact.vertexCount(), false);
+    for (graph_lib::CompactGraph::Index start = 0; start < compact.vertexCount(); start++)
+    {
+      if (visited[start]) { continue; }
+      size_t head = 0, tail = 0;
+      queue[tail++] = start;
+      visited[start] = true;
+      auto visit = [&](graph_lib::CompactGraph::Index u) { if (!visited[u]) { visited[u] = true; queue[tail++] = u; } };
+      while (head < tail)
+      {
+        const auto v = queue[head++];
+        if (compressed) { compressed->forEachNeighbor(v, visit); }
+        else { for (auto u : compact.neighbors(v)) { visit(u); } }
+      }
+    }
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetItemsProcessed(state.iterations() * compact.edgeCount());
+  state.counters["bytes_per_edge"] = compressed ? compressed->bytesPerEdge() : sizeof(graph_lib::CompactGraph::Index);
+}
+
+BENCHMARK(BM_CompressedBFS)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges, 10), {-1, 0, 1}})
+  ->ArgNames({"edges", "encoding"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief One PageRank iteration streamed over an R-MAT graph stored in partition files.
+//! The second argument is the page cache budget in partitions: 0 keeps only the
+//! partition being read mapped, 1 keeps every partition mapped.
+static void BM_DiskPageRank(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {1});
+  auto compact = graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+  const auto directory = std::filesystem::temp_directory_path() / ("graph_lib_bench_disk_" + std::to_string(state.range(0)));
+  graph_lib::DiskGraph::write(compact, directory, {.partition_vertices = std::max<size_t>(1, compact.vertexCount() / 16)});
+  auto disk = graph_lib::DiskGraph::open(directory, {.cache_bytes = state.range(1) == 0 ? size_t{1} : ~size_t{0}});
+
+  for (auto _ : state)
+  {
+    auto ranks = graph_lib::streamingPageRank(disk, {.max_iterations = 1});
+    benchmark::DoNotOptimize(ranks);
+  }
+  state.SetItemsProcessed(state.iterations() * compact.edgeCount());
+  state.counters["partition_loads"] = static_cast<double>(disk.partitionLoads()) / state.iterations();
+  std::filesystem::remove_all(directory);
+}
+
+BENCHMARK(BM_DiskPageRank)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges, 10), {0, 1}})
+  ->ArgNames({"edges", "cached"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief Split an R-MAT graph into 8 parts. The second argument is the PartitionMethod.
+//! Reports the fraction of edges cut next to the time.
+static void BM_PartitionGraph(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {1});
+  auto compact = graph_lib::CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+
+  graph_lib::GraphPartition partition;
+  for (auto _ : state)
+  {
+    partition = graph_lib::partitionGraph(compact, {.parts = 8, .method = static_cast<graph_lib::PartitionMethod>(state.range(1))});
+    benchmark::DoNotOptimize(partition);
+  }
+  state.SetItemsProcessed(state.iterations() * compact.edgeCount());
+  state.counters["cut_fraction"] = static_cast<double>(partition.edge_cut) / std::max<size_t>(1, compact.edgeCount());
+}
+
+BENCHMARK(BM_PartitionGraph)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges / 10, 10), {0, 1}})
+  ->ArgNames({"edges", "method"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief Bring PageRank up to date after a batch of 16 random edges is added to a graph.
+//! The second argument selects the incremental update (0) or recomputing from scratch (1).
+static void BM_IncrementalPageRank(benchmark::State& state)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  graph.enableJournal();
+  const auto ids = buildGraph(graph, state.range(0));
+  graph_lib::IncrementalPageRank<graph_lib::UnweightedDirectedGraph<int>> rank(graph, {.tolerance = 1e-6});
+
+  graph_lib::CounterRng rng(5);
+  uint64_t counter = 0;
+  size_t updated = 0;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    for (int i = 0; i < 16; i++, counter++) { graph.addEdge(ids[rng.below(counter, ids.size(), 0)], ids[rng.below(counter, ids.size(), 1)]); }
+    state.ResumeTiming();
+    if (state.range(1) == 0) { updated += rank.update().vertices_updated; }
+    else { rank.recompute(); updated += ids.size(); }
+    graph.discardJournalBefore(graph.journal().head());
+  }
+  state.SetItemsProcessed(state.iterations() * 16);
+  state.counters["vertices_per_batch"] = static_cast<double>(updated) / state.iterations();
+}
+
+BENCHMARK(BM_IncrementalPageRank)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges / 10, 10), {0, 1}})
+  ->ArgNames({"edges", "recompute"})
+  ->Unit(benchmark::kMillisecond);
+
+//! \brief One 40 step walk from every vertex of a weighted undirected R-MAT graph.
+//! The second argument selects DeepWalk on alias tables (0), node2vec with p = 0.5 and
+//! q = 2 (1), or a single threaded DeepWalk scanning the adjacency set of each vertex (2).
+static void BM_RandomWalks(benchmark::State& state)
+{
+  const unsigned scale = std::max(1, static_cast<int>(std::log2(vertexCount(state.range(0)))));
+  auto list = graph_lib::rmatEdges(scale, state.range(0), {}, {.seed = 1, .weights = graph_lib::WeightDistribution::uniform(1.0f, 10.0f)});
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list);
+  graph_lib::RandomWalker walker(graph_lib::CompactGraph::fromGraph(graph));
+
+  const graph_lib::RandomWalkOptions options{
+    .walk_length = 40, .walks_per_vertex = 1,
+    .return_param = state.range(1) == 1 ? 0.5 : 1.0, .in_out_param = state.range(1) == 1 ? 2.0 : 1.0};
+  size_t steps = 0;
+  for (auto _ : state)
+  {
+    if (state.range(1) < 2)
+    {
+      steps += walker.walk(options, [](std::span<const unsigned int> walk, unsigned) { benchmark::DoNotOptimize(walk.back()); });
+      continue;
+    }
+
+    graph_lib::CounterRng rng(0);
+    uint64_t counter = 0;
+    for (const auto& start : graph.vertices())
+    {
+      const graph_lib::Vertex<int>* current = &*start;
+      steps++;
+      for (unsigned step = 1; step < options.walk_length && !current->adj.empty(); step++, steps++)
+      {
+        float total = 0;
+        for (const auto& edge : current->adj) { total += (*edge).weight; }
+        float target = static_cast<float>(rng.uniform(counter++)) * total;
+        const graph_lib::Vertex<int>* next = nullptr;
+        for (const auto& edge : current->adj)
+        {
+          next = &*(*edge).vertex;
+          if ((target -= (*edge).weight) < 0) { break; }
+        }
+        current = next;
+      }
+      benchmark::DoNotOptimize(current);
+    }
+  }
+  state.SetItemsProcessed(steps);
+}
+
+BENCHMARK(BM_RandomWalks)
+  ->ArgsProduct({benchmark::CreateRange(kMinEdges, kMaxEdges / 10, 10), {0, 1, 2}})
+  ->ArgNames({"edges", "method"})
+  ->Unit(benchmark::kMillisecond);
+
+#define GRAPH_LIB_BENCH(func, G, ...) \
+  BENCHMARK_TEMPLATE(func, G)->RangeMultiplier(10)->Range(kMinEdges, kMaxEdges)->Unit(benchmark::kMillisecond) __VA_ARGS__
+
+#define GRAPH_LIB_BENCH_ALL(func, ...)                                            \
+  GRAPH_LIB_BENCH(func, graph_lib::UnweightedDirectedGraph<int>, __VA_ARGS__);    \
+  GRAPH_LIB_BENCH(func, graph_lib::WeightedDirectedGraph<int>, __VA_ARGS__);      \
+  GRAPH_LIB_BENCH(func, graph_lib::UnweightedUndirectedGraph<int>, __VA_ARGS__);  \
+  GRAPH_LIB_BENCH(func, graph_lib::WeightedUndirectedGraph<int>, __VA_ARGS__)
+
+GRAPH_LIB_BENCH_ALL(BM_AddVertex);
+GRAPH_LIB_BENCH_ALL(BM_AddEdge);
+GRAPH_LIB_BENCH(BM_AddEdgeIncoming, graph_lib::UnweightedDirectedGraph<int>);
+GRAPH_LIB_BENCH(BM_AddEdgeIncoming, graph_lib::WeightedDirectedGraph<int>);
+GRAPH_LIB_BENCH_ALL(BM_GetVertex);
+GRAPH_LIB_BENCH_ALL(BM_Iterate);
+GRAPH_LIB_BENCH_ALL(BM_DFS);
+GRAPH_LIB_BENCH_ALL(BM_BFS);
+GRAPH_LIB_BENCH_ALL(BM_MemoryPerEdge, ->Iterations(1));
+
+BENCHMARK_MAIN();
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/parallel.hpp>
+
+
+namespace graph_lib
+{
+//! \brief The algorithm used to compute all-pairs shortest paths.
+enum class ApspMethod
+{
+  //! \brief Pick from the density of the graph.
+  Automatic,
+  //! \brief Cache-blocked Floyd–Warshall, O(n³) regardless of the edge count.
+  FloydWarshall,
+  //! \brief Dijkstra from every vertex, reweighted Johnson style when a weight is negative.
+  Johnson
+};
+
+struct ApspOptions
+{
+  //! \brief The number of worker threads, 0 selects the hardware concurrency.
+  unsigned threads = 0;
+  ApspMethod method = ApspMethod::Automatic;
+  //! \brief The side of the square tiles of Floyd–Warshall, in vertices.
+  size_t block_size = 64;
+};
+
+//! \brief Shortest path distances between every pair of vertices of a graph.
+//! Distances are stored in a flat row-major n by n array, indexed by the
+//! internal IDs of the CompactGraph the matrix was computed from. Unreachable
+//! pairs hold infinity.
+class DistanceMatrix
+{
+public:
+  DistanceMatrix() = default;
+
+  //! \brief The number of vertices, which is the number of rows and of columns.
+  size_t size() const noexcept { return ids_.size(); }
+
+  //! \brief The distance between two internal IDs.
+  float at(size_t from, size_t to) const noexcept { return distances_[from * size() + to]; }
+
+  //! \brief The distances from one internal ID to every vertex.
+  std::span<const float> row(size_t from) const noexcept { return {distances_.data() + from * size(), size()}; }
+
+  //! \brief The whole matrix, row-major.
+  const std::vector<float>& data() const noexcept { return distances_; }
+
+  //! \brief The external ID of every row and column.
+  const std::vector<unsigned int>& externalIds() const noexcept { return ids_; }
+
+  //! \brief The distance between two vertices, given by external ID.
+  //!
+  //! \param [in] from_id The external ID of the origin.
+  //! \param [in] to_id The external ID of the destination.
+  //! \return std::optional<float> The distance, or no value if either vertex does not exist.
+  std::optional<float> distance(unsigned int from_id, unsigned int to_id) const noexcept
+  {
+    auto from = std::lower_bound(order_.begin(), order_.end(), std::make_pair(from_id, size_t{0}));
+    auto to = std::lower_bound(order_.begin(), order_.end(), std::make_pair(to_id, size_t{0}));
+    if (from == order_.end() || from->first != from_id || to == order_.end() || to->first != to_id) { return std::nullopt; }
+    return at(from->second, to->second);
+  }
+
+private:
+  std::vector<unsigned int> ids_;
+  //! \brief (external ID, internal ID) pairs sorted by external ID.
+  std::vector<std::pair<unsigned int, size_t>> order_;
+  std::vector<float> distances_;
+
+  DistanceMatrix(const CompactGraph& graph, std::vector<float> distances):
+    ids_(graph.externalIds()), distances_(std::move(distances))
+  {
+    order_.reserve(ids_.size());
+    for (size_t i = 0; i < ids_.size(); i++) { order_.emplace_back(ids_[i], i); }
+    std::sort(order_.begin(), order_.end());
+  }
+
+  friend std::optional<DistanceMatrix> allPairsShortestPaths(const CompactGraph&, const ApspOptions&);
+};
+
+
+namespace detail
+{
+//! \brief Relax tile C through pivot tiles A (rows of C) and B (columns of C): C[i][j] = min(C[i][j], A[i][k] + B[k][j]).
+//! All three tiles are block by block with a row stride of stride floats. The
+//! innermost loop runs over contiguous floats with no branches so it vectorizes.
+inline void minPlusTile(float* c, const float* a, const float* b, size_t block, size_t stride) noexcept
+{
+  for (size_t k = 0; k < block; k++)
+  {
+    const float* b_row = b + k * stride;
+    for (size_t i = 0; i < block; i++)
+    {
+      const float a_ik = a[i * stride + k];
+      float* c_row = c + i * stride;
+      for (size_t j = 0; j < block; j++) { c_row[j] = std::min(c_row[j], a_ik + b_row[j]); }
+    }
+  }
+}
+
+//! \brief Floyd–Warshall in three phases per pivot block.
+//! The diagonal tile is closed first, then the tiles sharing its row or column,
+//! then every other tile. Tiles within a phase are independent and run in parallel.
+inline void blockedFloydWarshall(std::vector<float>& d, size_t stride, size_t block, unsigned threads)
+{
+  const size_t blocks = stride / block;
+  auto tile = [&](size_t bi, size_t bj) { return d.data() + bi * block * stride + bj * block; };
+
+  for (size_t k = 0; k < blocks; k++)
+  {
+    float* pivot = tile(k, k);
+    minPlusTile(pivot, pivot, pivot, block, stride);
+
+    parallelFor(0, 2 * blocks, threads, [&](size_t t)
+    {
+      const size_t other = t / 2;
+      if (other == k) { return; }
+      if (t % 2 == 0) { minPlusTile(tile(k, other), pivot, tile(k, other), block, stride); }
+      else { minPlusTile(tile(other, k), tile(other, k), pivot, block, stride); }
+    });
+
+    parallelFor(0, blocks * blocks, threads, [&](size_t t)
+    {
+      const size_t bi = t / blocks, bj = t % blocks;
+      if (bi == k || bj == k) { return; }
+      minPlusTile(tile(bi, bj), tile(bi, k), tile(k, bj), block, stride);
+    });
+  }
+}
+
+//! \brief Bellman–Ford from a virtual source joined to every vertex by a zero-weight edge.
+//! \return std::optional<std::vector<float>> The vertex potentials, or no value on a negative cycle.
+inline std::optional<std::vector<float>> johnsonPotentials(const CompactGraph& graph)
+{
+  using Index = CompactGraph::Index;
+  const size_t n = graph.vertexCount();
+  std::vector<float> potential(n, 0);
+  std::vector<size_t> relaxations(n, 0);
+  std::vector<bool> queued(n, true);
+  std::deque<Index> queue;
+  for (Index v = 0; v < n; v++) { queue.push_back(v); }
+
+  while (!queue.empty())
+  {
+    const Index v = queue.front();
+    queue.pop_front();
+    queued[v] = false;
+    const auto row = graph.neighbors(v);
+    for (size_t i = 0; i < row.size(); i++)
+    {
+      const Index u = row[i];
+      const float candidate = potential[v] + graph.weight(v, i);
+      if (candidate >= potential[u]) { continue; }
+      potential[u] = candidate;
+      // A shortest path has at most n edges counting the virtual one
+      if (++relaxations[u] > n) { return std::nullopt; }
+      if (!queued[u]) { queued[u] = true; queue.push_back(u); }
+    }
+  }
+  return potential;
+}
+
+inline void dijkstraRows(const CompactGraph& graph, const std::vector<float>& potential, std::vector<float>& d, unsigned threads)
+{
+  using Index = CompactGraph::Index;
+  using HeapEntry = std::pair<float, Index>;
+  const size_t n = graph.vertexCount();
+  const bool reweighted = !potential.empty();
+  std::vector<std::vector<HeapEntry>> heaps(threads);
+
+  parallelForDynamic(0, n, threads, [&](size_t source, unsigned thread)
+  {
+    float* distance = d.data() + source * n;
+    auto& heap = heaps[thread];
+    distance[source] = 0;
+    heap.assign(1, {0.0f, static_cast<Index>(source)});
+    while (!heap.empty())
+    {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+      const auto [dv, v] = heap.back();
+      heap.pop_back();
+      if (dv > distance[v]) { continue; }
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+
+      const auto row = graph.neighbors(v);
+      GRAPH_LIB_COUNT(EdgesScanned, row.size());
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        const Index u = row[i];
+        float w = graph.weight(v, i);
+        if (reweighted) { w += potential[v] - potential[u]; }
+        // Rounding can leave a reweighted edge slightly negative
+        const float candidate = dv + std::max(w, 0.0f);
+        if (candidate >= distance[u]) { continue; }
+        distance[u] = candidate;
+        heap.emplace_back(candidate, u);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+      }
+    }
+    if (!reweighted) { return; }
+    for (size_t v = 0; v < n; v++) { distance[v] += potential[v] - potential[source]; }
+  });
+}
+} // namespace detail
+
+
+//! \brief Shortest path distances between every pair of vertices.
+//! Dense graphs run a cache-blocked Floyd–Warshall; sparse graphs run Dijkstra
+//! from every vertex, which costs O(n·m·log n) instead of O(n³). Automatic picks
+//! Dijkstra when m·log2(n) is below n²/4. Negative weights are supported by
+//! both methods, through Johnson's reweighting for Dijkstra.
+//!
+//! \param [in] graph The graph, as a CSR snapshot. Unweighted graphs count one per edge.
+//! \param [in] options Thread count, method and tile size.
+//! \return std::optional<DistanceMatrix> The distances, or no value if the graph has a negative cycle.
+inline std::optional<DistanceMatrix> allPairsShortestPaths(const CompactGraph& graph, const ApspOptions& options = {})
+{
+  using Index = CompactGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("all_pairs_shortest_paths");
+  const size_t n = graph.vertexCount();
+  const unsigned threads = resolveThreads(options.threads);
+  constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+  ApspMethod method = options.method;
+  if (method == ApspMethod::Automatic)
+  {
+    const double sparse_cost = static_cast<double>(graph.edgeCount()) * std::log2(std::max<size_t>(n, 2));
+    method = sparse_cost < static_cast<double>(n) * n / 4 ? ApspMethod::Johnson : ApspMethod::FloydWarshall;
+  }
+
+  if (method == ApspMethod::Johnson)
+  {
+    bool negative = false;
+    for (Index v = 0; v < n && graph.isWeighted() && !negative; v++)
+    {
+      const auto weights = graph.weights(v);
+      negative = std::any_of(weights.begin(), weights.end(), [](float w) { return w < 0; });
+    }
+
+    std::vector<float> potential;
+    if (negative)
+    {
+      auto solved = detail::johnsonPotentials(graph);
+      if (!solved.has_value()) { return std::nullopt; }
+      potential = std::move(*solved);
+    }
+    std::vector<float> d(n * n, kInfinity);
+    detail::dijkstraRows(graph, potential, d, threads);
+    return DistanceMatrix(graph, std::move(d));
+  }
+
+  // Pad to whole tiles so the kernel has no edge cases. Padding vertices have no edges.
+  const size_t block = std::max<size_t>(options.block_size, 1);
+  const size_t stride = (n + block - 1) / block * block;
+  std::vector<float> d(stride * stride, kInfinity);
+  for (size_t v = 0; v < stride; v++) { d[v * stride + v] = 0; }
+  for (Index v = 0; v < n; v++)
+  {
+    const auto row = graph.neighbors(v);
+    for (size_t i = 0; i < row.size(); i++)
+    {
+      float& entry = d[v * stride + row[i]];
+      entry = std::min(entry, graph.weight(v, i));
+    }
+  }
+
+  detail::blockedFloydWarshall(d, stride, block, threads);
+  for (size_t v = 0; v < n; v++)
+  {
+    if (d[v * stride + v] < 0) { return std::nullopt; }
+  }
+
+  // Drop the padding, moving each row down in place
+  if (stride != n)
+  {
+    for (size_t v = 0; v < n; v++) { std::memmove(d.data() + v * n, d.data() + v * stride, n * sizeof(float)); }
+    d.resize(n * n);
+    d.shrink_to_fit();
+  }
+  return DistanceMatrix(graph, std::move(d));
+}
+
+//! \brief Shortest path distances between every pair of vertices of a graph or graph view.
+//! Rows and columns follow the internal IDs of CompactGraph::fromGraph(graph).
+template <typename G> requires TraversableGraph<G>
+std::optional<DistanceMatrix> allPairsShortestPaths(const G& graph, const ApspOptions& options = {})
+{
+  return allPairsShortestPaths(CompactGraph::fromGraph(graph), options);
+}
+
+} // namespace graph_lib
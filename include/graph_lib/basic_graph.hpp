@@ -0,0 +1,323 @@
+#pragma once
+
+#include <concepts>
+#include <deque>
+#include <memory>
+#include <new>
+#include <optional>
+#include <vector>
+
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/graph.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/memory.hpp>
+#include <graph_lib/ranges.hpp>
+#include <graph_lib/vertex.hpp>
+
+
+namespace graph_lib
+{
+//! \brief Directedness policy: an edge joins its origin to its destination only.
+struct Directed
+{
+  static constexpr bool is_directed = true;
+};
+
+//! \brief Directedness policy: an edge joins both of its ends to each other.
+struct Undirected
+{
+  static constexpr bool is_directed = false;
+};
+
+//! \brief Edge property policy: edges carry no weight and addEdge takes none. Weights read as 0.
+struct Unweighted
+{
+  static constexpr bool is_weighted = false;
+};
+
+//! \brief Edge property policy: every edge carries a float weight given to addEdge.
+struct Weighted
+{
+  static constexpr bool is_weighted = true;
+};
+
+//! \brief Storage policy: each vertex keeps its out edges in a hash set keyed by destination.
+//! A storage policy provides contains(origin, dest), insert(origin, dest, weight) and
+//! erase(origin, dest), the only adjacency operations BasicGraph makes when adding edges.
+//! insert returns false and changes nothing when it cannot allocate; erase undoes an
+//! insert when the rest of an edge insert fails.
+struct HashAdjacency
+{
+  template <typename T>
+  static bool contains(const Vertex<T>& origin, const std::shared_ptr<Vertex<T>>& dest) noexcept
+  {
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    return origin.adj.contains(dest);
+  }
+
+  template <typename T>
+  static bool insert(Vertex<T>& origin, const std::shared_ptr<Vertex<T>>& dest, float weight) noexcept
+  {
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    GRAPH_LIB_COUNT(Allocations, 1);
+    GRAPH_LIB_COUNT(BytesAllocated, sizeof(Edge<T>));
+    try { return origin.adj.insert(std::make_unique<Edge<T>>(dest, weight)).second; }
+    catch (const std::bad_alloc&) { return false; }
+  }
+
+  template <typename T>
+  static void erase(Vertex<T>& origin, const std::shared_ptr<Vertex<T>>& dest) noexcept
+  {
+    auto edge = origin.adj.find(dest);
+    if (edge != origin.adj.end()) { origin.adj.erase(edge); }
+  }
+};
+
+//! \brief Graph whose direction, edge weights and adjacency storage are chosen at compile time.
+//! Nothing is dispatched at run time, so edge insertion and neighbor loops inline
+//! into the caller. The four graph classes are aliases of this template.
+//!
+//! \tparam T The type stored in the vertices.
+//! \tparam Directedness Directed or Undirected.
+//! \tparam EdgeProperty Unweighted or Weighted.
+//! \tparam Storage The adjacency storage policy.
+template <typename T, typename Directedness, typename EdgeProperty, typename Storage = HashAdjacency> requires Graphable<T>
+class BasicGraph : public Graph<T>
+{
+public:
+  static constexpr bool is_directed = Directedness::is_directed;
+  static constexpr bool is_weighted = EdgeProperty::is_weighted;
+
+  //! \brief Add an edge to the graph.
+  //!
+  //! \param [in] origin_id The ID of the origin vertex.
+  //! \param [in] dest_id The ID of the destination vertex.
+  //! \return true If the edge is successfully added.
+  //! \return false If the edge is not successfully added.
+  bool addEdge(const unsigned int& origin_id, const unsigned int& dest_id) noexcept requires (!is_weighted)
+  {
+    return insertEdge(origin_id, dest_id, 0);
+  }
+
+  //! \brief Add an edge to the graph.
+  //!
+  //! \param [in] origin_id The ID of the origin vertex.
+  //! \param [in] dest_id The ID of the destination vertex.
+  //! \param [in] weight The weight of the edge between the vertices.
+  //! \return true If the edge is successfully added.
+  //! \return false If the edge is not successfully added.
+  bool addEdge(const unsigned int& origin_id, const unsigned int& dest_id, float weight) noexcept requires is_weighted
+  {
+    return insertEdge(origin_id, dest_id, weight);
+  }
+
+  //! \brief Start keeping the origins of the edges into every vertex.
+  //! The index is built from the current edges and maintained by addEdge afterwards.
+  //! Entries are appended to a pool allocated in large blocks and linked from
+  //! their destination, so maintaining the index costs no per-vertex allocation.
+  //! Does nothing if the index is already kept.
+  //! \exception std::bad_alloc Thrown when the index cannot be built. The index is not kept then.
+  void enableIncomingIndex() requires is_directed
+  {
+    if (incoming_->index.has_value()) { return; }
+    incoming_->index.emplace(this->memory_);
+    try
+    {
+      for (const auto& vertex : this->vertices_)
+      {
+        for (const auto& edge : (*vertex).adj) { linkIncoming(*(*edge).vertex, reserveIncoming(vertex, (*edge).vertex, (*edge).weight)); }
+      }
+    }
+    catch (...)
+    {
+      disableIncomingIndex();
+      throw;
+    }
+  }
+
+  //! \brief Stop keeping the incoming index and release it.
+  //! Copies of the graph share the index with their vertices, so it stops for them as well.
+  void disableIncomingIndex() noexcept requires is_directed
+  {
+    if (!incoming_->index.has_value()) { return; }
+    for (const auto& head : incoming_->index->heads)
+    {
+      if (auto vertex = head.lock())
+      {
+        (*vertex).incoming = nullptr;
+        (*vertex).in_degree = 0;
+      }
+    }
+    incoming_->index.reset();
+  }
+
+  //! \brief Whether the graph keeps the incoming index.
+  bool hasIncomingIndex() const noexcept requires is_directed { return incoming_->index.has_value(); }
+
+  //! \brief Get the number of edges into a vertex, from the incoming index.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return std::optional<size_t> The in degree, or no value if the vertex is not in the graph or the index is not kept.
+  std::optional<size_t> inDegree(const unsigned int& id) const noexcept requires is_directed
+  {
+    auto vertex = this->getVertex(id);
+    if (!incoming_->index.has_value() || !vertex.has_value()) { return {}; }
+    return (**vertex).in_degree;
+  }
+
+  //! \brief Get a view of the vertices with an edge to a vertex, from the incoming index.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return PredecessorView<T> The origins of the incoming edges, most recent first. Empty if the
+  //!                             vertex is not in the graph or the index is not kept.
+  PredecessorView<T> predecessors(const unsigned int& id) const noexcept requires is_directed
+  {
+    auto vertex = this->getVertex(id);
+    return PredecessorView<T>(incoming_->index.has_value() && vertex.has_value() ? (**vertex).incoming : nullptr);
+  }
+
+  //! \brief Call a function for every edge into a vertex, from the incoming index.
+  //! Unweighted edges report a weight of 0. Does nothing if the index is not kept.
+  //!
+  //! \param [in] vertex The vertex whose incoming edges are visited.
+  //! \param [in] fn Callable invoked as fn(const Vertex<T>& origin, float weight).
+  template <typename F>
+  void forEachPredecessor(const Vertex<T>& vertex, F&& fn) const requires is_directed
+  {
+    if (!incoming_->index.has_value()) { return; }
+    for (auto* entry = vertex.incoming; entry != nullptr; entry = entry->next) { fn(*entry->vertex, entry->weight); }
+  }
+
+private:
+  using IncomingPool = std::deque<IncomingEdge<T>, TrackingAllocator<IncomingEdge<T>>>;
+
+  using HeadList = std::vector<std::weak_ptr<Vertex<T>>, TrackingAllocator<std::weak_ptr<Vertex<T>>>>;
+
+  struct IncomingIndex
+  {
+    explicit IncomingIndex(const std::shared_ptr<MemoryAccount>& memory):
+      pool(typename IncomingPool::allocator_type(memory, MemoryCategory::AuxiliaryIndexes)),
+      heads(typename HeadList::allocator_type(memory, MemoryCategory::AuxiliaryIndexes))
+    {}
+
+    //! \brief The entries, linked from their destination. A deque never moves its elements.
+    IncomingPool pool;
+    //! \brief The vertices whose head points into pool, reset when the index is dropped.
+    //! Includes vertices held only by other copies of the graph.
+    HeadList heads;
+  };
+
+  //! \brief The incoming index while it is kept.
+  struct IncomingState
+  {
+    std::optional<IncomingIndex> index;
+  };
+
+  bool insertEdge(const unsigned int& origin_id, const unsigned int& dest_id, float weight) noexcept
+  {
+    // Get references to the specified vertices
+    auto origin_vertex = this->getVertex(origin_id);
+    auto dest_vertex = this->getVertex(dest_id);
+
+    // If either of the vertices don't exist, return false
+    if (!origin_vertex.has_value() || !dest_vertex.has_value()) { return false; }
+
+    // If the edge already exists return false
+    if (Storage::contains(**origin_vertex, *dest_vertex)) { return false; }
+    if constexpr (!is_directed)
+    {
+      if (Storage::contains(**dest_vertex, *origin_vertex)) { return false; }
+    }
+
+    // Make room in the journal first, so recording the edge cannot fail once it is added
+    try { this->journal_.reserveNext(); }
+    catch (const std::bad_alloc&) { return false; }
+
+    // Allocate the incoming index entry too, and link it only once the edge is added
+    IncomingEdge<T>* incoming = nullptr;
+    if constexpr (is_directed)
+    {
+      try { incoming = reserveIncoming(*origin_vertex, *dest_vertex, weight); }
+      catch (const std::bad_alloc&) { return false; }
+    }
+
+    // Add dest to the adjacency list of origin
+    if (!Storage::insert(**origin_vertex, *dest_vertex, weight))
+    {
+      dropIncoming(**dest_vertex, incoming);
+      return false;
+    }
+
+    // Only add origin to the adjacency list of dest if origin and dest are different
+    // Don't add the edge twice if loopback edge
+    if constexpr (!is_directed)
+    {
+      if (origin_id != dest_id && !Storage::insert(**dest_vertex, *origin_vertex, weight))
+      {
+        Storage::erase(**origin_vertex, *dest_vertex);
+        return false;
+      }
+    }
+
+    if constexpr (is_directed) { linkIncoming(**dest_vertex, incoming); }
+    this->journal_.recordEdge(origin_id, dest_id, weight);
+    return true;
+  }
+
+  //! \brief Allocate the incoming index entry of a new edge, without linking it.
+  //! The entry is linked by linkIncoming once the edge is added, or released by dropIncoming.
+  //! \return IncomingEdge<T>* The entry, or nullptr if the index is not kept.
+  //! \exception std::bad_alloc Thrown when the entry cannot be allocated. Nothing is changed then.
+  IncomingEdge<T>* reserveIncoming(const std::shared_ptr<Vertex<T>>& origin, const std::shared_ptr<Vertex<T>>& dest, float weight)
+  {
+    if (!incoming_->index.has_value()) { return nullptr; }
+    auto& index = *incoming_->index;
+    const bool first = (*dest).incoming == nullptr;
+    if (first) { index.heads.push_back(dest); }
+    try { return &index.pool.emplace_back(IncomingEdge<T>{origin, weight, nullptr}); }
+    catch (...)
+    {
+      if (first) { index.heads.pop_back(); }
+      throw;
+    }
+  }
+
+  //! \brief Put a reserved entry at the head of the incoming list of its destination.
+  void linkIncoming(Vertex<T>& dest, IncomingEdge<T>* entry) noexcept
+  {
+    if (entry == nullptr) { return; }
+    entry->next = dest.incoming;
+    dest.incoming = entry;
+    dest.in_degree++;
+  }
+
+  //! \brief Release the last reserved entry when its edge could not be added.
+  void dropIncoming(const Vertex<T>& dest, IncomingEdge<T>* entry) noexcept
+  {
+    if (entry == nullptr) { return; }
+    auto& index = *incoming_->index;
+    index.pool.pop_back();
+    if (dest.incoming == nullptr) { index.heads.pop_back(); }
+  }
+
+  //! \brief The incoming index. Shared with copies of the graph, like the vertices linking into it,
+  //! so every copy sees the index kept or dropped together with the heads on its vertices.
+  std::shared_ptr<IncomingState> incoming_ = std::make_shared<IncomingState>();
+};
+
+//! \brief A graph whose edges carry no weight, added with addEdge(origin_id, dest_id).
+//! Replaces the UnweightedGraph<T> base class of the former class hierarchy: code that took
+//! an UnweightedGraph<T>& takes a G constrained by this concept instead.
+template <typename G>
+concept UnweightedGraph = std::derived_from<G, Graph<typename G::ValueType>> && requires(G& g, const unsigned int& id) {
+  { g.addEdge(id, id) } -> std::same_as<bool>;
+};
+
+//! \brief A graph whose edges carry a weight, added with addEdge(origin_id, dest_id, weight).
+//! Replaces the WeightedGraph<T> base class of the former class hierarchy.
+template <typename G>
+concept WeightedGraph = std::derived_from<G, Graph<typename G::ValueType>> && requires(G& g, const unsigned int& id, float weight) {
+  { g.addEdge(id, id, weight) } -> std::same_as<bool>;
+};
+
+} // namespace graph_lib
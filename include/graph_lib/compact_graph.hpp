@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <graph_lib/concepts.hpp>
+
+
+namespace graph_lib
+{
+//! \brief Read-only compressed sparse row (CSR) snapshot of a graph.
+//! Vertices are stored under dense internal indices in [0, vertexCount()). The
+//! external vertex IDs returned by addVertex stay valid through externalId() and
+//! internalId(), including after the storage is relabeled by a reordering pass.
+//! Undirected graphs store every edge in both directions.
+class CompactGraph
+{
+public:
+  using Index = uint32_t;
+
+  CompactGraph() = default;
+
+  //! \brief Build a snapshot of a graph.
+  //! Internal indices follow the order of the external IDs and each neighbor list is sorted.
+  //!
+  //! \param [in] graph The graph, or graph view, to copy.
+  //! \return CompactGraph The snapshot.
+  template <typename G> requires TraversableGraph<G>
+  static CompactGraph fromGraph(const G& graph)
+  {
+    CompactGraph result;
+    result.directed_ = G::is_directed;
+    result.weighted_ = G::is_weighted;
+
+    std::vector<typename G::VertexPtr> vertices;
+    vertices.reserve(graph.getSize());
+    graph.forEachVertex([&](const auto& vertex) { vertices.push_back(vertex); });
+    std::sort(vertices.begin(), vertices.end(), [](const auto& a, const auto& b) { return (*a).getID() < (*b).getID(); });
+    for (const auto& vertex : vertices) { result.ids_.push_back((*vertex).getID()); }
+    result.buildIndex();
+
+    std::vector<std::pair<Index, float>> row;
+    result.offsets_.assign(result.ids_.size() + 1, 0);
+    for (Index v = 0; v < result.ids_.size(); v++)
+    {
+      row.clear();
+      const auto& vertex = vertices[v];
+      graph.forEachNeighbor(*vertex, [&](const auto& dest, float weight)
+      {
+        auto index = result.internalId((*dest).getID());
+        if (index.has_value()) { row.emplace_back(*index, weight); }
+      });
+      std::sort(row.begin(), row.end());
+
+      for (auto [dest, weight] : row)
+      {
+        result.targets_.push_back(dest);
+        if (result.weighted_) { result.weights_.push_back(weight); }
+      }
+      result.offsets_[v + 1] = result.targets_.size();
+    }
+    return result;
+  }
+
+  //! \brief Build a snapshot from an edge list over dense indices.
+  //! For undirected graphs each edge is stored in both directions.
+  //!
+  //! \param [in] ids The external ID of each internal index.
+  //! \param [in] edges Tuples of (origin index, dest index, weight).
+  //! \param [in] directed Whether the edges are directed.
+  //! \param [in] weighted Whether the weights are kept.
+  //! \return CompactGraph The snapshot.
+  template <typename Edges>
+  static CompactGraph fromEdges(std::vector<unsigned int> ids, const Edges& edges, bool directed, bool weighted)
+  {
+    CompactGraph result;
+    result.directed_ = directed;
+    result.weighted_ = weighted;
+    result.ids_ = std::move(ids);
+    result.buildIndex();
+
+    const size_t n = result.ids_.size();
+    result.offsets_.assign(n + 1, 0);
+    for (const auto& [origin, dest, weight] : edges)
+    {
+      result.offsets_[origin + 1]++;
+      if (!directed && origin != dest) { result.offsets_[dest + 1]++; }
+    }
+    std::partial_sum(result.offsets_.begin(), result.offsets_.end(), result.offsets_.begin());
+
+    std::vector<size_t> next(result.offsets_.begin(), result.offsets_.end() - 1);
+    result.targets_.resize(result.offsets_[n]);
+    if (weighted) { result.weights_.resize(result.offsets_[n]); }
+    auto place = [&](size_t origin, size_t dest, float weight)
+    {
+      const size_t slot = next[origin]++;
+      result.targets_[slot] = static_cast<Index>(dest);
+      if (weighted) { result.weights_[slot] = weight; }
+    };
+    for (const auto& [origin, dest, weight] : edges)
+    {
+      place(origin, dest, weight);
+      if (!directed && origin != dest) { place(dest, origin, weight); }
+    }
+    result.sortRows();
+    return result;
+  }
+
+  size_t vertexCount() const noexcept { return ids_.size(); }
+
+  //! \brief The number of stored edges. Undirected edges are counted once per direction.
+  size_t edgeCount() const noexcept { return targets_.size(); }
+
+  bool isDirected() const noexcept { return directed_; }
+  bool isWeighted() const noexcept { return weighted_; }
+
+  size_t degree(Index v) const noexcept { return offsets_[v + 1] - offsets_[v]; }
+
+  //! \brief The internal indices of the vertices adjacent to v, in ascending order.
+  std::span<const Index> neighbors(Index v) const noexcept
+  {
+    return {targets_.data() + offsets_[v], degree(v)};
+  }
+
+  //! \brief The weights of the edges leaving v, parallel to neighbors(v). Empty when unweighted.
+  std::span<const float> weights(Index v) const noexcept
+  {
+    if (!weighted_) { return {}; }
+    return {weights_.data() + offsets_[v], degree(v)};
+  }
+
+  //! \brief The weight of the i-th edge leaving v, 1 when unweighted.
+  float weight(Index v, size_t i) const noexcept { return weighted_ ? weights_[offsets_[v] + i] : 1.0f; }
+
+  //! \brief The external vertex ID of an internal index.
+  unsigned int externalId(Index v) const noexcept { return ids_[v]; }
+
+  //! \brief The internal index of an external vertex ID.
+  std::optional<Index> internalId(unsigned int id) const noexcept
+  {
+    auto itr = index_.find(id);
+    if (itr == index_.end()) { return {}; }
+    return itr->second;
+  }
+
+  const std::vector<size_t>& offsets() const noexcept { return offsets_; }
+  const std::vector<Index>& targets() const noexcept { return targets_; }
+  const std::vector<unsigned int>& externalIds() const noexcept { return ids_; }
+
+  //! \brief Get the graph with every edge reversed. Undirected graphs are returned unchanged.
+  CompactGraph transpose() const
+  {
+    if (!directed_) { return *this; }
+
+    CompactGraph result;
+    result.directed_ = true;
+    result.weighted_ = weighted_;
+    result.ids_ = ids_;
+    result.index_ = index_;
+
+    const size_t n = ids_.size();
+    result.offsets_.assign(n + 1, 0);
+    for (Index dest : targets_) { result.offsets_[dest + 1]++; }
+    std::partial_sum(result.offsets_.begin(), result.offsets_.end(), result.offsets_.begin());
+
+    std::vector<size_t> next(result.offsets_.begin(), result.offsets_.end() - 1);
+    result.targets_.resize(targets_.size());
+    if (weighted_) { result.weights_.resize(weights_.size()); }
+    for (Index v = 0; v < n; v++)
+    {
+      for (size_t e = offsets_[v]; e < offsets_[v + 1]; e++)
+      {
+        const size_t slot = next[targets_[e]]++;
+        result.targets_[slot] = v;
+        if (weighted_) { result.weights_[slot] = weights_[e]; }
+      }
+    }
+    return result;
+  }
+
+  //! \brief Relabel the storage with a permutation.
+  //! Vertex v moves to internal index permutation[v]. External IDs are unchanged.
+  //!
+  //! \param [in] permutation A bijection on [0, vertexCount()).
+  //! \exception std::invalid_argument Thrown when permutation is not a bijection.
+  void relabel(std::span<const Index> permutation)
+  {
+    const size_t n = ids_.size();
+    if (permutation.size() != n) { throw std::invalid_argument("Permutation size does not match the graph"); }
+    std::vector<bool> seen(n, false);
+    for (Index p : permutation)
+    {
+      if (p >= n || seen[p]) { throw std::invalid_argument("Permutation is not a bijection"); }
+      seen[p] = true;
+    }
+
+    std::vector<unsigned int> ids(n);
+    std::vector<size_t> offsets(n + 1, 0);
+    for (Index v = 0; v < n; v++)
+    {
+      ids[permutation[v]] = ids_[v];
+      offsets[permutation[v] + 1] = degree(v);
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<Index> targets(targets_.size());
+    std::vector<float> weights(weights_.size());
+    for (Index v = 0; v < n; v++)
+    {
+      size_t slot = offsets[permutation[v]];
+      for (size_t e = offsets_[v]; e < offsets_[v + 1]; e++, slot++)
+      {
+        targets[slot] = permutation[targets_[e]];
+        if (weighted_) { weights[slot] = weights_[e]; }
+      }
+    }
+
+    ids_ = std::move(ids);
+    offsets_ = std::move(offsets);
+    targets_ = std::move(targets);
+    weights_ = std::move(weights);
+    buildIndex();
+    sortRows();
+  }
+
+private:
+  std::vector<size_t> offsets_{0};
+  std::vector<Index> targets_;
+  std::vector<float> weights_;
+  std::vector<unsigned int> ids_;
+  std::unordered_map<unsigned int, Index> index_;
+  bool directed_ = true;
+  bool weighted_ = false;
+
+  void buildIndex()
+  {
+    index_.clear();
+    index_.reserve(ids_.size());
+    for (Index v = 0; v < ids_.size(); v++) { index_.emplace(ids_[v], v); }
+  }
+
+  void sortRows()
+  {
+    std::vector<std::pair<Index, float>> row;
+    for (Index v = 0; v < ids_.size(); v++)
+    {
+      const size_t first = offsets_[v], last = offsets_[v + 1];
+      if (!weighted_) { std::sort(targets_.begin() + first, targets_.begin() + last); continue; }
+
+      row.clear();
+      for (size_t e = first; e < last; e++) { row.emplace_back(targets_[e], weights_[e]); }
+      std::sort(row.begin(), row.end());
+      for (size_t e = first; e < last; e++) { std::tie(targets_[e], weights_[e]) = row[e - first]; }
+    }
+  }
+};
+
+} // namespace graph_lib
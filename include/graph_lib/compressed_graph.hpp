@@ -0,0 +1,369 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/parallel.hpp>
+
+
+namespace graph_lib
+{
+//! \brief How the gaps between sorted neighbors are stored.
+enum class AdjacencyEncoding
+{
+  //! \brief LEB128 varints: 7 bits per byte, the high bit marks a continuation.
+  Varint,
+  //! \brief Stream VByte: the byte lengths of each group of four gaps are packed
+  //! into one control byte stored ahead of the data bytes, so decoding has no
+  //! data-dependent branch per byte.
+  StreamVByte
+};
+
+struct CompressionOptions
+{
+  AdjacencyEncoding encoding = AdjacencyEncoding::StreamVByte;
+  //! \brief The number of worker threads used to encode, 0 selects the hardware concurrency.
+  unsigned threads = 0;
+};
+
+
+namespace detail
+{
+//! \brief Zigzag encode a difference of two indices, taken modulo 2^32 as a signed 32-bit value.
+//! Decoding wraps the same way, so v + unzigzag(zigzag(u - v)) == u for any two indices,
+//! however far apart, while small differences of either sign still get small codes.
+inline uint32_t zigzag(uint32_t difference) noexcept
+{
+  const int32_t value = static_cast<int32_t>(difference);
+  return (difference << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+inline uint32_t unzigzag(uint32_t value) noexcept { return (value >> 1) ^ (0u - (value & 1)); }
+
+inline size_t varintSize(uint32_t value) noexcept
+{
+  size_t size = 1;
+  while (value >= 0x80) { value >>= 7; size++; }
+  return size;
+}
+
+inline size_t streamVByteLength(uint32_t value) noexcept
+{
+  return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+} // namespace detail
+
+
+//! \brief Read-only graph whose neighbor lists are compressed.
+//! Each sorted neighbor list is stored as gaps: the first neighbor relative to
+//! the vertex itself (zigzag encoded modulo 2^32, since it may be smaller) and every other
+//! neighbor relative to the previous one. Gaps are then written as varints or in
+//! Stream VByte groups. Rows are decoded on the fly while they are scanned, so a
+//! traversal never materializes the whole adjacency. Weights, when present, are
+//! kept uncompressed next to the rows. Vertex IDs work as in CompactGraph.
+class CompressedGraph
+{
+public:
+  using Index = CompactGraph::Index;
+
+  CompressedGraph() = default;
+
+  //! \brief Compress a CSR snapshot.
+  //!
+  //! \param [in] graph The snapshot to compress.
+  //! \param [in] options The encoding and thread count.
+  //! \return CompressedGraph The compressed graph.
+  static CompressedGraph fromCompact(const CompactGraph& graph, const CompressionOptions& options = {})
+  {
+    GRAPH_LIB_SCOPED_TIMER("compress_graph");
+    CompressedGraph result;
+    const size_t n = graph.vertexCount();
+    const unsigned threads = resolveThreads(options.threads);
+    result.encoding_ = options.encoding;
+    result.directed_ = graph.isDirected();
+    result.weighted_ = graph.isWeighted();
+    result.edge_count_ = graph.edgeCount();
+    result.ids_ = graph.externalIds();
+    result.by_id_.resize(n);
+    std::iota(result.by_id_.begin(), result.by_id_.end(), Index{0});
+    std::sort(result.by_id_.begin(), result.by_id_.end(), [&](Index a, Index b) { return result.ids_[a] < result.ids_[b]; });
+
+    result.degrees_.resize(n);
+    result.offsets_.assign(n + 1, 0);
+    parallelFor(0, n, threads, [&](size_t v)
+    {
+      result.degrees_[v] = static_cast<uint32_t>(graph.degree(static_cast<Index>(v)));
+      result.offsets_[v + 1] = result.encodedSize(static_cast<Index>(v), graph.neighbors(static_cast<Index>(v)));
+    });
+    std::partial_sum(result.offsets_.begin(), result.offsets_.end(), result.offsets_.begin());
+
+    // Decoders may read a few bytes past the last row
+    result.data_.assign(result.offsets_[n] + kPadding, 0);
+    parallelFor(0, n, threads, [&](size_t v)
+    {
+      result.encode(static_cast<Index>(v), graph.neighbors(static_cast<Index>(v)), result.data_.data() + result.offsets_[v]);
+    });
+    if (result.weighted_) { result.copyWeights(graph); }
+    return result;
+  }
+
+  //! \brief Compress a graph or graph view.
+  template <typename G> requires TraversableGraph<G>
+  static CompressedGraph fromGraph(const G& graph, const CompressionOptions& options = {})
+  {
+    return fromCompact(CompactGraph::fromGraph(graph), options);
+  }
+
+  size_t vertexCount() const noexcept { return ids_.size(); }
+  size_t edgeCount() const noexcept { return edge_count_; }
+  bool isDirected() const noexcept { return directed_; }
+  bool isWeighted() const noexcept { return weighted_; }
+  AdjacencyEncoding encoding() const noexcept { return encoding_; }
+
+  size_t degree(Index v) const noexcept { return degrees_[v]; }
+
+  //! \brief Call a function for every neighbor of v, in ascending order, decoding the row as it goes.
+  //!
+  //! \param [in] v The internal index of the vertex.
+  //! \param [in] fn Callable invoked as fn(Index neighbor).
+  template <typename F>
+  void forEachNeighbor(Index v, F&& fn) const
+  {
+    const uint8_t* in = data_.data() + offsets_[v];
+    const size_t degree = degrees_[v];
+    Index previous = v;
+    if (encoding_ == AdjacencyEncoding::Varint)
+    {
+      for (size_t i = 0; i < degree; i++)
+      {
+        uint32_t gap = 0;
+        for (unsigned shift = 0; ; shift += 7)
+        {
+          const uint8_t byte = *in++;
+          gap |= static_cast<uint32_t>(byte & 0x7f) << shift;
+          if (byte < 0x80) { break; }
+        }
+        previous = i == 0 ? previous + detail::unzigzag(gap) : previous + gap;
+        fn(previous);
+      }
+      return;
+    }
+
+    const uint8_t* control = in;
+    const uint8_t* bytes = in + (degree + 3) / 4;
+    for (size_t i = 0; i < degree; i++)
+    {
+      const unsigned length = (control[i / 4] >> (2 * (i % 4)) & 3) + 1;
+      uint32_t gap = 0;
+      std::memcpy(&gap, bytes, sizeof(gap));
+      gap &= length == 4 ? 0xffffffffu : (1u << (8 * length)) - 1;
+      bytes += length;
+      previous = i == 0 ? previous + detail::unzigzag(gap) : previous + gap;
+      fn(previous);
+    }
+  }
+
+  //! \brief Decode the neighbors of v into a buffer.
+  //!
+  //! \param [in] v The internal index of the vertex.
+  //! \param [in,out] buffer Storage for the decoded row, reused between calls.
+  //! \return std::span<const Index> The neighbors of v in ascending order.
+  std::span<const Index> neighbors(Index v, std::vector<Index>& buffer) const
+  {
+    buffer.resize(degrees_[v]);
+    size_t i = 0;
+    forEachNeighbor(v, [&](Index u) { buffer[i++] = u; });
+    return buffer;
+  }
+
+  //! \brief The weights of the edges leaving v, parallel to its neighbors. Empty when unweighted.
+  std::span<const float> weights(Index v) const noexcept
+  {
+    if (!weighted_) { return {}; }
+    return {weights_.data() + weight_offsets_[v], degrees_[v]};
+  }
+
+  unsigned int externalId(Index v) const noexcept { return ids_[v]; }
+
+  std::optional<Index> internalId(unsigned int id) const noexcept
+  {
+    auto itr = std::lower_bound(by_id_.begin(), by_id_.end(), id, [&](Index v, unsigned int value) { return ids_[v] < value; });
+    if (itr == by_id_.end() || ids_[*itr] != id) { return {}; }
+    return *itr;
+  }
+
+  //! \brief The bytes of the encoded neighbor lists alone.
+  size_t adjacencyBytes() const noexcept { return data_.size(); }
+
+  //! \brief The bytes held by the graph, including row offsets, degrees, IDs and weights.
+  size_t memoryBytes() const noexcept
+  {
+    return data_.capacity() + offsets_.capacity() * sizeof(uint64_t) + degrees_.capacity() * sizeof(uint32_t) +
+           ids_.capacity() * sizeof(unsigned int) + by_id_.capacity() * sizeof(Index) +
+           weights_.capacity() * sizeof(float) + weight_offsets_.capacity() * sizeof(uint64_t);
+  }
+
+  //! \brief The encoded neighbor lists in bytes per edge.
+  double bytesPerEdge() const noexcept { return edge_count_ == 0 ? 0 : static_cast<double>(adjacencyBytes()) / edge_count_; }
+
+private:
+  static constexpr size_t kPadding = 4;
+
+  AdjacencyEncoding encoding_ = AdjacencyEncoding::StreamVByte;
+  bool directed_ = true;
+  bool weighted_ = false;
+  size_t edge_count_ = 0;
+  std::vector<uint8_t> data_;
+  //! \brief The byte offset of each row in data_.
+  std::vector<uint64_t> offsets_;
+  std::vector<uint32_t> degrees_;
+  std::vector<unsigned int> ids_;
+  //! \brief Internal indices sorted by external ID.
+  std::vector<Index> by_id_;
+  std::vector<float> weights_;
+  std::vector<uint64_t> weight_offsets_;
+
+  template <typename F>
+  static void forEachGap(Index v, std::span<const Index> row, F&& fn)
+  {
+    Index previous = v;
+    for (size_t i = 0; i < row.size(); i++)
+    {
+      fn(i == 0 ? detail::zigzag(row[i] - previous) : row[i] - previous);
+      previous = row[i];
+    }
+  }
+
+  size_t encodedSize(Index v, std::span<const Index> row) const
+  {
+    size_t size = encoding_ == AdjacencyEncoding::Varint ? 0 : (row.size() + 3) / 4;
+    forEachGap(v, row, [&](uint32_t gap)
+    {
+      size += encoding_ == AdjacencyEncoding::Varint ? detail::varintSize(gap) : detail::streamVByteLength(gap);
+    });
+    return size;
+  }
+
+  void encode(Index v, std::span<const Index> row, uint8_t* out) const
+  {
+    if (encoding_ == AdjacencyEncoding::Varint)
+    {
+      forEachGap(v, row, [&](uint32_t gap)
+      {
+        for (; gap >= 0x80; gap >>= 7) { *out++ = static_cast<uint8_t>(gap | 0x80); }
+        *out++ = static_cast<uint8_t>(gap);
+      });
+      return;
+    }
+
+    uint8_t* control = out;
+    uint8_t* bytes = out + (row.size() + 3) / 4;
+    size_t i = 0;
+    forEachGap(v, row, [&](uint32_t gap)
+    {
+      const size_t length = detail::streamVByteLength(gap);
+      control[i / 4] |= static_cast<uint8_t>((length - 1) << (2 * (i % 4)));
+      std::memcpy(bytes, &gap, length);
+      bytes += length;
+      i++;
+    });
+  }
+
+  void copyWeights(const CompactGraph& graph)
+  {
+    weight_offsets_.assign(graph.offsets().begin(), graph.offsets().end());
+    weights_.resize(graph.edgeCount());
+    for (Index v = 0; v < vertexCount(); v++)
+    {
+      const auto row = graph.weights(v);
+      std::copy(row.begin(), row.end(), weights_.begin() + weight_offsets_[v]);
+    }
+  }
+};
+
+
+//! \brief Breadth first order of the vertices reachable from a vertex, decoding rows on the fly.
+//!
+//! \param [in] graph The compressed graph.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<unsigned int> External IDs in breadth first order, empty if the vertex does not exist.
+inline std::vector<unsigned int> breadthFirstOrder(const CompressedGraph& graph, unsigned int source_id)
+{
+  using Index = CompressedGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("compressed_bfs");
+  std::vector<unsigned int> order;
+  auto source = graph.internalId(source_id);
+  if (!source.has_value()) { return order; }
+
+  std::vector<bool> visited(graph.vertexCount(), false);
+  std::vector<Index> queue{*source};
+  visited[*source] = true;
+  for (size_t head = 0; head < queue.size(); head++)
+  {
+    const Index v = queue[head];
+    order.push_back(graph.externalId(v));
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    GRAPH_LIB_COUNT(EdgesScanned, graph.degree(v));
+    graph.forEachNeighbor(v, [&](Index u)
+    {
+      if (visited[u]) { return; }
+      visited[u] = true;
+      queue.push_back(u);
+    });
+  }
+  return order;
+}
+
+//! \brief Depth first preorder of the vertices reachable from a vertex, decoding rows on the fly.
+//! Neighbors are visited in ascending internal order.
+//!
+//! \param [in] graph The compressed graph.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<unsigned int> External IDs in depth first preorder, empty if the vertex does not exist.
+inline std::vector<unsigned int> depthFirstOrder(const CompressedGraph& graph, unsigned int source_id)
+{
+  using Index = CompressedGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("compressed_dfs");
+  std::vector<unsigned int> order;
+  auto source = graph.internalId(source_id);
+  if (!source.has_value()) { return order; }
+
+  // Each row is decoded once, when its vertex is first visited, and kept until it is exhausted
+  std::vector<bool> visited(graph.vertexCount(), false);
+  std::vector<Index> rows;
+  std::vector<std::pair<size_t, size_t>> stack;
+  auto enter = [&](Index v)
+  {
+    visited[v] = true;
+    order.push_back(graph.externalId(v));
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    GRAPH_LIB_COUNT(EdgesScanned, graph.degree(v));
+    const size_t first = rows.size();
+    graph.forEachNeighbor(v, [&](Index u) { rows.push_back(u); });
+    stack.emplace_back(first, first);
+  };
+
+  enter(*source);
+  while (!stack.empty())
+  {
+    auto& [first, next] = stack.back();
+    while (next < rows.size() && visited[rows[next]]) { next++; }
+    if (next == rows.size())
+    {
+      rows.resize(first);
+      stack.pop_back();
+      continue;
+    }
+    enter(rows[next++]);
+  }
+  return order;
+}
+
+} // namespace graph_lib
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <concepts>
+#include <functional>
 
 namespace graph_lib
 {
@@ -15,4 +17,17 @@ concept Eqable = requires(T a, T b) {
 
 template <typename T>
 concept Graphable = Hashable<T> && Eqable<T>;
+
+//! \brief A graph, or a view of one, that algorithms can walk through its vertices and neighbors.
+template <typename G>
+concept TraversableGraph = requires(const G& g) {
+  typename G::ValueType;
+  typename G::VertexPtr;
+  { G::is_directed } -> std::convertible_to<bool>;
+  { G::is_weighted } -> std::convertible_to<bool>;
+  { g.getSize() } -> std::convertible_to<size_t>;
+  g.getVertex(0u);
+  g.forEachVertex([](const typename G::VertexPtr&) {});
+  g.forEachNeighbor(*std::declval<typename G::VertexPtr>(), [](const typename G::VertexPtr&, float) {});
+};
 } // namespace graph_lib
\ No newline at end of file
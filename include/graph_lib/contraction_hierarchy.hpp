@@ -0,0 +1,579 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/parallel.hpp>
+#include <graph_lib/shortest_path.hpp>
+
+
+namespace graph_lib
+{
+struct ContractionOptions
+{
+  //! \brief The number of threads used for contraction, 0 selects the hardware concurrency.
+  unsigned threads = 0;
+  //! \brief The number of vertices a witness search may settle before it gives up.
+  //! Lower limits contract faster but may add shortcuts that are not needed.
+  size_t witness_settle_limit = 500;
+};
+
+
+namespace detail
+{
+using Index = CompactGraph::Index;
+constexpr Index kNoMiddle = std::numeric_limits<Index>::max();
+
+//! \brief An edge of the graph being contracted. Shortcuts record the vertex they bypass.
+struct ContractionArc
+{
+  Index node;
+  float weight;
+  Index middle;
+};
+
+//! \brief Bounded Dijkstra search used to look for witness paths, reused by one thread.
+struct WitnessSearch
+{
+  std::vector<float> distance;
+  std::vector<uint32_t> stamp;
+  std::vector<std::pair<float, Index>> heap;
+  uint32_t generation = 0;
+
+  explicit WitnessSearch(size_t n): distance(n), stamp(n, 0) {}
+
+  float get(Index v) const noexcept { return stamp[v] == generation ? distance[v] : std::numeric_limits<float>::infinity(); }
+
+  //! \brief Search from source, never passing through ignored or inactive vertices.
+  template <typename Active>
+  void run(const std::vector<std::vector<ContractionArc>>& out, Index source, Index ignored, float limit,
+           size_t settle_limit, const Active& active)
+  {
+    if (++generation == 0) { std::fill(stamp.begin(), stamp.end(), 0); generation = 1; }
+    heap.clear();
+    distance[source] = 0;
+    stamp[source] = generation;
+    heap.emplace_back(0.0f, source);
+
+    size_t settled = 0;
+    while (!heap.empty() && settled < settle_limit)
+    {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+      auto [d, v] = heap.back();
+      heap.pop_back();
+      if (d > distance[v]) { continue; }
+      if (d > limit) { break; }
+      settled++;
+      for (const auto& arc : out[v])
+      {
+        if (arc.node == ignored || !active(arc.node)) { continue; }
+        const float candidate = d + arc.weight;
+        if (candidate < get(arc.node))
+        {
+          distance[arc.node] = candidate;
+          stamp[arc.node] = generation;
+          heap.emplace_back(candidate, arc.node);
+          std::push_heap(heap.begin(), heap.end(), std::greater<>());
+        }
+      }
+    }
+  }
+};
+
+struct Shortcut
+{
+  Index origin;
+  Index dest;
+  float weight;
+};
+} // namespace detail
+
+
+//! \brief Contraction hierarchy for fast repeated shortest path queries on a static graph.
+//! Preprocessing contracts the vertices one level at a time, adding shortcut edges that
+//! preserve every shortest distance. Each level is an independent set of vertices with
+//! locally minimal priority (edge difference plus contracted neighbors), whose witness
+//! searches run in parallel. A query then only runs a bidirectional Dijkstra on edges
+//! leading to higher levels, which settles a few hundred vertices on road-like graphs.
+//! Edge weights must not be negative.
+class ContractionHierarchy
+{
+public:
+  using Index = CompactGraph::Index;
+
+  ContractionHierarchy() = default;
+
+  //! \brief Contract a graph snapshot.
+  //!
+  //! \param [in] graph The graph. Unweighted graphs use a weight of 1 per edge.
+  //! \param [in] options Thread count and witness search limit.
+  //! \return ContractionHierarchy The hierarchy.
+  static ContractionHierarchy build(const CompactGraph& graph, const ContractionOptions& options = {})
+  {
+    GRAPH_LIB_SCOPED_TIMER("ch_build");
+    using detail::ContractionArc;
+    using detail::kNoMiddle;
+
+    const size_t n = graph.vertexCount();
+    ContractionHierarchy result;
+    result.ids_ = graph.externalIds();
+    result.buildIndex();
+    result.rank_.assign(n, 0);
+
+    // Working graph, with the cheapest edge kept between each pair of vertices
+    std::vector<std::vector<ContractionArc>> out(n), in(n);
+    auto addArc = [&](Index origin, Index dest, float weight, Index middle)
+    {
+      for (auto& arc : out[origin])
+      {
+        if (arc.node != dest) { continue; }
+        if (weight < arc.weight)
+        {
+          arc = {dest, weight, middle};
+          for (auto& back : in[dest]) { if (back.node == origin) { back = {origin, weight, middle}; } }
+        }
+        return;
+      }
+      out[origin].push_back({dest, weight, middle});
+      in[dest].push_back({origin, weight, middle});
+    };
+    for (Index v = 0; v < n; v++)
+    {
+      const auto row = graph.neighbors(v);
+      for (size_t i = 0; i < row.size(); i++) { if (row[i] != v) { addArc(v, row[i], graph.weight(v, i), kNoMiddle); } }
+    }
+
+    enum class Status : uint8_t { Active, Selected, Contracted };
+    std::vector<Status> status(n, Status::Active);
+    std::vector<int64_t> priority(n, 0);
+    std::vector<uint32_t> contracted_neighbors(n, 0);
+    auto active = [&status](Index v) { return status[v] == Status::Active; };
+
+    const unsigned threads = resolveThreads(options.threads);
+    std::vector<detail::WitnessSearch> searches(threads, detail::WitnessSearch(n));
+
+    // The shortcuts needed to contract v. Witness paths avoid v and every vertex selected in this level
+    auto shortcutsOf = [&](Index v, detail::WitnessSearch& search, std::vector<detail::Shortcut>* shortcuts)
+    {
+      size_t count = 0;
+      for (const auto& incoming : in[v])
+      {
+        float limit = -1;
+        for (const auto& outgoing : out[v]) { if (outgoing.node != incoming.node) { limit = std::max(limit, incoming.weight + outgoing.weight); } }
+        if (limit < 0) { continue; }
+        search.run(out, incoming.node, v, limit, options.witness_settle_limit, active);
+        for (const auto& outgoing : out[v])
+        {
+          if (outgoing.node == incoming.node) { continue; }
+          const float through = incoming.weight + outgoing.weight;
+          if (search.get(outgoing.node) <= through) { continue; }
+          count++;
+          if (shortcuts != nullptr) { shortcuts->push_back({incoming.node, outgoing.node, through}); }
+        }
+      }
+      return count;
+    };
+    auto updatePriority = [&](Index v, detail::WitnessSearch& search)
+    {
+      const int64_t added = static_cast<int64_t>(shortcutsOf(v, search, nullptr));
+      priority[v] = added - static_cast<int64_t>(in[v].size() + out[v].size()) + contracted_neighbors[v];
+    };
+
+    parallelForDynamic(0, n, threads, [&](size_t v, unsigned thread) { updatePriority(static_cast<Index>(v), searches[thread]); });
+
+    std::vector<Index> remaining(n);
+    for (Index v = 0; v < n; v++) { remaining[v] = v; }
+    std::vector<Index> selected;
+    std::vector<std::vector<detail::Shortcut>> shortcuts;
+    std::vector<Index> touched;
+    std::vector<std::vector<ContractionArc>> upward(n), downward(n);
+    Index level = 0;
+
+    while (!remaining.empty())
+    {
+      // Select the vertices whose priority is lower than that of all their neighbors
+      auto before = [&](Index a, Index b) { return std::pair(priority[a], a) < std::pair(priority[b], b); };
+      selected.clear();
+      for (Index v : remaining)
+      {
+        bool minimal = true;
+        for (const auto& arc : out[v]) { if (before(arc.node, v)) { minimal = false; break; } }
+        for (const auto& arc : in[v]) { if (minimal && before(arc.node, v)) { minimal = false; break; } }
+        if (minimal) { selected.push_back(v); }
+      }
+      for (Index v : selected) { status[v] = Status::Selected; }
+
+      shortcuts.assign(selected.size(), {});
+      parallelForDynamic(0, selected.size(), threads, [&](size_t i, unsigned thread)
+      {
+        shortcutsOf(selected[i], searches[thread], &shortcuts[i]);
+      });
+
+      // Contract the selected vertices. They are not adjacent, so the order does not matter
+      touched.clear();
+      for (size_t i = 0; i < selected.size(); i++)
+      {
+        const Index v = selected[i];
+        result.rank_[v] = level;
+        status[v] = Status::Contracted;
+        upward[v] = std::move(out[v]);
+        downward[v] = std::move(in[v]);
+        for (const auto& arc : upward[v])
+        {
+          std::erase_if(in[arc.node], [v](const ContractionArc& back) { return back.node == v; });
+          contracted_neighbors[arc.node]++;
+          touched.push_back(arc.node);
+        }
+        for (const auto& arc : downward[v])
+        {
+          std::erase_if(out[arc.node], [v](const ContractionArc& back) { return back.node == v; });
+          contracted_neighbors[arc.node]++;
+          touched.push_back(arc.node);
+        }
+        for (const auto& shortcut : shortcuts[i]) { addArc(shortcut.origin, shortcut.dest, shortcut.weight, v); }
+        out[v].clear();
+        in[v].clear();
+      }
+      level++;
+
+      std::erase_if(remaining, [&](Index v) { return status[v] == Status::Contracted; });
+      std::sort(touched.begin(), touched.end());
+      touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+      parallelForDynamic(0, touched.size(), threads, [&](size_t i, unsigned thread) { updatePriority(touched[i], searches[thread]); });
+    }
+
+    result.upward_ = Arcs::fromLists(upward);
+    result.downward_ = Arcs::fromLists(downward);
+    return result;
+  }
+
+  //! \brief Contract a graph or graph view.
+  template <typename G> requires TraversableGraph<G>
+  static ContractionHierarchy build(const G& graph, const ContractionOptions& options = {})
+  {
+    return build(CompactGraph::fromGraph(graph), options);
+  }
+
+  size_t vertexCount() const noexcept { return ids_.size(); }
+
+  //! \brief The number of stored edges, shortcuts included.
+  size_t edgeCount() const noexcept { return upward_.targets.size() + downward_.targets.size(); }
+
+  //! \brief The number of stored shortcuts.
+  size_t shortcutCount() const noexcept
+  {
+    return std::count_if(upward_.middles.begin(), upward_.middles.end(), [](Index m) { return m != detail::kNoMiddle; })
+         + std::count_if(downward_.middles.begin(), downward_.middles.end(), [](Index m) { return m != detail::kNoMiddle; });
+  }
+
+  //! \brief The contraction level of a vertex. Lower levels were contracted first.
+  std::optional<Index> level(unsigned int id) const noexcept
+  {
+    auto itr = index_.find(id);
+    if (itr == index_.end()) { return {}; }
+    return rank_[itr->second];
+  }
+
+  //! \brief Shortest path between two vertices.
+  //!
+  //! \param [in] source_id The external ID of the source vertex.
+  //! \param [in] target_id The external ID of the target vertex.
+  //! \param [in,out] state The search state to reuse, one per thread.
+  //! \return PathResult The distance and the path with every shortcut unpacked.
+  PathResult query(unsigned int source_id, unsigned int target_id, PathSearchState& state) const
+  {
+    GRAPH_LIB_SCOPED_TIMER("ch_query");
+    PathResult result;
+    auto source = index_.find(source_id);
+    auto target = index_.find(target_id);
+    if (source == index_.end() || target == index_.end()) { return result; }
+    const Index s = source->second, t = target->second;
+
+    state.begin(ids_.size());
+    const uint32_t generation = state.generation_;
+    auto& sides = state.sides_;
+    auto reach = [&](PathSearchState::Side& side, Index v, float distance, Index parent)
+    {
+      side.distance[v] = distance;
+      side.parent[v] = parent;
+      side.stamp[v] = generation;
+      side.heap.emplace_back(distance, v);
+      std::push_heap(side.heap.begin(), side.heap.end(), std::greater<>());
+    };
+    reach(sides[0], s, 0, s);
+    reach(sides[1], t, 0, t);
+
+    float best = std::numeric_limits<float>::infinity();
+    std::optional<Index> meet;
+    if (s == t) { best = 0; meet = s; }
+
+    // Each side only climbs the hierarchy and stops once its smallest distance reaches the best path
+    for (int turn = 0; !sides[0].heap.empty() || !sides[1].heap.empty(); turn ^= 1)
+    {
+      auto& side = sides[turn];
+      auto& other = sides[turn ^ 1];
+      if (side.heap.empty()) { continue; }
+      if (side.heap.front().first >= best) { side.heap.clear(); continue; }
+
+      std::pop_heap(side.heap.begin(), side.heap.end(), std::greater<>());
+      auto [distance, v] = side.heap.back();
+      side.heap.pop_back();
+      if (side.settled[v] == generation || distance > side.distance[v]) { continue; }
+      side.settled[v] = generation;
+      result.settled++;
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+
+      const Arcs& arcs = turn == 0 ? upward_ : downward_;
+      GRAPH_LIB_COUNT(EdgesScanned, arcs.offsets[v + 1] - arcs.offsets[v]);
+      for (size_t e = arcs.offsets[v]; e < arcs.offsets[v + 1]; e++)
+      {
+        const Index u = arcs.targets[e];
+        const float candidate = distance + arcs.weights[e];
+        if (side.stamp[u] != generation || candidate < side.distance[u]) { reach(side, u, candidate, v); }
+        if (other.stamp[u] == generation && side.distance[u] + other.distance[u] < best)
+        {
+          best = side.distance[u] + other.distance[u];
+          meet = u;
+        }
+      }
+    }
+
+    if (!meet.has_value()) { return result; }
+    result.distance = best;
+
+    // The hierarchy path goes up from the source to the meeting vertex, then down to the target
+    std::vector<Index> hops;
+    for (Index v = *meet; v != s; v = sides[0].parent[v]) { hops.push_back(v); }
+    hops.push_back(s);
+    std::reverse(hops.begin(), hops.end());
+    for (Index v = *meet; v != t; ) { v = sides[1].parent[v]; hops.push_back(v); }
+
+    result.path.push_back(ids_[hops.front()]);
+    for (size_t i = 0; i + 1 < hops.size(); i++) { unpack(hops[i], hops[i + 1], result.path); }
+    return result;
+  }
+
+  //! \brief Shortest path between two vertices with the calling thread's own search state.
+  PathResult query(unsigned int source_id, unsigned int target_id) const
+  {
+    thread_local PathSearchState state;
+    return query(source_id, target_id, state);
+  }
+
+  //! \brief Write the hierarchy in a binary format readable by load().
+  void save(std::ostream& stream) const
+  {
+    stream.write(kMagic, sizeof(kMagic));
+    writeVector(stream, ids_);
+    writeVector(stream, rank_);
+    upward_.save(stream);
+    downward_.save(stream);
+    if (!stream) { throw std::runtime_error("Failed to write the contraction hierarchy"); }
+  }
+
+  //! \brief Read a hierarchy written by save().
+  //!
+  //! \param [in] stream The stream to read from.
+  //! \exception std::runtime_error Thrown when the stream does not hold a valid hierarchy.
+  //! \return ContractionHierarchy The hierarchy.
+  static ContractionHierarchy load(std::istream& stream)
+  {
+    char magic[sizeof(kMagic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) { throw std::runtime_error("Not a contraction hierarchy"); }
+
+    ContractionHierarchy result;
+    result.ids_ = readVector<unsigned int>(stream);
+    result.rank_ = readVector<Index>(stream);
+    result.upward_ = Arcs::load(stream);
+    result.downward_ = Arcs::load(stream);
+
+    const size_t n = result.ids_.size();
+    if (result.rank_.size() != n || !result.upward_.valid(n) || !result.downward_.valid(n) || !result.consistent())
+    {
+      throw std::runtime_error("Corrupt contraction hierarchy");
+    }
+    result.buildIndex();
+    return result;
+  }
+
+private:
+  static constexpr char kMagic[8] = {'G', 'L', 'C', 'H', '0', '0', '0', '1'};
+
+  //! \brief Edges to higher levels in CSR form. Shortcuts record the vertex they bypass.
+  struct Arcs
+  {
+    std::vector<uint64_t> offsets{0};
+    std::vector<Index> targets;
+    std::vector<float> weights;
+    std::vector<Index> middles;
+
+    static Arcs fromLists(const std::vector<std::vector<detail::ContractionArc>>& lists)
+    {
+      Arcs arcs;
+      for (const auto& list : lists)
+      {
+        for (const auto& arc : list)
+        {
+          arcs.targets.push_back(arc.node);
+          arcs.weights.push_back(arc.weight);
+          arcs.middles.push_back(arc.middle);
+        }
+        arcs.offsets.push_back(arcs.targets.size());
+      }
+      return arcs;
+    }
+
+    //! \brief The index of the arc from v to u, if any.
+    std::optional<size_t> find(Index v, Index u) const noexcept
+    {
+      for (size_t e = offsets[v]; e < offsets[v + 1]; e++) { if (targets[e] == u) { return e; } }
+      return {};
+    }
+
+    bool valid(size_t n) const
+    {
+      if (offsets.size() != n + 1 || offsets.front() != 0 || offsets.back() != targets.size()) { return false; }
+      if (weights.size() != targets.size() || middles.size() != targets.size()) { return false; }
+      if (!std::is_sorted(offsets.begin(), offsets.end())) { return false; }
+      for (size_t e = 0; e < targets.size(); e++)
+      {
+        if (targets[e] >= n || (middles[e] != detail::kNoMiddle && middles[e] >= n)) { return false; }
+      }
+      return true;
+    }
+
+    void save(std::ostream& stream) const
+    {
+      writeVector(stream, offsets);
+      writeVector(stream, targets);
+      writeVector(stream, weights);
+      writeVector(stream, middles);
+    }
+
+    static Arcs load(std::istream& stream)
+    {
+      Arcs arcs;
+      arcs.offsets = readVector<uint64_t>(stream);
+      arcs.targets = readVector<Index>(stream);
+      arcs.weights = readVector<float>(stream);
+      arcs.middles = readVector<Index>(stream);
+      return arcs;
+    }
+  };
+
+  std::vector<unsigned int> ids_;
+  std::vector<Index> rank_;
+  Arcs upward_;
+  //! \brief For each vertex v, the edges (u, v) from higher levels, stored as arcs from v to u.
+  Arcs downward_;
+  std::unordered_map<unsigned int, Index> index_;
+
+  void buildIndex()
+  {
+    index_.clear();
+    index_.reserve(ids_.size());
+    for (Index v = 0; v < ids_.size(); v++) { index_.emplace(ids_[v], v); }
+  }
+
+  //! \brief The middle of the stored edge (a, b): detail::kNoMiddle for an original edge,
+  //! no value if the hierarchy has no such edge. An edge is stored at its lower end.
+  std::optional<Index> middleOf(Index a, Index b) const noexcept
+  {
+    if (rank_[a] == rank_[b]) { return {}; }
+    const auto edge = rank_[a] < rank_[b] ? upward_.find(a, b) : downward_.find(b, a);
+    if (!edge.has_value()) { return {}; }
+    return (rank_[a] < rank_[b] ? upward_ : downward_).middles[*edge];
+  }
+
+  //! \brief Whether the edges agree with the levels, as build() leaves them.
+  //! Every edge leads to a strictly higher level, levels are below vertexCount(), and
+  //! a shortcut's middle is below both of its ends with both of its halves stored.
+  //! Unpacking then always finds its edges, and ends because the lower end of the
+  //! edges it expands keeps going down.
+  bool consistent() const
+  {
+    const size_t n = ids_.size();
+    if (!std::all_of(rank_.begin(), rank_.end(), [n](Index rank) { return rank < n; })) { return false; }
+    for (Index v = 0; v < n; v++)
+    {
+      for (const Arcs* arcs : {&upward_, &downward_})
+      {
+        for (size_t e = arcs->offsets[v]; e < arcs->offsets[v + 1]; e++)
+        {
+          const Index u = arcs->targets[e], middle = arcs->middles[e];
+          if (rank_[u] <= rank_[v]) { return false; }
+          if (middle == detail::kNoMiddle) { continue; }
+
+          // The shortcut stands for (origin, middle) followed by (middle, dest)
+          const Index origin = arcs == &upward_ ? v : u, dest = arcs == &upward_ ? u : v;
+          if (rank_[middle] >= rank_[v]) { return false; }
+          if (!middleOf(origin, middle).has_value() || !middleOf(middle, dest).has_value()) { return false; }
+        }
+      }
+    }
+    return true;
+  }
+
+  //! \brief Append the original vertices of the edge (from, to) after from, expanding shortcuts.
+  //! \exception std::runtime_error Thrown when an edge to expand is not stored.
+  void unpack(Index from, Index to, std::vector<unsigned int>& path) const
+  {
+    std::vector<std::pair<Index, Index>> stack{{from, to}};
+    while (!stack.empty())
+    {
+      auto [a, b] = stack.back();
+      stack.pop_back();
+
+      const auto middle = middleOf(a, b);
+      if (!middle.has_value()) { throw std::runtime_error("Corrupt contraction hierarchy"); }
+      if (*middle == detail::kNoMiddle) { path.push_back(ids_[b]); continue; }
+      stack.emplace_back(*middle, b);
+      stack.emplace_back(a, *middle);
+    }
+  }
+
+  template <typename V>
+  static void writeVector(std::ostream& stream, const std::vector<V>& values)
+  {
+    const uint64_t size = values.size();
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(V)));
+  }
+
+  template <typename V>
+  static std::vector<V> readVector(std::istream& stream)
+  {
+    uint64_t size = 0;
+    stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!stream) { throw std::runtime_error("Truncated contraction hierarchy"); }
+
+    // Read in bounded pieces so a corrupt size cannot trigger a huge allocation up front
+    std::vector<V> values;
+    constexpr uint64_t kPiece = 1 << 16;
+    for (uint64_t read = 0; read < size; )
+    {
+      const uint64_t count = std::min(kPiece, size - read);
+      values.resize(read + count);
+      stream.read(reinterpret_cast<char*>(values.data() + read), static_cast<std::streamsize>(count * sizeof(V)));
+      if (!stream) { throw std::runtime_error("Truncated contraction hierarchy"); }
+      read += count;
+    }
+    return values;
+  }
+};
+
+} // namespace graph_lib
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/iterators.hpp>
+#include <graph_lib/vertex.hpp>
+
+
+namespace graph_lib
+{
+template <typename G>
+class DenseGraphIterator;
+
+//! \brief Graph stored as an adjacency bit matrix, for small dense graphs.
+//! Row v of the matrix holds one bit per vertex, set when the edge (v, u) exists,
+//! so an edge test is a single bit test and a neighbor scan walks 64 vertices per
+//! word. Weighted graphs keep the bit matrix for scans and add a dense weight matrix.
+//! The matrices take capacity² bits (plus capacity² floats when weighted), where the
+//! capacity grows by doubling, so the backend is limited to kMaxVertices vertices.
+//! Vertex IDs are shared with the other graph classes.
+//!
+//! \tparam T The type stored in the vertices.
+//! \tparam Directed Whether the edges are directed.
+//! \tparam Weighted Whether the edges carry weights.
+template <typename T, bool Directed, bool Weighted> requires Graphable<T>
+class DenseGraph
+{
+public:
+  using ValueType = T;
+  using VertexPtr = std::shared_ptr<Vertex<T>>;
+  using VertexSet = std::vector<VertexPtr>;
+  using Index = uint32_t;
+  using Iterator = DenseGraphIterator<DenseGraph>;
+
+  static constexpr bool is_directed = Directed;
+  static constexpr bool is_weighted = Weighted;
+  static constexpr size_t kMaxVertices = size_t{1} << 16;
+
+  DenseGraph() = default;
+
+  Iterator begin() const { return Iterator(*this, std::nullopt); }
+  Iterator end() const { return Iterator(); }
+
+  Iterator dfs_begin() const { return Iterator(*this, TraversalOrder::DepthFirst); }
+  Iterator dfs_end() const { return Iterator(); }
+
+  Iterator bfs_begin() const { return Iterator(*this, TraversalOrder::BreadthFirst); }
+  Iterator bfs_end() const { return Iterator(); }
+
+  //! \brief Get the number of vertices in the graph.
+  size_t getSize() const noexcept { return vertices_.size(); }
+
+  //! \brief Add a vertex to the graph.
+  //!
+  //! \param [in] value The value to store in the new vertex.
+  //! \return std::optional<unsigned int> The ID of the new vertex, empty if the value
+  //! is already in the graph, the graph holds kMaxVertices vertices, or the vertex
+  //! could not be stored (an allocation or a copy of the value threw). The vertices
+  //! and edges are unchanged in that case.
+  std::optional<unsigned int> addVertex(const T& value) noexcept
+  {
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    if (values_.contains(value) || vertices_.size() >= kMaxVertices) { return {}; }
+
+    // Each step inserts one element or nothing, so undoing the steps that completed restores the graph
+    const Index index = static_cast<Index>(vertices_.size());
+    try
+    {
+      if (vertices_.size() == capacity_) { grow(); }
+      vertices_.push_back(std::make_shared<Vertex<T>>(value));
+      const unsigned int id = vertices_.back()->getID();
+      try
+      {
+        values_.emplace(value, index);
+        index_.emplace(id, index);
+      }
+      catch (...)
+      {
+        values_.erase(value);
+        vertices_.pop_back();
+        throw;
+      }
+      return id;
+    }
+    catch (...) { return {}; }
+  }
+
+  //! \brief Add an edge to the graph.
+  //!
+  //! \param [in] origin_id The ID of the origin vertex.
+  //! \param [in] dest_id The ID of the destination vertex.
+  //! \return true If the edge is successfully added.
+  //! \return false If either vertex does not exist or the edge already exists.
+  bool addEdge(const unsigned int& origin_id, const unsigned int& dest_id) noexcept requires (!Weighted)
+  {
+    return insertEdge(origin_id, dest_id, 0);
+  }
+
+  //! \brief Add a weighted edge to the graph.
+  //!
+  //! \param [in] origin_id The ID of the origin vertex.
+  //! \param [in] dest_id The ID of the destination vertex.
+  //! \param [in] weight The weight of the edge.
+  //! \return true If the edge is successfully added.
+  //! \return false If either vertex does not exist or the edge already exists.
+  bool addEdge(const unsigned int& origin_id, const unsigned int& dest_id, float weight) noexcept requires Weighted
+  {
+    return insertEdge(origin_id, dest_id, weight);
+  }
+
+  //! \brief Whether an edge exists, in constant time.
+  bool hasEdge(const unsigned int& origin_id, const unsigned int& dest_id) const noexcept
+  {
+    auto origin = indexOf(origin_id);
+    auto dest = indexOf(dest_id);
+    return origin.has_value() && dest.has_value() && testBit(*origin, *dest);
+  }
+
+  //! \brief Get the weight of an edge, in constant time.
+  std::optional<float> getWeight(const unsigned int& origin_id, const unsigned int& dest_id) const noexcept requires Weighted
+  {
+    auto origin = indexOf(origin_id);
+    auto dest = indexOf(dest_id);
+    if (!origin.has_value() || !dest.has_value() || !testBit(*origin, *dest)) { return {}; }
+    return weights_[*origin * capacity_ + *dest];
+  }
+
+  //! \brief Get the vertex with the specified ID.
+  std::optional<VertexPtr> getVertex(const unsigned int& id) const noexcept
+  {
+    auto index = indexOf(id);
+    if (!index.has_value()) { return {}; }
+    return vertices_[*index];
+  }
+
+  //! \brief Find the ID of the vertex storing a value.
+  //! \return std::optional<unsigned int> The ID of the vertex, or no value if no vertex stores the value.
+  std::optional<unsigned int> findVertex(const T& value) const noexcept
+  {
+    auto itr = values_.find(value);
+    if (itr == values_.end()) { return {}; }
+    return vertices_[itr->second]->getID();
+  }
+
+  //! \brief Get the vertices in insertion order.
+  const VertexSet& getVertices() const noexcept { return vertices_; }
+
+  //! \brief Get the number of edges leaving a vertex, counted with popcount.
+  size_t degree(const unsigned int& id) const noexcept
+  {
+    auto index = indexOf(id);
+    if (!index.has_value()) { return 0; }
+    size_t count = 0;
+    for (uint64_t word : row(*index)) { count += std::popcount(word); }
+    return count;
+  }
+
+  //! \brief Get the number of vertices adjacent to both a and b, counted with popcount.
+  size_t commonNeighbors(const unsigned int& a_id, const unsigned int& b_id) const noexcept
+  {
+    auto a = indexOf(a_id);
+    auto b = indexOf(b_id);
+    if (!a.has_value() || !b.has_value()) { return 0; }
+    const uint64_t* row_a = bits_.data() + *a * words_;
+    const uint64_t* row_b = bits_.data() + *b * words_;
+    size_t count = 0;
+    for (size_t w = 0; w < words_; w++) { count += std::popcount(row_a[w] & row_b[w]); }
+    return count;
+  }
+
+  //! \brief Call a function for every vertex in the graph.
+  //!
+  //! \param [in] fn Callable invoked as fn(const VertexPtr& vertex).
+  template <typename F>
+  void forEachVertex(F&& fn) const
+  {
+    for (const auto& vertex : vertices_) { fn(vertex); }
+  }
+
+  //! \brief Call a function for every edge leaving a vertex, in insertion order of the destinations.
+  //! Unweighted edges report a weight of 0.
+  //!
+  //! \param [in] vertex The vertex whose edges are visited.
+  //! \param [in] fn Callable invoked as fn(const VertexPtr& dest, float weight).
+  template <typename F>
+  void forEachNeighbor(const Vertex<T>& vertex, F&& fn) const
+  {
+    auto index = indexOf(vertex.getID());
+    if (!index.has_value()) { return; }
+    const float* weights = Weighted ? weights_.data() + *index * capacity_ : nullptr;
+    forEachBit(row(*index), [&](Index dest)
+    {
+      GRAPH_LIB_COUNT(EdgesScanned, 1);
+      fn(vertices_[dest], Weighted ? weights[dest] : 0.0f);
+    });
+  }
+
+  //! \brief The number of words in each row of the bit matrix.
+  size_t rowWords() const noexcept { return words_; }
+
+  //! \brief The words of row v of the bit matrix.
+  std::span<const uint64_t> row(Index v) const noexcept { return {bits_.data() + v * words_, words_}; }
+
+  //! \brief The dense index of a vertex ID.
+  std::optional<Index> indexOf(unsigned int id) const noexcept
+  {
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    auto itr = index_.find(id);
+    if (itr == index_.end()) { return {}; }
+    return itr->second;
+  }
+
+  //! \brief Call fn(index) for every set bit of a bit row, in ascending order.
+  template <typename F>
+  static void forEachBit(std::span<const uint64_t> words, F&& fn)
+  {
+    for (size_t w = 0; w < words.size(); w++)
+    {
+      for (uint64_t word = words[w]; word != 0; word &= word - 1)
+      {
+        fn(static_cast<Index>(w * 64 + std::countr_zero(word)));
+      }
+    }
+  }
+
+private:
+  VertexSet vertices_;
+  std::unordered_map<T, Index> values_;
+  std::unordered_map<unsigned int, Index> index_;
+  //! \brief Row-major bit matrix with words_ words per row.
+  std::vector<uint64_t> bits_;
+  //! \brief Row-major weight matrix, capacity_ entries per row. Empty when unweighted.
+  std::vector<float> weights_;
+  size_t capacity_ = 0;
+  size_t words_ = 0;
+
+  bool testBit(Index origin, Index dest) const noexcept
+  {
+    return (bits_[origin * words_ + dest / 64] >> (dest % 64)) & 1;
+  }
+
+  void setEdge(Index origin, Index dest, float weight) noexcept
+  {
+    bits_[origin * words_ + dest / 64] |= uint64_t{1} << (dest % 64);
+    if constexpr (Weighted) { weights_[origin * capacity_ + dest] = weight; }
+  }
+
+  bool insertEdge(const unsigned int& origin_id, const unsigned int& dest_id, float weight) noexcept
+  {
+    auto origin = indexOf(origin_id);
+    auto dest = indexOf(dest_id);
+    if (!origin.has_value() || !dest.has_value()) { return false; }
+    if (testBit(*origin, *dest)) { return false; }
+
+    setEdge(*origin, *dest, weight);
+    if constexpr (!Directed) { setEdge(*dest, *origin, weight); }
+    return true;
+  }
+
+  //! \brief Double the capacity of the matrices, keeping every edge.
+  //! Both matrices are allocated before either is replaced, so a failed allocation leaves the graph as it was.
+  //! \exception std::bad_alloc Thrown when the larger matrices cannot be allocated.
+  void grow()
+  {
+    const size_t capacity = std::max<size_t>(64, capacity_ * 2);
+    const size_t words = capacity / 64;
+    std::vector<uint64_t> bits(capacity * words, 0);
+    std::vector<float> weights;
+    if constexpr (Weighted) { weights.assign(capacity * capacity, 0.0f); }
+
+    for (size_t v = 0; v < vertices_.size(); v++) { std::copy_n(bits_.data() + v * words_, words_, bits.data() + v * words); }
+    bits_ = std::move(bits);
+    if constexpr (Weighted)
+    {
+      for (size_t v = 0; v < vertices_.size(); v++) { std::copy_n(weights_.data() + v * capacity_, capacity_, weights.data() + v * capacity); }
+      weights_ = std::move(weights);
+    }
+    capacity_ = capacity;
+    words_ = words;
+  }
+};
+
+template <typename T> requires Graphable<T>
+using DenseUnweightedDirectedGraph = DenseGraph<T, true, false>;
+
+template <typename T> requires Graphable<T>
+using DenseWeightedDirectedGraph = DenseGraph<T, true, true>;
+
+template <typename T> requires Graphable<T>
+using DenseUnweightedUndirectedGraph = DenseGraph<T, false, false>;
+
+template <typename T> requires Graphable<T>
+using DenseWeightedUndirectedGraph = DenseGraph<T, false, true>;
+
+
+//! \brief Iterator over the vertices of a DenseGraph.
+//! Without an order the vertices are listed in insertion order. With an order the
+//! whole graph is traversed depth or breadth first, restarting from the next
+//! unvisited vertex whenever the frontier drains. Every vertex is returned once.
+//! The visited set is a bit row, so breadth first expansion takes whole words of
+//! unvisited neighbors at a time with row & ~visited.
+template <typename G>
+class DenseGraphIterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using difference_type   = std::ptrdiff_t;
+  using value_type        = typename G::VertexPtr;
+  using pointer           = value_type const*;
+  using reference         = value_type const&;
+  using Index             = typename G::Index;
+
+  //! \brief Construct the end iterator.
+  DenseGraphIterator() = default;
+
+  DenseGraphIterator(const G& graph, std::optional<TraversalOrder> order):
+    graph_(&graph), order_(order), visited_(graph.rowWords(), 0)
+  {
+#ifdef GRAPH_LIB_INSTRUMENTATION
+    if (order_.has_value()) { timer_.emplace(*order_ == TraversalOrder::DepthFirst ? "dense_dfs" : "dense_bfs"); }
+#endif
+    increment();
+  }
+
+  reference operator*() const { return current_; }
+  pointer operator->() const { return &current_; }
+
+  DenseGraphIterator& operator++() { increment(); return *this; }
+  DenseGraphIterator operator++(int) { auto tmp = *this; increment(); return tmp; }
+
+  bool operator==(const DenseGraphIterator& rhs) const { return current_ == rhs.current_; }
+
+private:
+  static constexpr Index kNone = std::numeric_limits<Index>::max();
+
+  const G* graph_ = nullptr;
+  std::optional<TraversalOrder> order_;
+  std::vector<uint64_t> visited_;
+  std::deque<Index> frontier_;
+  Index next_root_ = 0;
+  value_type current_;
+
+#ifdef GRAPH_LIB_INSTRUMENTATION
+  //! \brief Measures the traversal from the begin iterator until it reaches the end.
+  std::optional<instrumentation::ScopedTimer> timer_;
+#endif
+
+  bool isVisited(Index v) const noexcept { return (visited_[v / 64] >> (v % 64)) & 1; }
+  void markVisited(Index v) noexcept { visited_[v / 64] |= uint64_t{1} << (v % 64); }
+
+  //! \brief The next vertex in insertion order that was not visited yet.
+  Index nextRoot() noexcept
+  {
+    for (; next_root_ < graph_->getSize(); next_root_++) { if (!isVisited(next_root_)) { return next_root_++; } }
+    return kNone;
+  }
+
+  void produce(Index v)
+  {
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    current_ = graph_->getVertices()[v];
+  }
+
+  void increment()
+  {
+    current_ = nullptr;
+    if (graph_ == nullptr) { return; }
+    if (!order_.has_value())
+    {
+      if (next_root_ < graph_->getSize()) { produce(next_root_++); }
+      return;
+    }
+
+    if (*order_ == TraversalOrder::DepthFirst)
+    {
+      // Vertices are marked when popped, so stale stack entries are skipped here
+      while (!frontier_.empty() && isVisited(frontier_.back())) { frontier_.pop_back(); }
+      if (frontier_.empty())
+      {
+        const Index root = nextRoot();
+        if (root == kNone) { finish(); return; }
+        frontier_.push_back(root);
+      }
+
+      const Index v = frontier_.back();
+      frontier_.pop_back();
+      markVisited(v);
+      produce(v);
+
+      const auto row = graph_->row(v);
+      for (size_t w = 0; w < row.size(); w++)
+      {
+        const uint64_t fresh = row[w] & ~visited_[w];
+        G::forEachBit(std::span<const uint64_t>(&fresh, 1), [&](Index bit) { frontier_.push_back(static_cast<Index>(w * 64 + bit)); });
+      }
+    }
+    else
+    {
+      // Vertices are marked when queued, so each one is queued once
+      if (frontier_.empty())
+      {
+        const Index root = nextRoot();
+        if (root == kNone) { finish(); return; }
+        markVisited(root);
+        frontier_.push_back(root);
+      }
+
+      const Index v = frontier_.front();
+      frontier_.pop_front();
+      produce(v);
+
+      const auto row = graph_->row(v);
+      for (size_t w = 0; w < row.size(); w++)
+      {
+        const uint64_t fresh = row[w] & ~visited_[w];
+        visited_[w] |= fresh;
+        G::forEachBit(std::span<const uint64_t>(&fresh, 1), [&](Index bit) { frontier_.push_back(static_cast<Index>(w * 64 + bit)); });
+      }
+    }
+  }
+
+  void finish()
+  {
+#ifdef GRAPH_LIB_INSTRUMENTATION
+    timer_.reset();
+#endif
+  }
+};
+
+} // namespace graph_lib
@@ -0,0 +1,823 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/instrumentation.hpp>
+
+
+namespace graph_lib
+{
+struct PartitionOptions
+{
+  //! \brief The number of consecutive internal indices stored in each partition file.
+  //! A partition is the unit of IO, so its edges should fit comfortably in memory.
+  size_t partition_vertices = size_t{1} << 20;
+  //! \brief The number of edges DiskGraphWriter buffers before appending them to the spill files.
+  size_t spill_edges = size_t{1} << 20;
+};
+
+struct DiskGraphOptions
+{
+  //! \brief The bytes of partition files kept mapped at once. Partitions are unmapped in
+  //! least recently used order and their pages dropped from the page cache. The
+  //! partitions being read are always mapped, even when they exceed the budget.
+  size_t cache_bytes = size_t{256} << 20;
+};
+
+
+namespace detail
+{
+constexpr char kDiskGraphMagic[8] = {'G', 'L', 'D', 'G', '0', '0', '0', '1'};
+constexpr char kPartitionMagic[8] = {'G', 'L', 'D', 'P', '0', '0', '0', '1'};
+
+//! \brief The fixed size header at the start of each partition file.
+//! It is followed by vertex_count + 1 row offsets, the targets and, when weighted, the weights.
+struct PartitionHeader
+{
+  char magic[8];
+  uint64_t first_vertex;
+  uint64_t vertex_count;
+  uint64_t edge_count;
+  uint64_t weighted;
+};
+
+inline std::filesystem::path metaPath(const std::filesystem::path& directory) { return directory / "graph.meta"; }
+
+inline std::filesystem::path partitionPath(const std::filesystem::path& directory, size_t partition, const char* extension)
+{
+  return directory / ("partition-" + std::to_string(partition) + extension);
+}
+
+template <typename V>
+void writeBinary(std::ostream& stream, std::span<const V> values)
+{
+  stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+}
+
+template <typename V>
+void readBinary(std::istream& stream, std::span<V> values)
+{
+  stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+}
+
+//! \brief A read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept { swap(other); }
+  MappedFile& operator=(MappedFile&& other) noexcept { close(); swap(other); return *this; }
+  ~MappedFile() { close(); }
+
+  //! \brief Map a file.
+  //!
+  //! \param [in] path The file to map.
+  //! \exception std::runtime_error Thrown when the file cannot be opened or mapped.
+  void open(const std::filesystem::path& path)
+  {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) { throw std::runtime_error("Failed to open " + path.string()); }
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) { close(); throw std::runtime_error("Failed to stat " + path.string()); }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) { return; }
+    void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) { close(); throw std::runtime_error("Failed to map " + path.string()); }
+    data_ = static_cast<const uint8_t*>(data);
+  }
+
+  //! \brief Unmap the file and drop its pages from the page cache.
+  void close() noexcept
+  {
+    if (data_ != nullptr) { ::munmap(const_cast<uint8_t*>(data_), size_); }
+    if (fd_ >= 0)
+    {
+      ::posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+      ::close(fd_);
+    }
+    data_ = nullptr;
+    fd_ = -1;
+    size_ = 0;
+  }
+
+  //! \brief Tell the kernel the mapping is about to be read front to back, so it reads ahead aggressively.
+  void adviseSequential() const noexcept
+  {
+    if (data_ != nullptr) { ::madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL); }
+  }
+
+  bool isOpen() const noexcept { return fd_ >= 0; }
+  const uint8_t* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+
+private:
+  int fd_ = -1;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+
+  void swap(MappedFile& other) noexcept
+  {
+    std::swap(fd_, other.fd_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+  }
+};
+} // namespace detail
+
+
+//! \brief Writes a graph into the partition files read by DiskGraph, one edge at a time.
+//! Internal indices are split into ranges of PartitionOptions::partition_vertices, and
+//! each range becomes one CSR partition file holding the edges leaving its vertices.
+//! Edges are buffered and appended to a spill file per partition, so the whole edge
+//! list never has to be in memory: only the external IDs and one partition at a time.
+//! Undirected graphs store every edge in both directions, as in CompactGraph.
+class DiskGraphWriter
+{
+public:
+  using Index = CompactGraph::Index;
+
+  //! \brief Start writing a graph into a directory, which is created if needed.
+  //!
+  //! \param [in] directory The directory for the partition files.
+  //! \param [in] ids The external ID of each internal index.
+  //! \param [in] directed Whether the edges are directed.
+  //! \param [in] weighted Whether the weights are kept.
+  //! \param [in] options The partition size and spill buffer size.
+  //! \exception std::invalid_argument Thrown when partition_vertices is 0.
+  DiskGraphWriter(std::filesystem::path directory, std::vector<unsigned int> ids, bool directed, bool weighted, const PartitionOptions& options = {})
+    : directory_(std::move(directory)), ids_(std::move(ids)), options_(options), directed_(directed), weighted_(weighted)
+  {
+    if (options_.partition_vertices == 0) { throw std::invalid_argument("Partitions must hold at least one vertex"); }
+    std::filesystem::create_directories(directory_);
+    buffers_.resize((ids_.size() + options_.partition_vertices - 1) / options_.partition_vertices);
+  }
+
+  DiskGraphWriter(const DiskGraphWriter&) = delete;
+  DiskGraphWriter& operator=(const DiskGraphWriter&) = delete;
+
+  //! \brief Remove the spill files of a writer that was never finished.
+  ~DiskGraphWriter()
+  {
+    if (finished_) { return; }
+    std::error_code error;
+    for (size_t p = 0; p < buffers_.size(); p++) { std::filesystem::remove(detail::partitionPath(directory_, p, ".spill"), error); }
+  }
+
+  //! \brief Add an edge between two internal indices.
+  //!
+  //! \param [in] origin The internal index of the origin vertex.
+  //! \param [in] dest The internal index of the destination vertex.
+  //! \param [in] weight The weight of the edge, ignored when unweighted.
+  //! \exception std::invalid_argument Thrown when an index is out of range.
+  void addEdge(Index origin, Index dest, float weight = 1)
+  {
+    if (origin >= ids_.size() || dest >= ids_.size()) { throw std::invalid_argument("Edge endpoint out of range"); }
+    append(origin, dest, weight);
+    if (!directed_ && origin != dest) { append(dest, origin, weight); }
+  }
+
+  //! \brief Sort each partition and write the partition files and the metadata.
+  //!
+  //! \exception std::runtime_error Thrown when a file cannot be read or written.
+  void finish()
+  {
+    GRAPH_LIB_SCOPED_TIMER("disk_graph_write");
+    flush();
+    for (size_t p = 0; p < buffers_.size(); p++) { writePartition(p); }
+
+    std::ofstream meta(detail::metaPath(directory_), std::ios::binary | std::ios::trunc);
+    const uint64_t fields[] = {ids_.size(), edge_count_, directed_, weighted_, options_.partition_vertices};
+    meta.write(detail::kDiskGraphMagic, sizeof(detail::kDiskGraphMagic));
+    detail::writeBinary(meta, std::span<const uint64_t>(fields));
+    detail::writeBinary(meta, std::span<const unsigned int>(ids_));
+    if (!meta) { throw std::runtime_error("Failed to write " + detail::metaPath(directory_).string()); }
+    finished_ = true;
+  }
+
+private:
+  struct SpillEdge
+  {
+    Index origin;
+    Index dest;
+    float weight;
+  };
+
+  std::filesystem::path directory_;
+  std::vector<unsigned int> ids_;
+  PartitionOptions options_;
+  bool directed_;
+  bool weighted_;
+  bool finished_ = false;
+  std::vector<std::vector<SpillEdge>> buffers_;
+  size_t buffered_ = 0;
+  uint64_t edge_count_ = 0;
+
+  void append(Index origin, Index dest, float weight)
+  {
+    buffers_[origin / options_.partition_vertices].push_back({origin, dest, weighted_ ? weight : 1.0f});
+    edge_count_++;
+    if (++buffered_ >= options_.spill_edges) { flush(); }
+  }
+
+  void flush()
+  {
+    for (size_t p = 0; p < buffers_.size(); p++)
+    {
+      auto& buffer = buffers_[p];
+      if (buffer.empty()) { continue; }
+      const auto path = detail::partitionPath(directory_, p, ".spill");
+      std::ofstream spill(path, std::ios::binary | std::ios::app);
+      detail::writeBinary(spill, std::span<const SpillEdge>(buffer));
+      if (!spill) { throw std::runtime_error("Failed to write " + path.string()); }
+      buffer.clear();
+      buffer.shrink_to_fit();
+    }
+    buffered_ = 0;
+  }
+
+  void writePartition(size_t p)
+  {
+    const auto spill_path = detail::partitionPath(directory_, p, ".spill");
+    std::vector<SpillEdge> edges;
+    if (std::filesystem::exists(spill_path))
+    {
+      edges.resize(std::filesystem::file_size(spill_path) / sizeof(SpillEdge));
+      std::ifstream spill(spill_path, std::ios::binary);
+      detail::readBinary(spill, std::span<SpillEdge>(edges));
+      if (!spill) { throw std::runtime_error("Failed to read " + spill_path.string()); }
+    }
+    std::sort(edges.begin(), edges.end(), [](const SpillEdge& a, const SpillEdge& b)
+    {
+      return std::tie(a.origin, a.dest, a.weight) < std::tie(b.origin, b.dest, b.weight);
+    });
+
+    const size_t first = p * options_.partition_vertices;
+    const size_t count = std::min(options_.partition_vertices, ids_.size() - first);
+    std::vector<uint64_t> offsets(count + 1, 0);
+    std::vector<Index> targets(edges.size());
+    std::vector<float> weights(weighted_ ? edges.size() : 0);
+    for (size_t e = 0; e < edges.size(); e++)
+    {
+      offsets[edges[e].origin - first + 1]++;
+      targets[e] = edges[e].dest;
+      if (weighted_) { weights[e] = edges[e].weight; }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    detail::PartitionHeader header{};
+    std::memcpy(header.magic, detail::kPartitionMagic, sizeof(header.magic));
+    header.first_vertex = first;
+    header.vertex_count = count;
+    header.edge_count = edges.size();
+    header.weighted = weighted_;
+
+    const auto path = detail::partitionPath(directory_, p, ".bin");
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    detail::writeBinary(out, std::span<const uint64_t>(offsets));
+    detail::writeBinary(out, std::span<const Index>(targets));
+    detail::writeBinary(out, std::span<const float>(weights));
+    if (!out) { throw std::runtime_error("Failed to write " + path.string()); }
+    std::filesystem::remove(spill_path);
+  }
+};
+
+
+//! \brief Read-only graph whose adjacency lives in memory mapped partition files.
+//! Vertices use dense internal indices and external IDs as in CompactGraph, and
+//! each partition file holds the CSR rows of a contiguous range of internal
+//! indices. Only the external IDs stay in memory; rows are read through mappings
+//! that are created on demand and released in least recently used order once the
+//! DiskGraphOptions::cache_bytes budget is exceeded.
+//! Algorithms that scan whole partitions in order with streamPartition() read the
+//! files sequentially, which is what makes graphs larger than memory practical.
+//! Not thread safe, including const member functions, which update the mappings.
+class DiskGraph
+{
+public:
+  using Index = CompactGraph::Index;
+
+  DiskGraph() = default;
+  DiskGraph(DiskGraph&&) = default;
+  DiskGraph& operator=(DiskGraph&&) = default;
+
+  //! \brief Write a CSR snapshot into partition files.
+  //!
+  //! \param [in] graph The snapshot to write.
+  //! \param [in] directory The directory for the partition files, created if needed.
+  //! \param [in] options The partition size.
+  //! \exception std::runtime_error Thrown when a file cannot be written.
+  static void write(const CompactGraph& graph, const std::filesystem::path& directory, const PartitionOptions& options = {})
+  {
+    DiskGraphWriter writer(directory, graph.externalIds(), graph.isDirected(), graph.isWeighted(), options);
+    for (Index v = 0; v < graph.vertexCount(); v++)
+    {
+      const auto row = graph.neighbors(v);
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        // Undirected rows already hold both directions
+        if (graph.isDirected() || v <= row[i]) { writer.addEdge(v, row[i], graph.weight(v, i)); }
+      }
+    }
+    writer.finish();
+  }
+
+  //! \brief Open a graph written by write() or DiskGraphWriter.
+  //! Partition files are only mapped when they are first read.
+  //!
+  //! \param [in] directory The directory holding the partition files.
+  //! \param [in] options The page cache budget.
+  //! \exception std::runtime_error Thrown when the directory does not hold a valid graph.
+  //! \return DiskGraph The graph.
+  static DiskGraph open(const std::filesystem::path& directory, const DiskGraphOptions& options = {})
+  {
+    std::ifstream meta(detail::metaPath(directory), std::ios::binary);
+    char magic[sizeof(detail::kDiskGraphMagic)];
+    meta.read(magic, sizeof(magic));
+    if (!meta || std::memcmp(magic, detail::kDiskGraphMagic, sizeof(magic)) != 0)
+    {
+      throw std::runtime_error("Not a disk graph: " + directory.string());
+    }
+
+    uint64_t fields[5];
+    detail::readBinary(meta, std::span<uint64_t>(fields));
+    if (!meta || fields[4] == 0 || fields[0] > std::numeric_limits<Index>::max()) { throw std::runtime_error("Corrupt disk graph metadata"); }
+
+    DiskGraph result;
+    result.edge_count_ = fields[1];
+    result.directed_ = fields[2] != 0;
+    result.weighted_ = fields[3] != 0;
+    result.partition_vertices_ = fields[4];
+    result.cache_bytes_ = options.cache_bytes;
+    result.ids_.resize(fields[0]);
+    detail::readBinary(meta, std::span<unsigned int>(result.ids_));
+    if (!meta) { throw std::runtime_error("Truncated disk graph metadata"); }
+
+    result.by_id_.resize(result.ids_.size());
+    std::iota(result.by_id_.begin(), result.by_id_.end(), Index{0});
+    std::sort(result.by_id_.begin(), result.by_id_.end(), [&](Index a, Index b) { return result.ids_[a] < result.ids_[b]; });
+
+    const size_t partitions = (result.ids_.size() + result.partition_vertices_ - 1) / result.partition_vertices_;
+    result.partitions_.resize(partitions);
+    for (size_t p = 0; p < partitions; p++)
+    {
+      auto& partition = result.partitions_[p];
+      partition.path = detail::partitionPath(directory, p, ".bin");
+      if (!std::filesystem::exists(partition.path)) { throw std::runtime_error("Missing partition file " + partition.path.string()); }
+      partition.bytes = std::filesystem::file_size(partition.path);
+    }
+    return result;
+  }
+
+  size_t vertexCount() const noexcept { return ids_.size(); }
+
+  //! \brief The number of stored edges. Undirected edges are counted once per direction.
+  size_t edgeCount() const noexcept { return edge_count_; }
+
+  bool isDirected() const noexcept { return directed_; }
+  bool isWeighted() const noexcept { return weighted_; }
+
+  size_t partitionCount() const noexcept { return partitions_.size(); }
+
+  //! \brief The partition holding the row of v.
+  size_t partitionOf(Index v) const noexcept { return v / partition_vertices_; }
+
+  //! \brief The first internal index of a partition and the number of vertices in it.
+  std::pair<Index, size_t> partitionRange(size_t p) const noexcept
+  {
+    const size_t first = p * partition_vertices_;
+    return {static_cast<Index>(first), std::min(partition_vertices_, ids_.size() - first)};
+  }
+
+  //! \brief The out degree of v. Maps the partition of v.
+  size_t degree(Index v) const
+  {
+    const auto& partition = acquire(partitionOf(v));
+    const size_t local = v - partition.first;
+    return partition.offsets[local + 1] - partition.offsets[local];
+  }
+
+  //! \brief Call a function for every neighbor of v, in ascending order.
+  //! The partition of v stays mapped during the calls.
+  //!
+  //! \param [in] v The internal index of the vertex.
+  //! \param [in] fn Callable invoked as fn(Index neighbor).
+  template <typename F>
+  void forEachNeighbor(Index v, F&& fn) const
+  {
+    Pin pin(acquire(partitionOf(v)));
+    const auto& partition = *pin.partition;
+    const size_t local = v - partition.first;
+    for (uint64_t e = partition.offsets[local]; e < partition.offsets[local + 1]; e++) { fn(partition.targets[e]); }
+  }
+
+  //! \brief Copy the neighbors of v into a buffer.
+  //!
+  //! \param [in] v The internal index of the vertex.
+  //! \param [in,out] buffer Storage for the row, reused between calls.
+  //! \return std::span<const Index> The neighbors of v in ascending order.
+  std::span<const Index> neighbors(Index v, std::vector<Index>& buffer) const
+  {
+    buffer.clear();
+    forEachNeighbor(v, [&](Index u) { buffer.push_back(u); });
+    return buffer;
+  }
+
+  //! \brief Copy the weights of the edges leaving v into a buffer, parallel to its neighbors. Empty when unweighted.
+  std::span<const float> weights(Index v, std::vector<float>& buffer) const
+  {
+    buffer.clear();
+    if (!weighted_) { return buffer; }
+    const auto& partition = acquire(partitionOf(v));
+    const size_t local = v - partition.first;
+    buffer.assign(partition.weights + partition.offsets[local], partition.weights + partition.offsets[local + 1]);
+    return buffer;
+  }
+
+  unsigned int externalId(Index v) const noexcept { return ids_[v]; }
+
+  std::optional<Index> internalId(unsigned int id) const noexcept
+  {
+    auto itr = std::lower_bound(by_id_.begin(), by_id_.end(), id, [&](Index v, unsigned int value) { return ids_[v] < value; });
+    if (itr == by_id_.end() || ids_[*itr] != id) { return {}; }
+    return *itr;
+  }
+
+  //! \brief Read every row of a partition front to back.
+  //! The partition is mapped for sequential access and stays mapped during the calls.
+  //!
+  //! \param [in] p The partition to read.
+  //! \param [in] fn Callable invoked as fn(Index v, std::span<const Index> neighbors, std::span<const float> weights)
+  //!                for each vertex of the partition in ascending order. Weights are empty when unweighted.
+  template <typename F>
+  void streamPartition(size_t p, F&& fn) const
+  {
+    Pin pin(acquire(p));
+    const auto& partition = *pin.partition;
+    partition.file.adviseSequential();
+    GRAPH_LIB_COUNT(VerticesVisited, partition.count);
+    GRAPH_LIB_COUNT(EdgesScanned, partition.offsets[partition.count]);
+    for (size_t local = 0; local < partition.count; local++)
+    {
+      const uint64_t first = partition.offsets[local], last = partition.offsets[local + 1];
+      fn(static_cast<Index>(partition.first + local), std::span<const Index>(partition.targets + first, last - first),
+         weighted_ ? std::span<const float>(partition.weights + first, last - first) : std::span<const float>());
+    }
+  }
+
+  //! \brief Read every edge, one partition at a time.
+  //!
+  //! \param [in] fn Callable invoked as fn(Index origin, Index dest, float weight). The weight is 1 when unweighted.
+  template <typename F>
+  void streamEdges(F&& fn) const
+  {
+    for (size_t p = 0; p < partitions_.size(); p++)
+    {
+      streamPartition(p, [&](Index v, std::span<const Index> row, std::span<const float> weights)
+      {
+        for (size_t i = 0; i < row.size(); i++) { fn(v, row[i], weights.empty() ? 1.0f : weights[i]); }
+      });
+    }
+  }
+
+  //! \brief The bytes of partition files currently mapped.
+  size_t mappedBytes() const noexcept { return mapped_bytes_; }
+
+  //! \brief The number of times a partition file was mapped, counting remaps after eviction.
+  size_t partitionLoads() const noexcept { return loads_; }
+
+private:
+  struct Partition
+  {
+    std::filesystem::path path;
+    size_t bytes = 0;
+    Index first = 0;
+    size_t count = 0;
+    detail::MappedFile file;
+    uint64_t last_use = 0;
+    unsigned pins = 0;
+    const uint64_t* offsets = nullptr;
+    const Index* targets = nullptr;
+    const float* weights = nullptr;
+  };
+
+  //! \brief Keeps a partition mapped while its rows are being read.
+  struct Pin
+  {
+    explicit Pin(Partition& partition) noexcept: partition(&partition) { partition.pins++; }
+    Pin(const Pin&) = delete;
+    Pin& operator=(const Pin&) = delete;
+    ~Pin() { partition->pins--; }
+
+    Partition* partition;
+  };
+
+  std::vector<unsigned int> ids_;
+  //! \brief Internal indices sorted by external ID.
+  std::vector<Index> by_id_;
+  size_t edge_count_ = 0;
+  bool directed_ = true;
+  bool weighted_ = false;
+  size_t partition_vertices_ = 1;
+  size_t cache_bytes_ = 0;
+  mutable std::vector<Partition> partitions_;
+  mutable size_t mapped_bytes_ = 0;
+  mutable size_t loads_ = 0;
+  mutable uint64_t clock_ = 0;
+
+  //! \brief Map a partition if needed, evicting the least recently used unpinned partitions to stay in budget.
+  Partition& acquire(size_t p) const
+  {
+    auto& partition = partitions_[p];
+    partition.last_use = ++clock_;
+    if (partition.file.isOpen()) { return partition; }
+
+    while (mapped_bytes_ + partition.bytes > cache_bytes_)
+    {
+      Partition* victim = nullptr;
+      for (auto& candidate : partitions_)
+      {
+        if (candidate.file.isOpen() && candidate.pins == 0 && (victim == nullptr || candidate.last_use < victim->last_use)) { victim = &candidate; }
+      }
+      if (victim == nullptr) { break; }
+      victim->file.close();
+      mapped_bytes_ -= victim->bytes;
+    }
+
+    partition.file.open(partition.path);
+    mapped_bytes_ += partition.bytes;
+    loads_++;
+    try { bind(p, partition); }
+    catch (...)
+    {
+      partition.file.close();
+      mapped_bytes_ -= partition.bytes;
+      throw;
+    }
+    return partition;
+  }
+
+  //! \brief Check a freshly mapped partition and point at its arrays.
+  void bind(size_t p, Partition& partition) const
+  {
+    const auto [first, count] = partitionRange(p);
+    detail::PartitionHeader header;
+    if (partition.file.size() < sizeof(header)) { throw std::runtime_error("Corrupt partition file " + partition.path.string()); }
+    std::memcpy(&header, partition.file.data(), sizeof(header));
+
+    const uint64_t offsets_bytes = (header.vertex_count + 1) * sizeof(uint64_t);
+    const uint64_t expected = sizeof(header) + offsets_bytes + header.edge_count * (sizeof(Index) + (weighted_ ? sizeof(float) : 0));
+    if (std::memcmp(header.magic, detail::kPartitionMagic, sizeof(header.magic)) != 0 || header.first_vertex != first ||
+        header.vertex_count != count || (header.weighted != 0) != weighted_ || partition.file.size() != expected)
+    {
+      throw std::runtime_error("Corrupt partition file " + partition.path.string());
+    }
+
+    const uint8_t* data = partition.file.data() + sizeof(header);
+    partition.first = first;
+    partition.count = count;
+    partition.offsets = reinterpret_cast<const uint64_t*>(data);
+    partition.targets = reinterpret_cast<const Index*>(data + offsets_bytes);
+    partition.weights = weighted_ ? reinterpret_cast<const float*>(data + offsets_bytes + header.edge_count * sizeof(Index)) : nullptr;
+    // Rows must lie inside the targets and targets inside the graph, since readers index by them unchecked
+    bool valid = partition.offsets[0] == 0 && partition.offsets[count] == header.edge_count;
+    for (size_t v = 0; valid && v < count; v++) { valid = partition.offsets[v] <= partition.offsets[v + 1]; }
+    for (uint64_t e = 0; valid && e < header.edge_count; e++) { valid = partition.targets[e] < ids_.size(); }
+    if (!valid) { throw std::runtime_error("Corrupt partition file " + partition.path.string()); }
+  }
+};
+
+
+//! \brief The level of vertices a streaming BFS did not reach.
+constexpr uint32_t kUnreachedLevel = std::numeric_limits<uint32_t>::max();
+
+struct PageRankOptions
+{
+  //! \brief The probability of following an edge rather than jumping to a random vertex.
+  double damping = 0.85;
+  unsigned max_iterations = 100;
+  //! \brief Stop once the L1 distance between two successive rank vectors falls below this.
+  double tolerance = 1e-9;
+};
+
+
+//! \brief Breadth first order of the vertices reachable from a vertex, reading rows through the partition cache.
+//!
+//! \param [in] graph The disk graph.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<unsigned int> External IDs in breadth first order, empty if the vertex does not exist.
+inline std::vector<unsigned int> breadthFirstOrder(const DiskGraph& graph, unsigned int source_id)
+{
+  using Index = DiskGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("disk_bfs");
+  std::vector<unsigned int> order;
+  auto source = graph.internalId(source_id);
+  if (!source.has_value()) { return order; }
+
+  std::vector<bool> visited(graph.vertexCount(), false);
+  std::vector<Index> queue{*source};
+  visited[*source] = true;
+  for (size_t head = 0; head < queue.size(); head++)
+  {
+    const Index v = queue[head];
+    order.push_back(graph.externalId(v));
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    graph.forEachNeighbor(v, [&](Index u)
+    {
+      GRAPH_LIB_COUNT(EdgesScanned, 1);
+      if (visited[u]) { return; }
+      visited[u] = true;
+      queue.push_back(u);
+    });
+  }
+  return order;
+}
+
+//! \brief Depth first preorder of the vertices reachable from a vertex, reading rows through the partition cache.
+//! Neighbors are visited in ascending internal order.
+//!
+//! \param [in] graph The disk graph.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<unsigned int> External IDs in depth first preorder, empty if the vertex does not exist.
+inline std::vector<unsigned int> depthFirstOrder(const DiskGraph& graph, unsigned int source_id)
+{
+  using Index = DiskGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("disk_dfs");
+  std::vector<unsigned int> order;
+  auto source = graph.internalId(source_id);
+  if (!source.has_value()) { return order; }
+
+  // Each row is copied once, when its vertex is first visited, so the partition can be evicted afterwards
+  std::vector<bool> visited(graph.vertexCount(), false);
+  std::vector<Index> rows;
+  std::vector<std::pair<size_t, size_t>> stack;
+  auto enter = [&](Index v)
+  {
+    visited[v] = true;
+    order.push_back(graph.externalId(v));
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    const size_t first = rows.size();
+    graph.forEachNeighbor(v, [&](Index u) { rows.push_back(u); });
+    GRAPH_LIB_COUNT(EdgesScanned, rows.size() - first);
+    stack.emplace_back(first, first);
+  };
+
+  enter(*source);
+  while (!stack.empty())
+  {
+    auto& [first, next] = stack.back();
+    while (next < rows.size() && visited[rows[next]]) { next++; }
+    if (next == rows.size())
+    {
+      rows.resize(first);
+      stack.pop_back();
+      continue;
+    }
+    enter(rows[next++]);
+  }
+  return order;
+}
+
+//! \brief Hop distances from a vertex, computed by streaming partitions level by level.
+//! Each level reads, in file order, only the partitions holding a vertex of the
+//! current frontier, and scans their rows sequentially instead of seeking to
+//! individual vertices. Memory use is one level per vertex.
+//!
+//! \param [in] graph The disk graph.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<uint32_t> The level of each internal index, kUnreachedLevel when unreachable.
+//!                               Empty if the vertex does not exist.
+inline std::vector<uint32_t> streamingBfs(const DiskGraph& graph, unsigned int source_id)
+{
+  using Index = DiskGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("disk_streaming_bfs");
+  auto source = graph.internalId(source_id);
+  if (!source.has_value()) { return {}; }
+
+  std::vector<uint32_t> levels(graph.vertexCount(), kUnreachedLevel);
+  std::vector<bool> active(graph.partitionCount(), false), next(graph.partitionCount(), false);
+  levels[*source] = 0;
+  active[graph.partitionOf(*source)] = true;
+  for (uint32_t level = 0; std::find(active.begin(), active.end(), true) != active.end(); level++)
+  {
+    std::fill(next.begin(), next.end(), false);
+    for (size_t p = 0; p < active.size(); p++)
+    {
+      if (!active[p]) { continue; }
+      graph.streamPartition(p, [&](Index v, std::span<const Index> row, std::span<const float>)
+      {
+        if (levels[v] != level) { return; }
+        for (Index u : row)
+        {
+          if (levels[u] != kUnreachedLevel) { continue; }
+          levels[u] = level + 1;
+          next[graph.partitionOf(u)] = true;
+        }
+      });
+    }
+    active.swap(next);
+  }
+  return levels;
+}
+
+//! \brief Connected components, computed by streaming every partition until labels stop changing.
+//! Each pass propagates the smallest label across every edge, in both directions, so
+//! directed graphs yield their weakly connected components. Labels are then shortcut
+//! to their own label, which keeps the number of passes close to the diameter.
+//!
+//! \param [in] graph The disk graph.
+//! \return std::vector<DiskGraph::Index> For each internal index, the smallest internal index of its component.
+inline std::vector<DiskGraph::Index> streamingComponents(const DiskGraph& graph)
+{
+  using Index = DiskGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("disk_streaming_components");
+  std::vector<Index> labels(graph.vertexCount());
+  std::iota(labels.begin(), labels.end(), Index{0});
+
+  for (bool changed = true; changed; )
+  {
+    changed = false;
+    for (size_t p = 0; p < graph.partitionCount(); p++)
+    {
+      graph.streamPartition(p, [&](Index v, std::span<const Index> row, std::span<const float>)
+      {
+        for (Index u : row)
+        {
+          const Index low = std::min(labels[v], labels[u]);
+          if (labels[v] != low) { labels[v] = low; changed = true; }
+          if (labels[u] != low) { labels[u] = low; changed = true; }
+        }
+      });
+    }
+    // A label is never larger than its vertex, so ascending order shortcuts whole chains
+    for (Index v = 0; v < labels.size(); v++) { labels[v] = labels[labels[v]]; }
+  }
+  return labels;
+}
+
+//! \brief PageRank by power iteration, streaming every partition once per iteration.
+//! Edge weights are ignored. The rank of vertices without outgoing edges is spread
+//! over every vertex.
+//!
+//! \param [in] graph The disk graph.
+//! \param [in] options The damping factor and stopping criteria.
+//! \return std::vector<double> The rank of each internal index. Ranks sum to 1.
+inline std::vector<double> streamingPageRank(const DiskGraph& graph, const PageRankOptions& options = {})
+{
+  using Index = DiskGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("disk_streaming_pagerank");
+  const size_t n = graph.vertexCount();
+  if (n == 0) { return {}; }
+
+  std::vector<double> rank(n, 1.0 / n), next(n);
+  for (unsigned iteration = 0; iteration < options.max_iterations; iteration++)
+  {
+    std::fill(next.begin(), next.end(), 0.0);
+    double dangling = 0;
+    for (size_t p = 0; p < graph.partitionCount(); p++)
+    {
+      graph.streamPartition(p, [&](Index v, std::span<const Index> row, std::span<const float>)
+      {
+        if (row.empty()) { dangling += rank[v]; return; }
+        const double share = rank[v] / row.size();
+        for (Index u : row) { next[u] += share; }
+      });
+    }
+
+    const double base = (1 - options.damping + options.damping * dangling) / n;
+    double delta = 0;
+    for (size_t v = 0; v < n; v++)
+    {
+      next[v] = base + options.damping * next[v];
+      delta += std::abs(next[v] - rank[v]);
+    }
+    rank.swap(next);
+    if (delta < options.tolerance) { break; }
+  }
+  return rank;
+}
+
+} // namespace graph_lib
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <graph_lib/graph.hpp>
+#include <graph_lib/parallel.hpp>
+#include <graph_lib/random.hpp>
+
+
+namespace graph_lib
+{
+//! \brief Distribution of the weights assigned to generated edges.
+struct WeightDistribution
+{
+  enum class Kind { Constant, Uniform, Exponential };
+
+  Kind kind = Kind::Constant;
+  float a = 1.0f;
+  float b = 1.0f;
+
+  //! \brief Every edge gets the same weight.
+  static WeightDistribution constant(float weight) { return {Kind::Constant, weight, weight}; }
+
+  //! \brief Weights drawn uniformly from [min, max).
+  static WeightDistribution uniform(float min, float max) { return {Kind::Uniform, min, max}; }
+
+  //! \brief Weights drawn from an exponential distribution with the given mean.
+  static WeightDistribution exponential(float mean) { return {Kind::Exponential, mean, mean}; }
+
+  //! \brief Map a uniform sample in [0, 1) to a weight.
+  float sample(double u) const noexcept
+  {
+    switch (kind)
+    {
+      case Kind::Uniform:     return static_cast<float>(a + (b - a) * u);
+      case Kind::Exponential: return static_cast<float>(-a * std::log1p(-u));
+      default:                return a;
+    }
+  }
+};
+
+//! \brief Options shared by all generators.
+struct GeneratorOptions
+{
+  //! \brief Seed of the counter-based RNG. The same seed always produces the same graph.
+  uint64_t seed = 0;
+
+  //! \brief Number of threads, 0 selects the hardware concurrency. Does not affect the output.
+  unsigned threads = 0;
+
+  //! \brief Distribution of the edge weights. Ignored by unweighted graphs.
+  WeightDistribution weights = WeightDistribution::constant(1.0f);
+};
+
+//! \brief Skew parameters of the R-MAT recursive matrix model.
+//! The probabilities of the four quadrants are a, b, c and 1 - a - b - c.
+struct RMatParams
+{
+  double a = 0.57;
+  double b = 0.19;
+  double c = 0.19;
+};
+
+struct GeneratedEdge
+{
+  uint64_t origin;
+  uint64_t dest;
+  float weight;
+};
+
+//! \brief A generated graph as a list of edges between vertex indices in [0, vertex_count).
+struct EdgeList
+{
+  uint64_t vertex_count = 0;
+  std::vector<GeneratedEdge> edges;
+};
+
+
+namespace detail
+{
+// RNG streams, one per independent quantity drawn for an edge
+constexpr uint64_t kTopologyStream = 0;
+constexpr uint64_t kWeightStream = 1;
+
+template <typename F>
+EdgeList generateEdges(uint64_t vertex_count, uint64_t edge_count, const GeneratorOptions& options, F&& endpoints)
+{
+  EdgeList list{vertex_count, std::vector<GeneratedEdge>(edge_count)};
+  const CounterRng weights(options.seed, kWeightStream);
+
+  parallelFor(0, edge_count, options.threads, [&](size_t i)
+  {
+    auto [origin, dest] = endpoints(static_cast<uint64_t>(i));
+    list.edges[i] = {origin, dest, options.weights.sample(weights.uniform(i))};
+  });
+  return list;
+}
+} // namespace detail
+
+
+//! \brief Generate an R-MAT graph.
+//! Self loops and duplicate edges are possible and are dropped when the graph is built.
+//!
+//! \param [in] scale The graph has 2^scale vertices.
+//! \param [in] edge_count The number of edges to sample.
+//! \param [in] params The quadrant probabilities controlling the degree skew.
+//! \param [in] options The seed, thread count and weight distribution.
+//! \return EdgeList The generated edges.
+inline EdgeList rmatEdges(unsigned scale, uint64_t edge_count, RMatParams params = {}, const GeneratorOptions& options = {})
+{
+  const CounterRng rng(options.seed, detail::kTopologyStream);
+  const double ab = params.a + params.b;
+  const double abc = ab + params.c;
+
+  return detail::generateEdges(uint64_t{1} << scale, edge_count, options, [&](uint64_t i)
+  {
+    uint64_t origin = 0, dest = 0;
+    for (unsigned level = 0; level < scale; level++)
+    {
+      const double u = rng.uniform(i * scale + level);
+      origin = (origin << 1) | (u >= ab ? 1 : 0);
+      dest = (dest << 1) | ((u >= params.a && u < ab) || u >= abc ? 1 : 0);
+    }
+    return std::pair{origin, dest};
+  });
+}
+
+//! \brief Generate an Erdős–Rényi G(n, m) graph.
+//! Edges are sampled uniformly with replacement and never form self loops.
+//!
+//! \param [in] vertex_count The number of vertices, at least 2.
+//! \param [in] edge_count The number of edges to sample.
+//! \param [in] options The seed, thread count and weight distribution.
+//! \return EdgeList The generated edges.
+inline EdgeList erdosRenyiEdges(uint64_t vertex_count, uint64_t edge_count, const GeneratorOptions& options = {})
+{
+  if (vertex_count < 2) { throw std::invalid_argument("Erdos-Renyi graphs need at least 2 vertices"); }
+  const CounterRng rng(options.seed, detail::kTopologyStream);
+
+  return detail::generateEdges(vertex_count, edge_count, options, [&](uint64_t i)
+  {
+    const uint64_t origin = rng.below(i, vertex_count, 0);
+    const uint64_t dest = (origin + 1 + rng.below(i, vertex_count - 1, 1)) % vertex_count;
+    return std::pair{origin, dest};
+  });
+}
+
+//! \brief Generate a Barabási–Albert preferential attachment graph.
+//! Vertex v > 0 attaches edges_per_vertex edges to earlier vertices. Targets are
+//! resolved with the Batagelj–Brandes edge copy model, which only depends on the
+//! edge index and can therefore be computed for every edge in parallel.
+//!
+//! \param [in] vertex_count The number of vertices.
+//! \param [in] edges_per_vertex The number of edges attached by each new vertex.
+//! \param [in] options The seed, thread count and weight distribution.
+//! \return EdgeList The generated edges.
+inline EdgeList barabasiAlbertEdges(uint64_t vertex_count, unsigned edges_per_vertex, const GeneratorOptions& options = {})
+{
+  if (edges_per_vertex == 0) { throw std::invalid_argument("Barabasi-Albert graphs need at least 1 edge per vertex"); }
+  const CounterRng rng(options.seed, detail::kTopologyStream);
+  const uint64_t m = edges_per_vertex;
+  const uint64_t edge_count = vertex_count > 1 ? (vertex_count - 1) * m : 0;
+
+  return detail::generateEdges(vertex_count, edge_count, options, [&](uint64_t i)
+  {
+    // Endpoint position 0 is vertex 0, position 2j + 1 is the origin of edge j and
+    // position 2j + 2 is the target of edge j. Pick a uniform position among the
+    // edges of earlier vertices and follow target positions back until an origin
+    // is reached. Positions of the vertex's own edges are excluded, since copying
+    // one would attach the vertex to itself.
+    uint64_t edge = i;
+    while (true)
+    {
+      const uint64_t pos = rng.below(edge, 2 * (edge / m) * m + 1);
+      if (pos == 0) { return std::pair{1 + i / m, uint64_t{0}}; }
+      if (pos % 2 == 1) { return std::pair{1 + i / m, 1 + (pos - 1) / 2 / m}; }
+      edge = (pos - 2) / 2;
+    }
+  });
+}
+
+//! \brief Generate a 2D grid graph.
+//! Vertex (r, c) has index r * cols + c and is connected to its right and lower neighbour.
+//!
+//! \param [in] rows The number of rows.
+//! \param [in] cols The number of columns.
+//! \param [in] options The seed, thread count and weight distribution.
+//! \return EdgeList The generated edges.
+inline EdgeList gridEdges(uint64_t rows, uint64_t cols, const GeneratorOptions& options = {})
+{
+  const uint64_t horizontal = rows * (cols > 0 ? cols - 1 : 0);
+  const uint64_t vertical = (rows > 0 ? rows - 1 : 0) * cols;
+
+  return detail::generateEdges(rows * cols, horizontal + vertical, options, [&](uint64_t i)
+  {
+    if (i < horizontal)
+    {
+      const uint64_t r = i / (cols - 1), c = i % (cols - 1);
+      return std::pair{r * cols + c, r * cols + c + 1};
+    }
+    const uint64_t v = i - horizontal;
+    return std::pair{v, v + cols};
+  });
+}
+
+//! \brief Build a graph from a generated edge list.
+//! Vertex index i stores value(i). Duplicate edges are skipped.
+//!
+//! \param [in] list The generated edges.
+//! \param [in] value Callable mapping a vertex index to the value stored in the vertex.
+//! \exception std::invalid_argument Thrown when value returns the same value for two indices.
+//! \return G The graph containing the generated vertices and edges.
+template <typename G, typename F>
+G buildGraph(const EdgeList& list, F&& value)
+{
+  G graph;
+  std::vector<unsigned int> ids;
+  ids.reserve(list.vertex_count);
+  for (uint64_t i = 0; i < list.vertex_count; i++)
+  {
+    auto id = graph.addVertex(value(i));
+    if (!id.has_value()) { throw std::invalid_argument("Generated vertex values must be unique"); }
+    ids.push_back(*id);
+  }
+
+  for (const auto& edge : list.edges)
+  {
+    if constexpr (G::is_weighted)
+    {
+      graph.addEdge(ids[edge.origin], ids[edge.dest], edge.weight);
+    }
+    else
+    {
+      graph.addEdge(ids[edge.origin], ids[edge.dest]);
+    }
+  }
+  return graph;
+}
+
+//! \brief Build a graph from a generated edge list, storing the vertex index as the value.
+template <typename G> requires std::integral<typename G::ValueType>
+G buildGraph(const EdgeList& list)
+{
+  return buildGraph<G>(list, [](uint64_t i) { return static_cast<typename G::ValueType>(i); });
+}
+
+} // namespace graph_lib
@@ -1,12 +1,17 @@
 #pragma once
 
-#include <exception>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <ranges>
+#include <unordered_map>
 #include <unordered_set>
 
+#include <graph_lib/instrumentation.hpp>
 #include <graph_lib/iterators.hpp>
+#include <graph_lib/journal.hpp>
+#include <graph_lib/memory.hpp>
+#include <graph_lib/ranges.hpp>
 #include <graph_lib/vertex.hpp>
 
 
@@ -16,18 +21,83 @@ template <typename T> requires Graphable<T>
 class Graph
 {
 public:
+  using ValueType = T;
   using VertexPtr = std::shared_ptr<Vertex<T>>;
-  using VertexSet = std::unordered_set<VertexPtr, VertexPtrHash<T>, VertexPtrCompare<T>>;
+  using VertexSet = VertexPtrSet<T>;
+  using VertexIndex = std::unordered_map<unsigned int, VertexPtr, std::hash<unsigned int>, std::equal_to<unsigned int>,
+                                         TrackingAllocator<std::pair<const unsigned int, VertexPtr>>>;
 
 public:
+  //! \brief Copy a graph. The copy shares the vertices but charges its own containers
+  //! to a new account, so its memory usage does not move with the original's.
+  //! The journal is not copied: the copy starts with an empty journal that is not
+  //! recording, so copying costs nothing per recorded insert. Iterators copy the graph.
+  Graph(const Graph& other)
+  {
+    vertices_ = other.vertices_;
+    index_ = other.index_;
+  }
+
+  Graph(Graph&&) = default;
+
+  //! \brief Copy a graph's contents. The containers keep their allocators, bound to this graph's account.
+  //! As with a copy, the journal is not copied: this graph's journal stops recording and is released.
+  Graph& operator=(const Graph& other)
+  {
+    if (this == &other) { return *this; }
+    journal_.stop();
+    vertices_ = other.vertices_;
+    index_ = other.index_;
+    return *this;
+  }
+
+  Graph& operator=(Graph&&) = default;
+
   GraphIterator<T> begin() { return GraphIterator<T>(new BasicGraphIterator(*this)); }
   GraphIterator<T> end() { return GraphIterator<T>(new BasicGraphIterator(*this, this->vertices_.size())); }
 
-  virtual GraphIterator<T> dfs_begin() { throw std::exception(); };
-  virtual GraphIterator<T> dfs_end() { throw std::exception(); };
+  GraphIterator<T> dfs_begin() { return GraphIterator<T>(new DFSIterator<T>(*this)); }
+  GraphIterator<T> dfs_end() { return GraphIterator<T>(new DFSIterator<T>(*this, this->vertices_.size())); }
 
-  virtual GraphIterator<T> bfs_begin() { throw std::exception(); };
-  virtual GraphIterator<T> bfs_end() { throw std::exception(); };
+  GraphIterator<T> bfs_begin() { return GraphIterator<T>(new BFSIterator<T>(*this)); }
+  GraphIterator<T> bfs_end() { return GraphIterator<T>(new BFSIterator<T>(*this, this->vertices_.size())); }
+
+  //! \brief Get a view of every vertex in the graph.
+  std::ranges::ref_view<const VertexSet> vertices() const noexcept { return std::views::all(vertices_); }
+
+  //! \brief Get a view of the vertices adjacent to a vertex.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return NeighborView<T> The adjacent vertices, empty if the vertex is not in the graph.
+  NeighborView<T> neighbors(const unsigned int& id) const noexcept
+  {
+    static const typename Vertex<T>::AdjacencySet empty;
+    auto vertex = getVertex(id);
+    return NeighborView<T>(vertex.has_value() ? (**vertex).adj : empty, EdgeTarget<T>());
+  }
+
+  //! \brief Get the number of edges leaving a vertex.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return std::optional<size_t> The out degree, or no value if the vertex is not in the graph.
+  std::optional<size_t> outDegree(const unsigned int& id) const noexcept
+  {
+    auto vertex = getVertex(id);
+    if (!vertex.has_value()) { return {}; }
+    return (**vertex).adj.size();
+  }
+
+  //! \brief Get a lazy depth first traversal of the vertices reachable from a vertex.
+  //!
+  //! \param [in] source_id The ID of the vertex to start from.
+  //! \return DFSView<T> The traversal, empty if the vertex is not in the graph.
+  DFSView<T> dfs(const unsigned int& source_id) const { return DFSView<T>(getVertex(source_id).value_or(nullptr)); }
+
+  //! \brief Get a lazy breadth first traversal of the vertices reachable from a vertex.
+  //!
+  //! \param [in] source_id The ID of the vertex to start from.
+  //! \return BFSView<T> The traversal, empty if the vertex is not in the graph.
+  BFSView<T> bfs(const unsigned int& source_id) const { return BFSView<T>(getVertex(source_id).value_or(nullptr)); }
 
   //! \brief Get the number of vertices in the graph.
   //!
@@ -37,17 +107,39 @@ public:
   //! \brief Add a vertex to the graph.
   //!
   //! \param [in] value The value to store in the new vertex.
-  //! \return true If the vertex is successfully added.
-  //! \return false If the vertex is not successfully added.
+  //! \return std::optional<unsigned int> The ID of the new vertex, empty if the value is already
+  //! in the graph or the vertex could not be stored (an allocation or a copy of the value threw).
+  //! The graph is unchanged in that case.
   std::optional<unsigned int> addVertex(const T& value) noexcept
   {
     // If the vertex already exists, return false
+    GRAPH_LIB_COUNT(HashLookups, 1);
     if (vertices_.contains(value)) { return {}; }
 
-    // Add the vertex to the graph
-    auto [vertex, success] = vertices_.emplace(new Vertex<T>(value));
-    if (!success) { return {}; }
-    return (**vertex).getID();
+    // Add the vertex to the graph. Each step inserts one element or nothing,
+    // so undoing the steps that completed restores the graph
+    GRAPH_LIB_COUNT(HashLookups, 2);
+    GRAPH_LIB_COUNT(Allocations, 1);
+    GRAPH_LIB_COUNT(BytesAllocated, sizeof(T));
+    unsigned int id = 0;
+    try
+    {
+      journal_.reserveNext();
+      auto [vertex, success] = vertices_.emplace(std::allocate_shared<Vertex<T>>(
+        TrackingAllocator<Vertex<T>>(memory_, MemoryCategory::VertexTable), value,
+        typename Vertex<T>::AdjacencyAllocator(memory_, MemoryCategory::AdjacencyBuckets)));
+      if (!success) { return {}; }
+      id = (**vertex).getID();
+      try { index_.emplace(id, *vertex); }
+      catch (...)
+      {
+        vertices_.erase(vertex);
+        throw;
+      }
+    }
+    catch (...) { return {}; }
+    journal_.recordVertex(id);
+    return id;
   }
 
   //! \brief Get a const reference to the vertex with the specified value.
@@ -57,10 +149,79 @@ public:
   //! \return std::optional<const Vertex<T>> An optional of the vertex that contains the value specified.
   std::optional<VertexPtr> getVertex(const unsigned int& id) const noexcept
   {
-    for (auto v : vertices_) { if ((*v).getID() == id) { return v; } }
-    return {};
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    auto vertex = index_.find(id);
+    if (vertex == index_.end()) { return {}; }
+    return vertex->second;
+  }
+
+  //! \brief Find the ID of the vertex storing a value.
+  //!
+  //! \param [in] value The value to look up.
+  //! \return std::optional<unsigned int> The ID of the vertex, or no value if no vertex stores the value.
+  std::optional<unsigned int> findVertex(const T& value) const noexcept
+  {
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    auto vertex = vertices_.find(value);
+    if (vertex == vertices_.end()) { return {}; }
+    return (**vertex).getID();
+  }
+
+  //! \brief Get the set of vertices in the graph.
+  const VertexSet& getVertices() const noexcept { return vertices_; }
+
+  //! \brief Call a function for every vertex in the graph.
+  //!
+  //! \param [in] fn Callable invoked as fn(const VertexPtr& vertex).
+  template <typename F>
+  void forEachVertex(F&& fn) const
+  {
+    for (const auto& vertex : vertices_) { fn(vertex); }
+  }
+
+  //! \brief Call a function for every edge leaving a vertex.
+  //! Unweighted edges report a weight of 0.
+  //!
+  //! \param [in] vertex The vertex whose edges are visited.
+  //! \param [in] fn Callable invoked as fn(const VertexPtr& dest, float weight).
+  template <typename F>
+  void forEachNeighbor(const Vertex<T>& vertex, F&& fn) const
+  {
+    for (const auto& edge : vertex.adj) { fn((*edge).vertex, (*edge).weight); }
   }
 
+  //! \brief Get the memory used by the graph.
+  //! Containers are measured by tracking allocators. Payloads and edges are
+  //! fixed-size allocations and are counted from the vertex and edge counts.
+  //! Vertices shared with a copy of the graph are charged to the original graph.
+  //!
+  //! \return MemoryUsage The bytes used by the graph, broken down by category.
+  MemoryUsage memoryUsage() const noexcept
+  {
+    MemoryUsage usage = memory_ ? memory_->usage() : MemoryUsage{};
+    for (const auto& vertex : vertices_)
+    {
+      usage.payloads += payloadBytes(*(*vertex).data);
+      usage.edge_nodes += (*vertex).adj.size() * sizeof(Edge<T>);
+    }
+    return usage;
+  }
+
+  //! \brief Start recording vertex and edge inserts in the journal.
+  //! Inserts made before are not in the journal, so results computed earlier cannot be updated from it.
+  void enableJournal() noexcept { journal_.start(); }
+
+  //! \brief Stop recording inserts and release the journal.
+  void disableJournal() noexcept { journal_.stop(); }
+
+  //! \brief Get the journal of the inserts made to the graph.
+  const ChangeJournal& journal() const noexcept { return journal_; }
+
+  //! \brief Release the journal entries before a position, once every consumer has read them.
+  //!
+  //! \param [in] sequence The sequence number of the first entry to keep.
+  void discardJournalBefore(uint64_t sequence) { journal_.discardBefore(sequence); }
+
   //! \brief Whether or not the graph is cyclic.
   //! \return true If the graph is cyclic.
   //! \return false If the graph is not cyclic.
@@ -72,24 +233,19 @@ public:
 protected:
   Graph() = default;
 
-  //! \brief The set of vertices in the graph.
-  VertexSet vertices_;
+  //! \brief The account charged by the allocators of the graph's containers.
+  std::shared_ptr<MemoryAccount> memory_ = std::make_shared<MemoryAccount>();
 
-  friend struct GraphIteratorBase<T>;
-};
+  //! \brief The inserts made while recording.
+  ChangeJournal journal_{ChangeJournal::Allocator(memory_, MemoryCategory::AuxiliaryIndexes)};
 
-template <typename T> requires Graphable<T>
-class UnweightedGraph : public Graph<T>
-{
-public:
-  virtual bool addEdge(const unsigned int& origin_id, const unsigned int& dest_id) noexcept = 0;
-};
+  //! \brief The set of vertices in the graph.
+  VertexSet vertices_{TrackingAllocator<VertexPtr>(memory_, MemoryCategory::VertexTable)};
 
-template <typename T> requires Graphable<T>
-class WeightedGraph : public Graph<T>
-{
-public:
-  virtual bool addEdge(const unsigned int& origin_id, const unsigned int& dest_id, float weight) noexcept = 0;
+  //! \brief The vertices in the graph indexed by their ID.
+  VertexIndex index_{typename VertexIndex::allocator_type(memory_, MemoryCategory::AuxiliaryIndexes)};
+
+  friend struct GraphIteratorBase<T>;
 };
 
 } // namespace graph_lib
\ No newline at end of file
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/iterators.hpp>
+#include <graph_lib/vertex.hpp>
+
+
+namespace graph_lib
+{
+//! \brief Set of vertex IDs stored as one bit per ID.
+class VertexBitmap
+{
+public:
+  VertexBitmap() = default;
+
+  //! \brief Construct an empty bitmap with room for IDs below capacity.
+  explicit VertexBitmap(size_t capacity): words_((capacity + 63) / 64, 0) {}
+
+  void set(unsigned int id)
+  {
+    if (id / 64 >= words_.size()) { words_.resize(id / 64 + 1, 0); }
+    words_[id / 64] |= uint64_t{1} << (id % 64);
+  }
+
+  void reset(unsigned int id) noexcept
+  {
+    if (id / 64 < words_.size()) { words_[id / 64] &= ~(uint64_t{1} << (id % 64)); }
+  }
+
+  bool test(unsigned int id) const noexcept
+  {
+    return id / 64 < words_.size() && (words_[id / 64] >> (id % 64)) & 1;
+  }
+
+private:
+  std::vector<uint64_t> words_;
+};
+
+//! \brief Vertex predicate accepting every vertex.
+struct AcceptVertices
+{
+  template <typename T>
+  constexpr bool operator()(const Vertex<T>&) const noexcept { return true; }
+};
+
+//! \brief Edge predicate accepting every edge.
+struct AcceptEdges
+{
+  template <typename T>
+  constexpr bool operator()(const Vertex<T>&, const Vertex<T>&, float) const noexcept { return true; }
+};
+
+//! \brief Vertex predicate accepting the vertices whose ID is set in a bitmap.
+struct BitmapPredicate
+{
+  const VertexBitmap* bitmap;
+
+  template <typename T>
+  bool operator()(const Vertex<T>& vertex) const noexcept { return bitmap->test(vertex.getID()); }
+};
+
+
+template <typename View>
+class ViewTraversalIterator;
+
+//! \brief Lazily filtered view of a graph.
+//! Nothing is copied: the predicates are applied while the view is traversed.
+//! A vertex is visible when the vertex predicate accepts it, and an edge is visible
+//! when both endpoints are visible and the edge predicate accepts it. Views can be
+//! nested and are accepted by every algorithm taking a TraversableGraph. The view
+//! must not outlive the graph it refers to.
+//!
+//! \tparam G The viewed graph or view.
+//! \tparam VertexPredicate Callable as bool(const Vertex<T>& vertex).
+//! \tparam EdgePredicate Callable as bool(const Vertex<T>& origin, const Vertex<T>& dest, float weight).
+template <typename G, typename VertexPredicate, typename EdgePredicate> requires TraversableGraph<G>
+class FilteredGraph
+{
+public:
+  using ValueType = typename G::ValueType;
+  using VertexPtr = typename G::VertexPtr;
+  using VertexSet = std::remove_cvref_t<decltype(std::declval<const G&>().getVertices())>;
+  using Iterator = ViewTraversalIterator<FilteredGraph>;
+
+  static constexpr bool is_directed = G::is_directed;
+  static constexpr bool is_weighted = G::is_weighted;
+
+  FilteredGraph(const G& graph, VertexPredicate vertex_predicate, EdgePredicate edge_predicate):
+    graph_(graph), vertex_predicate_(std::move(vertex_predicate)), edge_predicate_(std::move(edge_predicate))
+  {}
+
+  Iterator begin() const { return Iterator(*this, std::nullopt); }
+  Iterator end() const { return Iterator(); }
+
+  Iterator dfs_begin() const { return Iterator(*this, TraversalOrder::DepthFirst); }
+  Iterator dfs_end() const { return Iterator(); }
+
+  Iterator bfs_begin() const { return Iterator(*this, TraversalOrder::BreadthFirst); }
+  Iterator bfs_end() const { return Iterator(); }
+
+  //! \brief Whether a vertex of the underlying graph is visible in the view.
+  bool acceptsVertex(const Vertex<ValueType>& vertex) const
+  {
+    if constexpr (requires { graph_.acceptsVertex(vertex); })
+    {
+      if (!graph_.acceptsVertex(vertex)) { return false; }
+    }
+    return vertex_predicate_(vertex);
+  }
+
+  //! \brief Get the unfiltered vertex set of the underlying graph.
+  const VertexSet& getVertices() const noexcept { return graph_.getVertices(); }
+
+  //! \brief Get the number of visible vertices. Linear in the size of the underlying graph.
+  size_t getSize() const
+  {
+    size_t count = 0;
+    forEachVertex([&count](const VertexPtr&) { count++; });
+    return count;
+  }
+
+  //! \brief Get the vertex with the specified ID if it is visible.
+  std::optional<VertexPtr> getVertex(const unsigned int& id) const
+  {
+    auto vertex = graph_.getVertex(id);
+    if (!vertex.has_value() || !vertex_predicate_(**vertex)) { return {}; }
+    return vertex;
+  }
+
+  template <typename F>
+  void forEachVertex(F&& fn) const
+  {
+    graph_.forEachVertex([&](const VertexPtr& vertex) { if (vertex_predicate_(*vertex)) { fn(vertex); } });
+  }
+
+  template <typename F>
+  void forEachNeighbor(const Vertex<ValueType>& vertex, F&& fn) const
+  {
+    graph_.forEachNeighbor(vertex, [&](const VertexPtr& dest, float weight)
+    {
+      if (vertex_predicate_(*dest) && edge_predicate_(vertex, *dest, weight)) { fn(dest, weight); }
+    });
+  }
+
+private:
+  const G& graph_;
+  VertexPredicate vertex_predicate_;
+  EdgePredicate edge_predicate_;
+};
+
+//! \brief Iterator over the visible vertices of a view.
+//! Without an order the vertices are listed in storage order. With an order the
+//! whole view is traversed depth or breadth first, restarting from the next
+//! unvisited vertex whenever the frontier drains. Every vertex is returned once.
+template <typename View>
+class ViewTraversalIterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using difference_type   = std::ptrdiff_t;
+  using value_type        = typename View::VertexPtr;
+  using pointer           = value_type const*;
+  using reference         = value_type const&;
+
+  //! \brief Construct the end iterator.
+  ViewTraversalIterator() = default;
+
+  ViewTraversalIterator(const View& view, std::optional<TraversalOrder> order):
+    view_(&view), order_(order), root_(view.getVertices().begin()), root_end_(view.getVertices().end())
+  {
+    increment();
+  }
+
+  reference operator*() const { return current_; }
+  pointer operator->() const { return &current_; }
+
+  ViewTraversalIterator& operator++() { increment(); return *this; }
+  ViewTraversalIterator operator++(int) { auto tmp = *this; increment(); return tmp; }
+
+  bool operator==(const ViewTraversalIterator& rhs) const { return current_ == rhs.current_; }
+
+private:
+  const View* view_ = nullptr;
+  std::optional<TraversalOrder> order_;
+  typename View::VertexSet::const_iterator root_;
+  typename View::VertexSet::const_iterator root_end_;
+  std::unordered_set<const Vertex<typename View::ValueType>*> visited_;
+  std::deque<value_type> frontier_;
+  value_type current_;
+
+  //! \brief Get the next visible vertex of the underlying storage that was not visited yet.
+  value_type nextRoot()
+  {
+    for (; root_ != root_end_; ++root_)
+    {
+      if (view_->acceptsVertex(**root_) && !visited_.contains(&**root_)) { return *root_++; }
+    }
+    return nullptr;
+  }
+
+  void increment()
+  {
+    current_ = nullptr;
+    if (!order_.has_value()) { current_ = nextRoot(); return; }
+
+    if (*order_ == TraversalOrder::DepthFirst)
+    {
+      // Vertices are marked when popped, so stale stack entries are skipped here
+      while (!frontier_.empty() && visited_.contains(&*frontier_.back())) { frontier_.pop_back(); }
+      if (frontier_.empty()) { frontier_.push_back(nextRoot()); }
+      if (frontier_.back() == nullptr) { frontier_.clear(); return; }
+
+      current_ = frontier_.back();
+      frontier_.pop_back();
+      visited_.insert(&*current_);
+      view_->forEachNeighbor(*current_, [&](const value_type& dest, float)
+      {
+        if (!visited_.contains(&*dest)) { frontier_.push_back(dest); }
+      });
+    }
+    else
+    {
+      // Vertices are marked when queued, so each one is queued once
+      if (frontier_.empty())
+      {
+        auto root = nextRoot();
+        if (root == nullptr) { return; }
+        visited_.insert(&*root);
+        frontier_.push_back(root);
+      }
+
+      current_ = frontier_.front();
+      frontier_.pop_front();
+      view_->forEachNeighbor(*current_, [&](const value_type& dest, float)
+      {
+        if (visited_.insert(&*dest).second) { frontier_.push_back(dest); }
+      });
+    }
+  }
+};
+
+
+//! \brief View of the vertices of a graph accepted by a predicate, and the edges between them.
+template <typename G, typename VertexPredicate> requires TraversableGraph<G>
+FilteredGraph<G, VertexPredicate, AcceptEdges> filterVertices(const G& graph, VertexPredicate predicate)
+{
+  return {graph, std::move(predicate), AcceptEdges()};
+}
+
+//! \brief View of the edges of a graph accepted by a predicate. Every vertex stays visible.
+template <typename G, typename EdgePredicate> requires TraversableGraph<G>
+FilteredGraph<G, AcceptVertices, EdgePredicate> filterEdges(const G& graph, EdgePredicate predicate)
+{
+  return {graph, AcceptVertices(), std::move(predicate)};
+}
+
+//! \brief View of the subgraph induced by the vertex IDs set in a bitmap.
+//! The bitmap is referenced, not copied, and must outlive the view.
+template <typename G> requires TraversableGraph<G>
+FilteredGraph<G, BitmapPredicate, AcceptEdges> inducedSubgraph(const G& graph, const VertexBitmap& vertices)
+{
+  return {graph, BitmapPredicate{&vertices}, AcceptEdges()};
+}
+
+} // namespace graph_lib
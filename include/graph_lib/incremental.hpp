@@ -0,0 +1,548 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/journal.hpp>
+
+
+namespace graph_lib
+{
+//! \brief A graph that records its inserts in a ChangeJournal.
+template <typename G>
+concept JournaledGraph = TraversableGraph<G> && requires(const G& g) {
+  { g.journal() } -> std::convertible_to<const ChangeJournal&>;
+};
+
+//! \brief What an incremental algorithm did to bring its result up to date.
+struct IncrementalUpdate
+{
+  //! \brief The number of journal entries read.
+  size_t mutations = 0;
+  //! \brief The number of vertices whose result was changed or re-examined.
+  size_t vertices_updated = 0;
+  //! \brief Whether the result was computed from scratch because the journal did not cover it.
+  bool recomputed = false;
+};
+
+namespace detail
+{
+//! \brief Read the journal of a graph from a position and move the position to its end.
+//! Returns false, leaving the position alone, when the journal does not cover it.
+template <typename G, typename F>
+bool consumeJournal(const G& graph, uint64_t& position, size_t& mutations, F&& fn)
+{
+  const ChangeJournal& journal = graph.journal();
+  if (!journal.covers(position)) { return false; }
+  for (const Mutation& mutation : journal.since(position))
+  {
+    fn(mutation);
+    mutations++;
+  }
+  position = journal.head();
+  return true;
+}
+} // namespace detail
+
+
+//! \brief Hop counts from a source vertex, kept up to date as edges are added.
+//! An insert can only shorten paths, so an update relaxes the new edges and
+//! spreads the improvements breadth first from their destinations, touching
+//! only the vertices whose level drops. The graph must outlive the object.
+//!
+//! \tparam G A graph recording a journal. Edges count in both directions on undirected graphs.
+template <typename G> requires JournaledGraph<G>
+class IncrementalBfs
+{
+public:
+  using VertexPtr = typename G::VertexPtr;
+
+  //! \brief Compute the levels from a source.
+  //!
+  //! \param [in] graph The graph. Recording must be enabled for updates to be incremental.
+  //! \param [in] source_id The ID of the source. A missing source reaches nothing until it is added.
+  IncrementalBfs(const G& graph, unsigned int source_id):
+    graph_(&graph), source_(source_id)
+  {
+    recompute();
+  }
+
+  //! \brief Apply the inserts recorded since the last update.
+  //! Recomputes from scratch when the journal no longer covers the last update.
+  IncrementalUpdate update()
+  {
+    GRAPH_LIB_SCOPED_TIMER("incremental_bfs_update");
+    IncrementalUpdate result;
+    const bool covered = detail::consumeJournal(*graph_, position_, result.mutations, [&](const Mutation& mutation)
+    {
+      if (mutation.kind == MutationKind::AddVertex)
+      {
+        if (mutation.origin == source_ && !levels_.contains(source_)) { lower(source_, 0); }
+        return;
+      }
+      relax(mutation.origin, mutation.dest);
+      if constexpr (!G::is_directed) { relax(mutation.dest, mutation.origin); }
+    });
+    if (!covered)
+    {
+      recompute();
+      result.vertices_updated = levels_.size();
+      result.recomputed = true;
+      return result;
+    }
+    result.vertices_updated = propagate();
+    return result;
+  }
+
+  //! \brief Get the number of edges on a shortest path from the source.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return std::optional<unsigned> The level, or no value if the vertex is not reached.
+  std::optional<unsigned> level(unsigned int id) const noexcept
+  {
+    auto entry = levels_.find(id);
+    if (entry == levels_.end()) { return {}; }
+    return entry->second;
+  }
+
+  //! \brief The level of every reached vertex, by ID.
+  const std::unordered_map<unsigned int, unsigned>& levels() const noexcept { return levels_; }
+
+  //! \brief Discard the levels and compute them again from the current graph.
+  void recompute()
+  {
+    GRAPH_LIB_SCOPED_TIMER("incremental_bfs_recompute");
+    levels_.clear();
+    queue_.clear();
+    position_ = graph_->journal().head();
+    if (graph_->getVertex(source_).has_value()) { lower(source_, 0); }
+    propagate();
+  }
+
+private:
+  //! \brief Give a vertex a level, if it improves it, and queue it to spread the improvement.
+  void lower(unsigned int id, unsigned level)
+  {
+    auto [entry, inserted] = levels_.try_emplace(id, level);
+    if (!inserted)
+    {
+      if (entry->second <= level) { return; }
+      entry->second = level;
+    }
+    queue_.push_back(id);
+  }
+
+  void relax(unsigned int origin_id, unsigned int dest_id)
+  {
+    auto origin = levels_.find(origin_id);
+    if (origin != levels_.end()) { lower(dest_id, origin->second + 1); }
+  }
+
+  //! \brief Spread the queued improvements. Returns the number of vertices expanded.
+  size_t propagate()
+  {
+    size_t expanded = 0;
+    while (!queue_.empty())
+    {
+      const unsigned int id = queue_.front();
+      queue_.pop_front();
+      auto vertex = graph_->getVertex(id);
+      if (!vertex.has_value()) { continue; }
+      const unsigned next = levels_.at(id) + 1;
+      expanded++;
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+      graph_->forEachNeighbor(**vertex, [&](const VertexPtr& dest, float)
+      {
+        GRAPH_LIB_COUNT(EdgesScanned, 1);
+        lower((*dest).getID(), next);
+      });
+    }
+    return expanded;
+  }
+
+  const G* graph_;
+  unsigned int source_;
+  uint64_t position_ = 0;
+  std::unordered_map<unsigned int, unsigned> levels_;
+  std::deque<unsigned int> queue_;
+};
+
+
+//! \brief Connected components, kept up to date as vertices and edges are added.
+//! Components are kept in a union-find forest, so an update costs a near constant
+//! time per insert. Directed edges are treated as undirected, giving weakly
+//! connected components. The graph must outlive the object.
+//!
+//! \tparam G A graph recording a journal.
+template <typename G> requires JournaledGraph<G>
+class IncrementalComponents
+{
+public:
+  using VertexPtr = typename G::VertexPtr;
+
+  //! \brief Compute the components of a graph.
+  //!
+  //! \param [in] graph The graph. Recording must be enabled for updates to be incremental.
+  explicit IncrementalComponents(const G& graph):
+    graph_(&graph)
+  {
+    recompute();
+  }
+
+  //! \brief Apply the inserts recorded since the last update.
+  //! Recomputes from scratch when the journal no longer covers the last update.
+  IncrementalUpdate update()
+  {
+    GRAPH_LIB_SCOPED_TIMER("incremental_components_update");
+    IncrementalUpdate result;
+    const bool covered = detail::consumeJournal(*graph_, position_, result.mutations, [&](const Mutation& mutation)
+    {
+      if (mutation.kind == MutationKind::AddVertex) { result.vertices_updated += add(mutation.origin); return; }
+      add(mutation.origin);
+      add(mutation.dest);
+      result.vertices_updated += merge(mutation.origin, mutation.dest);
+    });
+    if (!covered)
+    {
+      recompute();
+      result.vertices_updated = parent_.size();
+      result.recomputed = true;
+    }
+    return result;
+  }
+
+  //! \brief Get the representative of the component of a vertex.
+  //! Two vertices are connected exactly when their representatives are equal.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return std::optional<unsigned int> The ID of the representative, or no value if the vertex is not known.
+  std::optional<unsigned int> component(unsigned int id) const noexcept
+  {
+    if (!parent_.contains(id)) { return {}; }
+    return find(id);
+  }
+
+  //! \brief Whether two vertices are in the same component.
+  bool connected(unsigned int a, unsigned int b) const noexcept
+  {
+    auto first = component(a);
+    return first.has_value() && first == component(b);
+  }
+
+  //! \brief The number of components.
+  size_t componentCount() const noexcept { return count_; }
+
+  //! \brief Discard the components and compute them again from the current graph.
+  void recompute()
+  {
+    GRAPH_LIB_SCOPED_TIMER("incremental_components_recompute");
+    parent_.clear();
+    size_.clear();
+    count_ = 0;
+    position_ = graph_->journal().head();
+    graph_->forEachVertex([&](const VertexPtr& vertex) { add((*vertex).getID()); });
+    graph_->forEachVertex([&](const VertexPtr& vertex)
+    {
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+      graph_->forEachNeighbor(*vertex, [&](const VertexPtr& dest, float)
+      {
+        GRAPH_LIB_COUNT(EdgesScanned, 1);
+        merge((*vertex).getID(), (*dest).getID());
+      });
+    });
+  }
+
+private:
+  //! \brief Make a vertex a component of its own. Returns whether it was new.
+  bool add(unsigned int id)
+  {
+    if (!parent_.try_emplace(id, id).second) { return false; }
+    size_.emplace(id, 1);
+    count_++;
+    return true;
+  }
+
+  //! \brief Find the root of a vertex, halving the path on the way.
+  unsigned int find(unsigned int id) const noexcept
+  {
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    while (true)
+    {
+      auto& parent = parent_.find(id)->second;
+      if (parent == id) { return id; }
+      auto& grandparent = parent_.find(parent)->second;
+      parent = grandparent;
+      id = grandparent;
+    }
+  }
+
+  //! \brief Join the components of two vertices, the smaller under the larger. Returns whether they were apart.
+  bool merge(unsigned int a, unsigned int b)
+  {
+    a = find(a);
+    b = find(b);
+    if (a == b) { return false; }
+    if (size_.at(a) < size_.at(b)) { std::swap(a, b); }
+    parent_.at(b) = a;
+    size_.at(a) += size_.at(b);
+    size_.erase(b);
+    count_--;
+    return true;
+  }
+
+  const G* graph_;
+  uint64_t position_ = 0;
+  //! \brief The union-find forest. Lookups compress paths, so it changes under const access.
+  mutable std::unordered_map<unsigned int, unsigned int> parent_;
+  //! \brief The number of vertices under each root.
+  std::unordered_map<unsigned int, size_t> size_;
+  size_t count_ = 0;
+};
+
+
+struct IncrementalPageRankOptions
+{
+  //! \brief The probability of following an edge rather than jumping to a random vertex.
+  double damping = 0.85;
+  //! \brief The residual, relative to an average rank, below which a vertex is not pushed.
+  //! The ranks are within tolerance / (1 - damping) of the exact ranks in L1 norm.
+  double tolerance = 1e-7;
+};
+
+//! \brief PageRank, kept up to date as vertices and edges are added.
+//! Ranks are computed by pushing residuals: every vertex holds an estimate and
+//! a residual, the rank still to be spread through it, and a vertex whose
+//! residual exceeds the tolerance moves it into its estimate and passes the
+//! damped share on to its neighbors. An insert only changes the residuals of
+//! the vertices it touches, so an update pushes from there until the residuals
+//! are small again. Adding an edge rescales the estimate of its origin so that
+//! the shares it already passed on stay valid. Edge weights are ignored and the
+//! rank of vertices without outgoing edges is spread over every vertex, as in
+//! streamingPageRank. That spread is owed to every vertex at once and is only
+//! pushed out once it exceeds the tolerance. The graph must outlive the object.
+//!
+//! \tparam G A graph recording a journal. Edges count in both directions on undirected graphs.
+template <typename G> requires JournaledGraph<G>
+class IncrementalPageRank
+{
+public:
+  using VertexPtr = typename G::VertexPtr;
+
+  //! \brief Compute the ranks of a graph.
+  //!
+  //! \param [in] graph The graph. Recording must be enabled for updates to be incremental.
+  //! \param [in] options The damping factor and the tolerance.
+  //! \exception std::invalid_argument Thrown when the damping factor is not in [0, 1) or the tolerance is not positive.
+  explicit IncrementalPageRank(const G& graph, const IncrementalPageRankOptions& options = {}):
+    graph_(&graph), options_(options)
+  {
+    if (!(options.damping >= 0 && options.damping < 1)) { throw std::invalid_argument("The damping factor must be in [0, 1)"); }
+    if (!(options.tolerance > 0)) { throw std::invalid_argument("The tolerance must be positive"); }
+    recompute();
+  }
+
+  //! \brief Apply the inserts recorded since the last update.
+  //! Recomputes from scratch when the journal no longer covers the last update.
+  IncrementalUpdate update()
+  {
+    GRAPH_LIB_SCOPED_TIMER("incremental_pagerank_update");
+    IncrementalUpdate result;
+    bool consistent = true;
+    const bool covered = detail::consumeJournal(*graph_, position_, result.mutations, [&](const Mutation& mutation)
+    {
+      if (!consistent) { return; }
+      if (mutation.kind == MutationKind::AddVertex) { consistent = addVertex(mutation.origin); return; }
+      consistent = addArc(mutation.origin, mutation.dest);
+      if constexpr (!G::is_directed)
+      {
+        if (consistent && mutation.origin != mutation.dest) { consistent = addArc(mutation.dest, mutation.origin); }
+      }
+    });
+    if (!covered || !consistent)
+    {
+      recompute();
+      result.vertices_updated = entries_.size();
+      result.recomputed = true;
+      return result;
+    }
+    result.vertices_updated = propagate();
+    return result;
+  }
+
+  //! \brief Get the rank of a vertex.
+  //!
+  //! \param [in] id The ID of the vertex.
+  //! \return std::optional<double> The rank, or no value if the vertex is not known. Ranks sum to about 1.
+  std::optional<double> rank(unsigned int id) const noexcept
+  {
+    auto entry = entries_.find(id);
+    if (entry == entries_.end()) { return {}; }
+    return entry->second.rank / entries_.size();
+  }
+
+  //! \brief Get the rank of every vertex, by ID.
+  std::unordered_map<unsigned int, double> ranks() const
+  {
+    std::unordered_map<unsigned int, double> result;
+    result.reserve(entries_.size());
+    for (const auto& [id, entry] : entries_) { result.emplace(id, entry.rank / entries_.size()); }
+    return result;
+  }
+
+  //! \brief Discard the ranks and compute them again from the current graph.
+  void recompute()
+  {
+    GRAPH_LIB_SCOPED_TIMER("incremental_pagerank_recompute");
+    entries_.clear();
+    queue_.clear();
+    uniform_ = 0;
+    dangling_ = 0;
+    position_ = graph_->journal().head();
+    entries_.reserve(graph_->getSize());
+    graph_->forEachVertex([&](const VertexPtr& vertex)
+    {
+      size_t degree = 0;
+      graph_->forEachNeighbor(*vertex, [&](const VertexPtr&, float) { degree++; });
+      entries_.emplace((*vertex).getID(), Entry{vertex, 0, 1 - options_.damping, degree, false, 0});
+    });
+    for (auto& [id, entry] : entries_) { enqueue(id, entry); }
+    propagate();
+  }
+
+private:
+  //! \brief The state of one vertex. Ranks are scaled so that they sum to the vertex count.
+  struct Entry
+  {
+    VertexPtr vertex;
+    double rank;
+    //! \brief The residual, not counting the share owed to every vertex.
+    double residual;
+    size_t degree;
+    bool queued;
+    //! \brief The last propagate() that pushed the vertex.
+    uint64_t pass;
+  };
+
+  void enqueue(unsigned int id, Entry& entry)
+  {
+    if (entry.queued || std::abs(entry.residual + uniform_) <= options_.tolerance) { return; }
+    entry.queued = true;
+    queue_.push_back(id);
+  }
+
+  void addResidual(unsigned int id, double amount)
+  {
+    auto& entry = entries_.find(id)->second;
+    entry.residual += amount;
+    enqueue(id, entry);
+  }
+
+  //! \brief Give a new vertex its teleport share. Every other vertex owes it part of the rank of dangling vertices.
+  bool addVertex(unsigned int id)
+  {
+    if (entries_.contains(id)) { return true; }
+    auto vertex = graph_->getVertex(id);
+    if (!vertex.has_value()) { return false; }
+    const double n = static_cast<double>(entries_.size());
+    if (n > 0) { uniform_ += options_.damping * dangling_ * (1 / (n + 1) - 1 / n); }
+    auto [entry, _] = entries_.emplace(id, Entry{*vertex, 0, 0, 0, false, 0});
+    entry->second.residual = 1 - options_.damping + options_.damping * dangling_ / (n + 1) - uniform_;
+    enqueue(id, entry->second);
+    return true;
+  }
+
+  //! \brief Account for a new edge from origin to dest.
+  bool addArc(unsigned int origin_id, unsigned int dest_id)
+  {
+    auto origin = entries_.find(origin_id);
+    if (origin == entries_.end() || !entries_.contains(dest_id)) { return false; }
+    auto& entry = origin->second;
+    const double d = options_.damping;
+    if (entry.degree == 0)
+    {
+      // The rank of the origin stops being spread over every vertex and goes to dest alone
+      dangling_ -= entry.rank;
+      uniform_ -= d * entry.rank / entries_.size();
+      addResidual(dest_id, d * entry.rank);
+    }
+    else
+    {
+      // Scale the estimate so that each out edge still carries the share already passed on
+      const double scaled = entry.rank * (entry.degree + 1) / entry.degree;
+      entry.residual -= scaled - entry.rank;
+      entry.rank = scaled;
+      addResidual(dest_id, d * scaled / (entry.degree + 1));
+    }
+    entry.degree++;
+    enqueue(origin_id, entry);
+    return true;
+  }
+
+  //! \brief Push residuals until every vertex is within the tolerance. Returns the number of vertices pushed.
+  size_t propagate()
+  {
+    const double d = options_.damping;
+    size_t pushed = 0;
+    pass_++;
+    while (true)
+    {
+      while (!queue_.empty())
+      {
+        const unsigned int id = queue_.front();
+        queue_.pop_front();
+        auto& entry = entries_.find(id)->second;
+        entry.queued = false;
+        const double residual = entry.residual + uniform_;
+        if (std::abs(residual) <= options_.tolerance) { continue; }
+
+        if (entry.pass != pass_) { entry.pass = pass_; pushed++; }
+        GRAPH_LIB_COUNT(VerticesVisited, 1);
+        entry.rank += residual;
+        entry.residual -= residual;
+        if (entry.degree == 0)
+        {
+          dangling_ += residual;
+          uniform_ += d * residual / entries_.size();
+          continue;
+        }
+        const double share = d * residual / entry.degree;
+        graph_->forEachNeighbor(*entry.vertex, [&](const VertexPtr& dest, float)
+        {
+          GRAPH_LIB_COUNT(EdgesScanned, 1);
+          addResidual((*dest).getID(), share);
+        });
+      }
+
+      // Hand out the share owed to every vertex once it is large enough to matter
+      if (std::abs(uniform_) <= options_.tolerance) { return pushed; }
+      const double owed = uniform_;
+      uniform_ = 0;
+      for (auto& [id, entry] : entries_)
+      {
+        entry.residual += owed;
+        enqueue(id, entry);
+      }
+    }
+  }
+
+  const G* graph_;
+  IncrementalPageRankOptions options_;
+  uint64_t position_ = 0;
+  std::unordered_map<unsigned int, Entry> entries_;
+  std::deque<unsigned int> queue_;
+  //! \brief The residual owed to every vertex by the pushes of dangling vertices.
+  double uniform_ = 0;
+  //! \brief The total rank held by dangling vertices.
+  double dangling_ = 0;
+  uint64_t pass_ = 0;
+};
+
+} // namespace graph_lib
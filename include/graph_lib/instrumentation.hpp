@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+
+// Instrumentation is compiled in when GRAPH_LIB_INSTRUMENTATION is defined.
+// Otherwise every macro below expands to nothing and has no runtime cost.
+#ifdef GRAPH_LIB_INSTRUMENTATION
+#define GRAPH_LIB_COUNT(counter, n) \
+  ::graph_lib::instrumentation::add(::graph_lib::instrumentation::Counter::counter, (n))
+#define GRAPH_LIB_SCOPED_TIMER(name) \
+  ::graph_lib::instrumentation::ScopedTimer GRAPH_LIB_CONCAT(graph_lib_timer_, __LINE__)(name)
+#else
+#define GRAPH_LIB_COUNT(counter, n) ((void)0)
+#define GRAPH_LIB_SCOPED_TIMER(name) ((void)0)
+#endif
+
+#define GRAPH_LIB_CONCAT_IMPL(a, b) a##b
+#define GRAPH_LIB_CONCAT(a, b) GRAPH_LIB_CONCAT_IMPL(a, b)
+
+
+namespace graph_lib::instrumentation
+{
+//! \brief Whether instrumentation was compiled in.
+#ifdef GRAPH_LIB_INSTRUMENTATION
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+enum class Counter : size_t
+{
+  VerticesVisited,
+  EdgesScanned,
+  HashLookups,
+  Allocations,
+  BytesAllocated,
+  Count
+};
+
+constexpr std::array<const char*, static_cast<size_t>(Counter::Count)> counter_names{
+  "vertices_visited", "edges_scanned", "hash_lookups", "allocations", "bytes_allocated"};
+
+//! \brief Accumulated elapsed time of one kind of traversal or algorithm call.
+struct Timing
+{
+  uint64_t calls = 0;
+  uint64_t nanoseconds = 0;
+};
+
+//! \brief A copy of every counter and timing at one point in time.
+struct Snapshot
+{
+  std::array<uint64_t, static_cast<size_t>(Counter::Count)> counters{};
+  std::map<std::string, Timing> timings;
+
+  uint64_t get(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+
+  //! \brief Write the snapshot as a JSON object.
+  void writeJson(std::ostream& os) const
+  {
+    os << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"counters\": {";
+    for (size_t i = 0; i < counters.size(); i++)
+    {
+      os << (i == 0 ? "" : ", ") << '"' << counter_names[i] << "\": " << counters[i];
+    }
+    os << "}, \"timings\": {";
+    bool first = true;
+    for (const auto& [name, timing] : timings)
+    {
+      os << (first ? "" : ", ") << '"' << name << "\": {\"calls\": " << timing.calls
+         << ", \"nanoseconds\": " << timing.nanoseconds << '}';
+      first = false;
+    }
+    os << "}}";
+  }
+};
+
+
+namespace detail
+{
+inline std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)> counters{};
+inline std::map<std::string, Timing> timings;
+inline std::mutex timings_mutex;
+} // namespace detail
+
+//! \brief Add to a counter. Prefer the GRAPH_LIB_COUNT macro, which compiles away when disabled.
+inline void add(Counter counter, uint64_t n) noexcept
+{
+  detail::counters[static_cast<size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+}
+
+//! \brief Record one call of a named traversal or algorithm.
+inline void record(const char* name, std::chrono::nanoseconds elapsed)
+{
+  std::lock_guard<std::mutex> lock(detail::timings_mutex);
+  auto& timing = detail::timings[name];
+  timing.calls++;
+  timing.nanoseconds += elapsed.count();
+}
+
+//! \brief Get the current value of every counter and timing.
+inline Snapshot snapshot()
+{
+  Snapshot result;
+  for (size_t i = 0; i < result.counters.size(); i++)
+  {
+    result.counters[i] = detail::counters[i].load(std::memory_order_relaxed);
+  }
+  std::lock_guard<std::mutex> lock(detail::timings_mutex);
+  result.timings = detail::timings;
+  return result;
+}
+
+//! \brief Reset every counter and timing to zero.
+inline void reset()
+{
+  for (auto& counter : detail::counters) { counter.store(0, std::memory_order_relaxed); }
+  std::lock_guard<std::mutex> lock(detail::timings_mutex);
+  detail::timings.clear();
+}
+
+//! \brief Write the current counters and timings as a JSON object.
+inline void writeJson(std::ostream& os) { snapshot().writeJson(os); }
+
+//! \brief Records the time between its construction and stop() or destruction.
+//! A copy is inactive, so copying an iterator that owns a timer does not record twice.
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(const char* name):
+    name_(name), start_(std::chrono::steady_clock::now())
+  {}
+
+  ScopedTimer(const ScopedTimer&): name_(nullptr) {}
+  ScopedTimer& operator=(const ScopedTimer&) { stop(); return *this; }
+
+  ~ScopedTimer() { stop(); }
+
+  //! \brief Record the elapsed time now instead of at destruction.
+  void stop()
+  {
+    if (name_ == nullptr) { return; }
+    record(name_, std::chrono::steady_clock::now() - start_);
+    name_ = nullptr;
+  }
+
+private:
+  const char* name_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace graph_lib::instrumentation
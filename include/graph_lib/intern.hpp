@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace graph_lib
+{
+namespace detail
+{
+//! \brief A string stored in the arena of a StringInterner, with its hash.
+struct InternEntry
+{
+  std::string_view text;
+  size_t hash;
+};
+} // namespace detail
+
+//! \brief A handle to a string stored once in a StringInterner.
+//! Handles are the size of a pointer. Equality compares the pointers and hashing
+//! returns the hash computed when the string was interned, so a graph keyed by
+//! interned strings does the same work per lookup as a graph keyed by integers.
+//! Handles from different interners must not be mixed, and the interner must
+//! outlive every handle it returned.
+class InternedString
+{
+public:
+  //! \brief The empty string.
+  InternedString() = default;
+
+  std::string_view view() const noexcept { return entry_ != nullptr ? entry_->text : std::string_view(); }
+  size_t hash() const noexcept { return entry_ != nullptr ? entry_->hash : 0; }
+  size_t size() const noexcept { return view().size(); }
+  bool empty() const noexcept { return entry_ == nullptr; }
+
+  operator std::string_view() const noexcept { return view(); }
+
+  bool operator==(const InternedString& rhs) const noexcept { return entry_ == rhs.entry_; }
+
+  friend std::ostream& operator<<(std::ostream& os, const InternedString& value) { return os << value.view(); }
+
+private:
+  explicit InternedString(const detail::InternEntry* entry) noexcept: entry_(entry) {}
+
+  const detail::InternEntry* entry_ = nullptr;
+
+  friend class StringInterner;
+};
+
+//! \brief Stores each distinct string once and hands out InternedString handles to it.
+//! Characters are packed back to back in large arena blocks instead of one heap
+//! allocation per string, and strings are found through an open addressing table
+//! with linear probing that stores each string's hash next to its pointer.
+//! Not thread safe.
+class StringInterner
+{
+public:
+  StringInterner() = default;
+  StringInterner(const StringInterner&) = delete;
+  StringInterner& operator=(const StringInterner&) = delete;
+
+  //! \brief Take over the strings of another interner, which is left empty and reusable.
+  StringInterner(StringInterner&& other) noexcept:
+    entries_(std::move(other.entries_)), slots_(std::move(other.slots_)), blocks_(std::move(other.blocks_)),
+    block_(std::exchange(other.block_, nullptr)), block_used_(std::exchange(other.block_used_, 0)),
+    arena_bytes_(std::exchange(other.arena_bytes_, 0))
+  {
+    other.entries_.clear();
+    other.slots_.clear();
+    other.blocks_.clear();
+  }
+
+  StringInterner& operator=(StringInterner&& other) noexcept
+  {
+    if (this == &other) { return *this; }
+    entries_ = std::move(other.entries_);
+    slots_ = std::move(other.slots_);
+    blocks_ = std::move(other.blocks_);
+    block_ = std::exchange(other.block_, nullptr);
+    block_used_ = std::exchange(other.block_used_, 0);
+    arena_bytes_ = std::exchange(other.arena_bytes_, 0);
+    other.entries_.clear();
+    other.slots_.clear();
+    other.blocks_.clear();
+    return *this;
+  }
+
+  //! \brief Get the handle of a string, storing the string if it was not seen before.
+  //!
+  //! \param [in] text The string to intern.
+  //! \return InternedString The handle, equal to every other handle for the same string.
+  InternedString intern(std::string_view text)
+  {
+    if (text.empty()) { return {}; }
+    if ((entries_.size() + 1) * 2 > slots_.size()) { grow(); }
+
+    const size_t hash = std::hash<std::string_view>()(text);
+    const size_t slot = probe(text, hash);
+    if (slots_[slot] != nullptr) { return InternedString(slots_[slot]); }
+
+    const auto& entry = entries_.emplace_back(detail::InternEntry{store(text), hash});
+    slots_[slot] = &entry;
+    return InternedString(&entry);
+  }
+
+  //! \brief Get the handle of a string without storing it.
+  //!
+  //! \param [in] text The string to look up.
+  //! \return std::optional<InternedString> The handle, or no value if the string was never interned.
+  std::optional<InternedString> find(std::string_view text) const noexcept
+  {
+    if (text.empty()) { return InternedString(); }
+    if (slots_.empty()) { return {}; }
+    const size_t slot = probe(text, std::hash<std::string_view>()(text));
+    if (slots_[slot] == nullptr) { return {}; }
+    return InternedString(slots_[slot]);
+  }
+
+  //! \brief The number of distinct non-empty strings stored.
+  size_t size() const noexcept { return entries_.size(); }
+
+  //! \brief The bytes reserved by the arena blocks.
+  size_t arenaBytes() const noexcept { return arena_bytes_; }
+
+private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  std::deque<detail::InternEntry> entries_;
+  std::vector<const detail::InternEntry*> slots_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  //! \brief The block short strings are being packed into.
+  char* block_ = nullptr;
+  size_t block_used_ = 0;
+  size_t arena_bytes_ = 0;
+
+  //! \brief The slot holding the string, or the empty slot where it belongs.
+  size_t probe(std::string_view text, size_t hash) const noexcept
+  {
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask)
+    {
+      const auto* entry = slots_[slot];
+      if (entry == nullptr || (entry->hash == hash && entry->text == text)) { return slot; }
+    }
+  }
+
+  //! \brief Double the table, keeping it at most half full.
+  void grow()
+  {
+    std::vector<const detail::InternEntry*> slots(std::max<size_t>(16, slots_.size() * 2), nullptr);
+    const size_t mask = slots.size() - 1;
+    for (const auto& entry : entries_)
+    {
+      size_t slot = entry.hash & mask;
+      while (slots[slot] != nullptr) { slot = (slot + 1) & mask; }
+      slots[slot] = &entry;
+    }
+    slots_.swap(slots);
+  }
+
+  //! \brief Copy a string into the arena. Strings too long to share a block get their own.
+  std::string_view store(std::string_view text)
+  {
+    char* target;
+    if (text.size() > kBlockSize / 4)
+    {
+      target = allocate(text.size());
+    }
+    else
+    {
+      if (block_ == nullptr || block_used_ + text.size() > kBlockSize)
+      {
+        block_ = allocate(kBlockSize);
+        block_used_ = 0;
+      }
+      target = block_ + block_used_;
+      block_used_ += text.size();
+    }
+    std::memcpy(target, text.data(), text.size());
+    return {target, text.size()};
+  }
+
+  char* allocate(size_t bytes)
+  {
+    blocks_.emplace_back(new char[bytes]);
+    arena_bytes_ += bytes;
+    return blocks_.back().get();
+  }
+};
+
+} // namespace graph_lib
+
+
+template <>
+struct std::hash<graph_lib::InternedString>
+{
+  size_t operator()(const graph_lib::InternedString& value) const noexcept { return value.hash(); }
+};
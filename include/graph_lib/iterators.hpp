@@ -3,10 +3,12 @@
 #include <queue>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <stack>
 #include <vector>
 #include <unordered_map>
 
+#include <graph_lib/instrumentation.hpp>
 #include <graph_lib/vertex.hpp>
 
 
@@ -16,21 +18,11 @@ namespace graph_lib
 template <typename T> requires Graphable<T>
 class Graph;
 
-template <typename T> requires Graphable<T>
-class UnweightedDirectedGraph;
-
-template <typename T> requires Graphable<T>
-class WeightedDirectedGraph;
-
-template <typename T> requires Graphable<T>
-class UnweightedUndirectedGraph;
-
-template <typename T> requires Graphable<T>
-class WeightedUndirectedGraph;
-
 template <typename T> requires Graphable<T>
 struct GraphIterator;
 
+enum class TraversalOrder { DepthFirst, BreadthFirst };
+
 
 template <typename T> requires Graphable<T>
 struct GraphIteratorBase
@@ -42,7 +34,7 @@ struct GraphIteratorBase
   using reference         = value_type const&;
 
   using VertexPtr = std::shared_ptr<Vertex<T>>;
-  using VertexSet = std::unordered_set<VertexPtr, VertexPtrHash<T>, VertexPtrCompare<T>>;
+  using VertexSet = VertexPtrSet<T>;
 
   GraphIteratorBase(const Graph<T> &graph):
     graph_(graph), itr_(graph_.vertices_.begin()), end_itr_(graph_.vertices_.end()), current_value_(*graph_.vertices_.begin()), current_pos_(0), end_pos_(graph_.vertices_.size())
@@ -61,6 +53,17 @@ struct GraphIteratorBase
 
   virtual GraphIteratorBase* clone() = 0;
 
+#ifdef GRAPH_LIB_INSTRUMENTATION
+  // Count every iterator allocation, including the ones made by clone()
+  static void* operator new(std::size_t size)
+  {
+    GRAPH_LIB_COUNT(Allocations, 1);
+    GRAPH_LIB_COUNT(BytesAllocated, size);
+    return ::operator new(size);
+  }
+  static void operator delete(void* ptr) { ::operator delete(ptr); }
+#endif
+
 protected:
   friend struct GraphIterator<T>;
 
@@ -83,7 +86,7 @@ struct GraphIterator
   using reference         = value_type const&;
 
   using VertexPtr = std::shared_ptr<Vertex<T>>;
-  using VertexSet = std::unordered_set<VertexPtr, VertexPtrHash<T>, VertexPtrCompare<T>>;
+  using VertexSet = VertexPtrSet<T>;
 
   GraphIterator(GraphIteratorBase<T> *base):
     base_(base)
@@ -93,6 +96,16 @@ struct GraphIterator
     base_(b.base_->clone())
   {}
 
+  GraphIterator(GraphIterator<T>&&) noexcept = default;
+
+  GraphIterator& operator=(const GraphIterator<T>& b)
+  {
+    if (this != &b) { base_.reset(b.base_->clone()); }
+    return *this;
+  }
+
+  GraphIterator& operator=(GraphIterator<T>&&) noexcept = default;
+
   // Prefix increment
   GraphIterator& operator++()
   {
@@ -108,9 +121,9 @@ struct GraphIterator
   }
 
   reference operator*() const { return base_->current_value_; }
-  pointer operator->() { return &(base_->current_value_); }
-  bool operator== (const GraphIterator& rhs) { return base_->current_pos_ == rhs.base_->current_pos_; };
-  bool operator!= (const GraphIterator& rhs) { return base_->current_pos_ != rhs.base_->current_pos_; };
+  pointer operator->() const { return &(base_->current_value_); }
+  bool operator== (const GraphIterator& rhs) const { return base_->current_pos_ == rhs.base_->current_pos_; };
+  bool operator!= (const GraphIterator& rhs) const { return base_->current_pos_ != rhs.base_->current_pos_; };
 
 protected:
   std::unique_ptr<GraphIteratorBase<T>> base_;
@@ -145,8 +158,8 @@ struct BasicGraphIterator : public GraphIteratorBase<T>
 };
 
 
-template<template <typename U> requires Graphable<U> typename G, typename T> requires Graphable<T>
-struct DFSIteratorBase : public GraphIteratorBase<T>
+template<typename T> requires Graphable<T>
+struct DFSIterator : public GraphIteratorBase<T>
 {
   using iterator_category = std::input_iterator_tag;
   using difference_type   = std::ptrdiff_t;
@@ -154,20 +167,29 @@ struct DFSIteratorBase : public GraphIteratorBase<T>
   using pointer           = value_type const*;
   using reference         = value_type const&;
 
-  DFSIteratorBase(const G<T> &graph):
+  DFSIterator(const Graph<T> &graph):
     GraphIteratorBase<T>(graph)
   {
+#ifdef GRAPH_LIB_INSTRUMENTATION
+    timer_.emplace("dfs");
+#endif
     visitVertex(this->current_value_);
   }
 
-  DFSIteratorBase(const G<T> &graph, size_t offset):
+  DFSIterator(const Graph<T> &graph, size_t offset):
     GraphIteratorBase<T>(graph, offset)
   {}
 
   void increment() override
   {
     GraphIteratorBase<T>::increment();
-    if (this->current_pos_ >= this->end_pos_) { return; }
+    if (this->current_pos_ >= this->end_pos_)
+    {
+#ifdef GRAPH_LIB_INSTRUMENTATION
+      timer_.reset();
+#endif
+      return;
+    }
 
     if (stack_.empty())
     {
@@ -175,6 +197,7 @@ struct DFSIteratorBase : public GraphIteratorBase<T>
       do
       {
         const auto vertex = *(++this->itr_);
+        GRAPH_LIB_COUNT(HashLookups, 1);
         count = visited_.count(vertex);
       } while (count != 0);
       if (this->itr_ != this->end_itr_) { stack_.push(*this->itr_); }
@@ -186,12 +209,21 @@ struct DFSIteratorBase : public GraphIteratorBase<T>
     visitVertex(this->current_value_);
   }
 
+  DFSIterator* clone() override { return new DFSIterator(*this); }
+
 private:
   std::unordered_map<value_type, bool, VertexPtrHash<T>, VertexPtrCompare<T>> visited_;
   std::stack<value_type> stack_;
 
+#ifdef GRAPH_LIB_INSTRUMENTATION
+  //! \brief Measures the traversal from the begin iterator until it reaches the end.
+  std::optional<instrumentation::ScopedTimer> timer_;
+#endif
+
   void visitVertex(value_type vertex)
   {
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    GRAPH_LIB_COUNT(HashLookups, 2);
     const auto val = visited_.find(vertex);
     if (val == visited_.end() || !(*val).second)
     {
@@ -200,6 +232,8 @@ private:
     for(auto& edge : (*vertex).adj)
     {
       auto adj_vertex = (*edge).vertex;
+      GRAPH_LIB_COUNT(EdgesScanned, 1);
+      GRAPH_LIB_COUNT(HashLookups, 1);
       const auto val2 = visited_.find(adj_vertex);
       if (val2 == visited_.end() || !(*val2).second)
       {
@@ -209,30 +243,9 @@ private:
   }
 };
 
-template<template <typename> typename G, typename T> requires Graphable<T>
-struct DFSIterator;
-template<typename T> requires Graphable<T> 
-struct DFSIterator<UnweightedDirectedGraph, T> : public DFSIteratorBase<UnweightedDirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  DFSIterator(const UnweightedDirectedGraph<T> &graph):
-    DFSIteratorBase<UnweightedDirectedGraph, T>(graph)
-  {}
-
-  DFSIterator(const UnweightedDirectedGraph<T> &graph, size_t offset):
-    DFSIteratorBase<UnweightedDirectedGraph, T>(graph, offset)
-  {}
-
-  DFSIterator* clone() override { return new DFSIterator<UnweightedDirectedGraph, T>(*this); }
-};
 
-template<typename T> requires Graphable<T> 
-struct DFSIterator<WeightedDirectedGraph, T> : public DFSIteratorBase<WeightedDirectedGraph, T>
+template<typename T> requires Graphable<T>
+struct BFSIterator : public GraphIteratorBase<T>
 {
   using iterator_category = std::input_iterator_tag;
   using difference_type   = std::ptrdiff_t;
@@ -240,81 +253,29 @@ struct DFSIterator<WeightedDirectedGraph, T> : public DFSIteratorBase<WeightedDi
   using pointer           = value_type const*;
   using reference         = value_type const&;
 
-  DFSIterator(const WeightedDirectedGraph<T> &graph):
-    DFSIteratorBase<WeightedDirectedGraph, T>(graph)
-  {}
-
-  DFSIterator(const WeightedDirectedGraph<T> &graph, size_t offset):
-    DFSIteratorBase<WeightedDirectedGraph, T>(graph, offset)
-  {}
-
-  DFSIterator* clone() override { return new DFSIterator<WeightedDirectedGraph, T>(*this); }
-};
-
-template<typename T> requires Graphable<T> 
-struct DFSIterator<UnweightedUndirectedGraph, T> : public DFSIteratorBase<UnweightedUndirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  DFSIterator(const UnweightedUndirectedGraph<T> &graph):
-    DFSIteratorBase<UnweightedUndirectedGraph, T>(graph)
-  {}
-
-  DFSIterator(const UnweightedUndirectedGraph<T> &graph, size_t offset):
-    DFSIteratorBase<UnweightedUndirectedGraph, T>(graph, offset)
-  {}
-
-  DFSIterator* clone() override { return new DFSIterator<UnweightedUndirectedGraph, T>(*this); }
-};
-
-template<typename T> requires Graphable<T> 
-struct DFSIterator<WeightedUndirectedGraph, T> : public DFSIteratorBase<WeightedUndirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  DFSIterator(const WeightedUndirectedGraph<T> &graph):
-    DFSIteratorBase<WeightedUndirectedGraph, T>(graph)
-  {}
-
-  DFSIterator(const WeightedUndirectedGraph<T> &graph, size_t offset):
-    DFSIteratorBase<WeightedUndirectedGraph, T>(graph, offset)
-  {}
-
-  DFSIterator* clone() override { return new DFSIterator<WeightedUndirectedGraph, T>(*this); }
-};
-
-
-template<template <typename U> requires Graphable<U> typename G, typename T> requires Graphable<T>
-struct BFSIteratorBase : public GraphIteratorBase<T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  BFSIteratorBase(const G<T> &graph):
+  BFSIterator(const Graph<T> &graph):
     GraphIteratorBase<T>(graph)
   {
+#ifdef GRAPH_LIB_INSTRUMENTATION
+    timer_.emplace("bfs");
+#endif
     visitVertex(this->current_value_);
   }
 
-  BFSIteratorBase(const G<T> &graph, size_t offset):
+  BFSIterator(const Graph<T> &graph, size_t offset):
     GraphIteratorBase<T>(graph, offset)
   {}
 
   void increment() override
   {
     GraphIteratorBase<T>::increment();
-    if (this->current_pos_ >= this->end_pos_) { return; }
+    if (this->current_pos_ >= this->end_pos_)
+    {
+#ifdef GRAPH_LIB_INSTRUMENTATION
+      timer_.reset();
+#endif
+      return;
+    }
 
     if (queue_.empty())
     {
@@ -322,6 +283,7 @@ struct BFSIteratorBase : public GraphIteratorBase<T>
       do
       {
         const auto vertex = *(++this->itr_);
+        GRAPH_LIB_COUNT(HashLookups, 1);
         count = visited_.count(vertex);
       } while (count != 0);
       if (this->itr_ != this->end_itr_) { queue_.push(*this->itr_); }
@@ -333,12 +295,21 @@ struct BFSIteratorBase : public GraphIteratorBase<T>
     visitVertex(this->current_value_);
   }
 
+  BFSIterator* clone() override { return new BFSIterator(*this); }
+
 private:
   std::unordered_map<value_type, bool, VertexPtrHash<T>, VertexPtrCompare<T>> visited_;
   std::queue<value_type> queue_;
 
+#ifdef GRAPH_LIB_INSTRUMENTATION
+  //! \brief Measures the traversal from the begin iterator until it reaches the end.
+  std::optional<instrumentation::ScopedTimer> timer_;
+#endif
+
   void visitVertex(value_type vertex)
   {
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    GRAPH_LIB_COUNT(HashLookups, 2);
     const auto val = visited_.find(vertex);
     if (val == visited_.end() || !(*val).second)
     {
@@ -347,6 +318,8 @@ private:
     for(auto& edge : (*vertex).adj)
     {
       auto adj_vertex = (*edge).vertex;
+      GRAPH_LIB_COUNT(EdgesScanned, 1);
+      GRAPH_LIB_COUNT(HashLookups, 1);
       const auto val2 = visited_.find(adj_vertex);
       if (val2 == visited_.end() || !(*val2).second)
       {
@@ -356,86 +329,4 @@ private:
   }
 };
 
-template<template <typename> typename G, typename T> requires Graphable<T>
-struct BFSIterator;
-template<typename T> requires Graphable<T> 
-struct BFSIterator<UnweightedDirectedGraph, T> : public BFSIteratorBase<UnweightedDirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  BFSIterator(const UnweightedDirectedGraph<T> &graph):
-    BFSIteratorBase<UnweightedDirectedGraph, T>(graph)
-  {}
-
-  BFSIterator(const UnweightedDirectedGraph<T> &graph, size_t offset):
-    BFSIteratorBase<UnweightedDirectedGraph, T>(graph, offset)
-  {}
-
-  BFSIterator* clone() override { return new BFSIterator<UnweightedDirectedGraph, T>(*this); }
-};
-
-template<typename T> requires Graphable<T> 
-struct BFSIterator<WeightedDirectedGraph, T> : public BFSIteratorBase<WeightedDirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  BFSIterator(const WeightedDirectedGraph<T> &graph):
-    BFSIteratorBase<WeightedDirectedGraph, T>(graph)
-  {}
-
-  BFSIterator(const WeightedDirectedGraph<T> &graph, size_t offset):
-    BFSIteratorBase<WeightedDirectedGraph, T>(graph, offset)
-  {}
-
-  BFSIterator* clone() override { return new BFSIterator<WeightedDirectedGraph, T>(*this); }
-};
-
-template<typename T> requires Graphable<T> 
-struct BFSIterator<UnweightedUndirectedGraph, T> : public BFSIteratorBase<UnweightedUndirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  BFSIterator(const UnweightedUndirectedGraph<T> &graph):
-    BFSIteratorBase<UnweightedUndirectedGraph, T>(graph)
-  {}
-
-  BFSIterator(const UnweightedUndirectedGraph<T> &graph, size_t offset):
-    BFSIteratorBase<UnweightedUndirectedGraph, T>(graph, offset)
-  {}
-
-  BFSIterator* clone() override { return new BFSIterator<UnweightedUndirectedGraph, T>(*this); }
-};
-
-template<typename T> requires Graphable<T> 
-struct BFSIterator<WeightedUndirectedGraph, T> : public BFSIteratorBase<WeightedUndirectedGraph, T>
-{
-  using iterator_category = std::input_iterator_tag;
-  using difference_type   = std::ptrdiff_t;
-  using value_type        = std::shared_ptr<Vertex<T>>;
-  using pointer           = value_type const*;
-  using reference         = value_type const&;
-
-  BFSIterator(const WeightedUndirectedGraph<T> &graph):
-    BFSIteratorBase<WeightedUndirectedGraph, T>(graph)
-  {}
-
-  BFSIterator(const WeightedUndirectedGraph<T> &graph, size_t offset):
-    BFSIteratorBase<WeightedUndirectedGraph, T>(graph, offset)
-  {}
-
-  BFSIterator* clone() override { return new BFSIterator<WeightedUndirectedGraph, T>(*this); }
-};
-
 } // namespace graph_lib
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <graph_lib/memory.hpp>
+
+
+namespace graph_lib
+{
+enum class MutationKind
+{
+  AddVertex,
+  AddEdge
+};
+
+//! \brief One change recorded in a ChangeJournal.
+struct Mutation
+{
+  //! \brief The position of the change in the journal. Sequence numbers are never reused.
+  uint64_t sequence;
+  MutationKind kind;
+  //! \brief The new vertex, or the origin of the new edge.
+  unsigned int origin;
+  //! \brief The destination of the new edge. Unused for vertices.
+  unsigned int dest;
+  //! \brief The weight of the new edge. Unweighted edges record 0.
+  float weight;
+};
+
+//! \brief The inserts made to a graph, in order, for algorithms that update earlier results.
+//! Consumers remember the sequence number they have read up to and read the
+//! entries since then. The journal keeps entries until the graph discards
+//! them, and a consumer whose position was discarded, or that started while
+//! the journal was not recording, has to start over.
+class ChangeJournal
+{
+public:
+  using Allocator = TrackingAllocator<Mutation>;
+
+  ChangeJournal() = default;
+  explicit ChangeJournal(Allocator allocator): entries_(allocator) {}
+
+  //! \brief Whether inserts are being recorded.
+  bool recording() const noexcept { return recording_; }
+
+  //! \brief The sequence number of the oldest entry kept.
+  uint64_t base() const noexcept { return base_; }
+
+  //! \brief The sequence number the next change will get.
+  uint64_t head() const noexcept { return base_ + entries_.size(); }
+
+  //! \brief Whether every change made since a position is in the journal.
+  //!
+  //! \param [in] sequence A position returned by head().
+  //! \return true If since(sequence) holds every change made after the position was taken.
+  bool covers(uint64_t sequence) const noexcept { return recording_ && sequence >= base_ && sequence <= head(); }
+
+  //! \brief Get the entries from a position to the end of the journal.
+  //!
+  //! \param [in] sequence The sequence number of the first entry wanted.
+  //! \return std::span<const Mutation> The entries, empty if the position is not covered.
+  std::span<const Mutation> since(uint64_t sequence) const noexcept
+  {
+    if (!covers(sequence)) { return {}; }
+    return std::span<const Mutation>(entries_).subspan(sequence - base_);
+  }
+
+  //! \brief The number of entries kept.
+  size_t size() const noexcept { return entries_.size(); }
+
+  //! \brief Start recording. Positions taken before now are not covered.
+  void start() noexcept
+  {
+    if (recording_) { return; }
+    recording_ = true;
+    base_ = head() + 1;
+  }
+
+  //! \brief Stop recording and release the entries.
+  void stop() noexcept
+  {
+    recording_ = false;
+    base_ = head() + 1;
+    std::vector<Mutation, Allocator>(entries_.get_allocator()).swap(entries_);
+  }
+
+  //! \brief Drop the entries before a position, once every consumer has read them.
+  void discardBefore(uint64_t sequence)
+  {
+    const auto count = static_cast<size_t>(std::min(sequence, head()) - std::min(sequence, base_));
+    entries_.erase(entries_.begin(), entries_.begin() + count);
+    base_ += count;
+  }
+
+  //! \brief Make room for the next entry while recording, so that recording it cannot fail.
+  //! Graphs call this before changing anything, then record once the change is made.
+  //! \exception std::bad_alloc Thrown when the room cannot be allocated.
+  void reserveNext()
+  {
+    if (recording_ && entries_.size() == entries_.capacity()) { entries_.reserve(std::max<size_t>(16, entries_.capacity() * 2)); }
+  }
+
+  //! \brief Record a new vertex. Does not allocate after reserveNext().
+  void recordVertex(unsigned int id) noexcept
+  {
+    if (recording_) { entries_.push_back({head(), MutationKind::AddVertex, id, id, 0}); }
+  }
+
+  //! \brief Record a new edge. Does not allocate after reserveNext().
+  void recordEdge(unsigned int origin_id, unsigned int dest_id, float weight) noexcept
+  {
+    if (recording_) { entries_.push_back({head(), MutationKind::AddEdge, origin_id, dest_id, weight}); }
+  }
+
+private:
+  bool recording_ = false;
+  uint64_t base_ = 0;
+  std::vector<Mutation, Allocator> entries_;
+};
+
+} // namespace graph_lib
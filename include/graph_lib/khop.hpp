@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/parallel.hpp>
+
+
+namespace graph_lib
+{
+//! \brief A request for every vertex within k hops of a seed vertex.
+struct KHopQuery
+{
+  //! \brief The external ID of the seed vertex.
+  unsigned int seed;
+  //! \brief The maximum number of hops. Zero returns the seed alone.
+  unsigned k;
+};
+
+struct KHopOptions
+{
+  //! \brief The number of worker threads, 0 selects the hardware concurrency.
+  unsigned threads = 0;
+  //! \brief Whether to record the hop count of every returned vertex.
+  bool hop_counts = false;
+};
+
+//! \brief The answers to a batch of k-hop queries, stored back to back.
+//! Each answer lists external vertex IDs in breadth first order, seed first,
+//! so hop counts never decrease along an answer.
+class KHopResults
+{
+public:
+  //! \brief The number of answered queries.
+  size_t size() const noexcept { return offsets_.size() - 1; }
+
+  //! \brief The vertices within k hops of the seed of query i. Empty when the seed does not exist.
+  std::span<const unsigned int> vertices(size_t i) const noexcept
+  {
+    return {ids_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+  }
+
+  //! \brief The hop counts parallel to vertices(i). Empty unless KHopOptions::hop_counts was set.
+  std::span<const uint32_t> hops(size_t i) const noexcept
+  {
+    if (hops_.empty()) { return {}; }
+    return {hops_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+  }
+
+  //! \brief The total number of stored vertices over every answer.
+  size_t totalVertices() const noexcept { return ids_.size(); }
+
+private:
+  std::vector<size_t> offsets_{0};
+  std::vector<unsigned int> ids_;
+  std::vector<uint32_t> hops_;
+
+  friend KHopResults kHopNeighborhoods(const CompactGraph&, std::span<const KHopQuery>, const KHopOptions&);
+};
+
+
+namespace detail
+{
+//! \brief Breadth first search state reused by one worker across seeds.
+//! Vertices are marked with the current generation, so nothing is cleared between searches.
+struct KHopScratch
+{
+  std::vector<uint32_t> stamp;
+  uint32_t generation = 0;
+
+  void begin(size_t n)
+  {
+    if (stamp.size() != n) { stamp.assign(n, 0); generation = 0; }
+    if (++generation == 0) { std::fill(stamp.begin(), stamp.end(), 0); generation = 1; }
+  }
+};
+
+//! \brief The breadth first order from one seed up to a depth.
+//! level_end[d] is the number of vertices at depth d or less.
+struct KHopLevels
+{
+  std::vector<CompactGraph::Index> order;
+  std::vector<size_t> level_end;
+};
+
+inline void searchLevels(const CompactGraph& graph, CompactGraph::Index seed, unsigned depth, KHopScratch& scratch, KHopLevels& levels)
+{
+  using Index = CompactGraph::Index;
+  scratch.begin(graph.vertexCount());
+  levels.order.assign(1, seed);
+  levels.level_end.assign(1, 1);
+  scratch.stamp[seed] = scratch.generation;
+
+  size_t level_first = 0;
+  for (unsigned d = 0; d < depth && level_first < levels.order.size(); d++)
+  {
+    const size_t level_last = levels.order.size();
+    for (size_t i = level_first; i < level_last; i++)
+    {
+      const auto row = graph.neighbors(levels.order[i]);
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+      GRAPH_LIB_COUNT(EdgesScanned, row.size());
+      for (Index u : row)
+      {
+        if (scratch.stamp[u] == scratch.generation) { continue; }
+        scratch.stamp[u] = scratch.generation;
+        levels.order.push_back(u);
+      }
+    }
+    level_first = level_last;
+    if (levels.order.size() == level_last) { break; }
+    levels.level_end.push_back(levels.order.size());
+  }
+}
+} // namespace detail
+
+
+//! \brief Answer a batch of k-hop neighborhood queries.
+//! Queries with identical seeds are answered once, by a single breadth first search
+//! to the largest k among them: each answer is a prefix of that search. Work is not
+//! shared between distinct seeds, even where their neighborhoods overlap: each one
+//! gets its own search. Those searches run in parallel, with per-thread state that
+//! is reused between searches.
+//!
+//! \param [in] graph The graph, as a CSR snapshot.
+//! \param [in] queries The (seed, k) pairs. Seeds are external vertex IDs.
+//! \param [in] options Thread count and whether to record hop counts.
+//! \return KHopResults One answer per query, in query order.
+inline KHopResults kHopNeighborhoods(const CompactGraph& graph, std::span<const KHopQuery> queries, const KHopOptions& options = {})
+{
+  using Index = CompactGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("khop_batch");
+
+  // Group the queries by seed, keeping the deepest k of each group
+  std::unordered_map<Index, size_t> group_of_seed;
+  std::vector<Index> seeds;
+  std::vector<unsigned> depths;
+  std::vector<size_t> query_group(queries.size(), SIZE_MAX);
+  for (size_t q = 0; q < queries.size(); q++)
+  {
+    auto seed = graph.internalId(queries[q].seed);
+    if (!seed.has_value()) { continue; }
+    auto [itr, inserted] = group_of_seed.emplace(*seed, seeds.size());
+    if (inserted) { seeds.push_back(*seed); depths.push_back(0); }
+    query_group[q] = itr->second;
+    depths[itr->second] = std::max(depths[itr->second], queries[q].k);
+  }
+
+  const unsigned threads = resolveThreads(options.threads);
+  std::vector<detail::KHopScratch> scratch(threads);
+  std::vector<detail::KHopLevels> levels(seeds.size());
+  parallelForDynamic(0, seeds.size(), threads, [&](size_t group, unsigned thread)
+  {
+    detail::searchLevels(graph, seeds[group], depths[group], scratch[thread], levels[group]);
+  });
+
+  // Lay the answers out back to back, then copy them in parallel
+  KHopResults results;
+  auto answerSize = [&](size_t q) -> size_t
+  {
+    if (query_group[q] == SIZE_MAX) { return 0; }
+    const auto& level_end = levels[query_group[q]].level_end;
+    return level_end[std::min<size_t>(queries[q].k, level_end.size() - 1)];
+  };
+  results.offsets_.resize(queries.size() + 1);
+  for (size_t q = 0; q < queries.size(); q++) { results.offsets_[q + 1] = results.offsets_[q] + answerSize(q); }
+  results.ids_.resize(results.offsets_.back());
+  if (options.hop_counts) { results.hops_.resize(results.offsets_.back()); }
+
+  parallelFor(0, queries.size(), threads, [&](size_t q)
+  {
+    const size_t first = results.offsets_[q], count = results.offsets_[q + 1] - first;
+    if (count == 0) { return; }
+    const auto& group = levels[query_group[q]];
+    for (size_t i = 0; i < count; i++) { results.ids_[first + i] = graph.externalId(group.order[i]); }
+    if (!options.hop_counts) { return; }
+
+    uint32_t hop = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+      while (i >= group.level_end[hop]) { hop++; }
+      results.hops_[first + i] = hop;
+    }
+  });
+  return results;
+}
+
+//! \brief Answer a batch of k-hop neighborhood queries on a graph or graph view.
+//! The graph is snapshotted once for the whole batch. Callers issuing many batches
+//! should build a CompactGraph once and use the overload taking it.
+template <typename G> requires TraversableGraph<G>
+KHopResults kHopNeighborhoods(const G& graph, std::span<const KHopQuery> queries, const KHopOptions& options = {})
+{
+  return kHopNeighborhoods(CompactGraph::fromGraph(graph), queries, options);
+}
+
+} // namespace graph_lib
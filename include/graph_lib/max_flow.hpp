@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+
+
+namespace graph_lib
+{
+enum class FlowMethod
+{
+  //! \brief Highest-label push-relabel with global relabeling and the gap heuristic.
+  PushRelabel,
+  //! \brief Dinic's blocking flows over BFS level graphs.
+  Dinic
+};
+
+//! \brief An edge crossing a minimum cut, from the source side to the sink side.
+struct CutEdge
+{
+  unsigned int origin;
+  unsigned int dest;
+  float capacity;
+};
+
+//! \brief The answer to a maximum flow query.
+struct FlowResult
+{
+  //! \brief The value of the maximum flow, which equals the capacity of the minimum cut.
+  double value = 0;
+  //! \brief The external IDs of the vertices on the source side of the minimum cut.
+  std::vector<unsigned int> source_side;
+  //! \brief The edges of the minimum cut. Their capacities add up to value.
+  std::vector<CutEdge> cut_edges;
+};
+
+//! \brief Maximum flow and minimum cut queries on a snapshot of a graph.
+//! Edge weights are capacities. The residual graph is kept in flat arrays: the
+//! arcs of each vertex are its edges followed by the reverse arcs of its incoming
+//! edges, and every arc knows the index of its reverse. Queries are const and
+//! allocate their own residual capacities, so they can run concurrently.
+//! Undirected graphs work as well, each edge carrying flow in either direction.
+class FlowNetwork
+{
+public:
+  using Index = CompactGraph::Index;
+
+  //! \brief Build the residual arcs of a graph.
+  //!
+  //! \param [in] graph The graph, as a CSR snapshot. Unweighted edges have capacity 1.
+  //! \exception std::invalid_argument Thrown when a capacity is negative.
+  explicit FlowNetwork(CompactGraph graph):
+    graph_(std::move(graph)), offsets_(graph_.vertexCount() + 1, 0)
+  {
+    const size_t n = graph_.vertexCount();
+    for (Index v = 0; v < n; v++)
+    {
+      offsets_[v + 1] += graph_.degree(v);
+      for (Index u : graph_.neighbors(v)) { offsets_[u + 1]++; }
+    }
+    for (size_t v = 0; v < n; v++) { offsets_[v + 1] += offsets_[v]; }
+
+    const size_t arcs = offsets_[n];
+    head_.resize(arcs);
+    mate_.resize(arcs);
+    capacity_.assign(arcs, 0);
+    original_.assign(arcs, false);
+    std::vector<size_t> fill(n);
+    for (Index v = 0; v < n; v++) { fill[v] = offsets_[v] + graph_.degree(v); }
+    for (Index v = 0; v < n; v++)
+    {
+      const auto row = graph_.neighbors(v);
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        const float weight = graph_.weight(v, i);
+        if (weight < 0) { throw std::invalid_argument("Capacities must not be negative"); }
+        const size_t a = offsets_[v] + i, b = fill[row[i]]++;
+        head_[a] = row[i];
+        head_[b] = v;
+        mate_[a] = b;
+        mate_[b] = a;
+        capacity_[a] = weight;
+        original_[a] = true;
+      }
+    }
+  }
+
+  const CompactGraph& graph() const noexcept { return graph_; }
+
+  size_t vertexCount() const noexcept { return graph_.vertexCount(); }
+
+  //! \brief The number of residual arcs, twice the number of edges.
+  size_t arcCount() const noexcept { return head_.size(); }
+
+  //! \brief Compute a maximum flow and a minimum cut between two vertices.
+  //!
+  //! \param [in] source_id The external ID of the source.
+  //! \param [in] sink_id The external ID of the sink.
+  //! \param [in] method The algorithm to use.
+  //! \return std::optional<FlowResult> The flow value and minimum cut, or no value when a vertex is missing or source and sink are the same.
+  std::optional<FlowResult> maxFlow(unsigned int source_id, unsigned int sink_id, FlowMethod method = FlowMethod::PushRelabel) const
+  {
+    GRAPH_LIB_SCOPED_TIMER("max_flow");
+    auto source = graph_.internalId(source_id);
+    auto sink = graph_.internalId(sink_id);
+    if (!source.has_value() || !sink.has_value() || *source == *sink) { return std::nullopt; }
+
+    std::vector<double> residual(capacity_.begin(), capacity_.end());
+    FlowResult result;
+    result.value = method == FlowMethod::PushRelabel ? pushRelabel(*source, *sink, residual) : dinic(*source, *sink, residual);
+    minimumCut(*sink, residual, result);
+    return result;
+  }
+
+private:
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  CompactGraph graph_;
+  std::vector<size_t> offsets_;
+  std::vector<Index> head_;
+  //! \brief The index of the reverse of each arc.
+  std::vector<size_t> mate_;
+  std::vector<float> capacity_;
+  //! \brief Whether each arc is an edge of the graph rather than the reverse of one.
+  std::vector<bool> original_;
+
+  //! \brief Breadth first search from the sink over arcs with residual capacity into the reached vertex.
+  //! \return std::vector<Index> The number of arcs to the sink, or kNil when the sink cannot be reached.
+  std::vector<Index> distancesToSink(Index sink, const std::vector<double>& residual) const
+  {
+    std::vector<Index> distance(vertexCount(), kNil);
+    std::vector<Index> queue{sink};
+    distance[sink] = 0;
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+      const Index v = queue[head];
+      for (size_t a = offsets_[v]; a < offsets_[v + 1]; a++)
+      {
+        const Index u = head_[a];
+        if (distance[u] != kNil || residual[mate_[a]] <= 0) { continue; }
+        distance[u] = distance[v] + 1;
+        queue.push_back(u);
+      }
+    }
+    return distance;
+  }
+
+  //! \brief The vertices that cannot reach the sink in the residual graph form the source side.
+  void minimumCut(Index sink, const std::vector<double>& residual, FlowResult& result) const
+  {
+    const auto distance = distancesToSink(sink, residual);
+    for (Index v = 0; v < vertexCount(); v++)
+    {
+      if (distance[v] != kNil) { continue; }
+      result.source_side.push_back(graph_.externalId(v));
+      for (size_t a = offsets_[v]; a < offsets_[v + 1]; a++)
+      {
+        if (!original_[a] || distance[head_[a]] == kNil) { continue; }
+        result.cut_edges.push_back({graph_.externalId(v), graph_.externalId(head_[a]), capacity_[a]});
+      }
+    }
+  }
+
+  //! \brief Highest-label push-relabel, stopping once the flow value is known.
+  //! Excess that cannot reach the sink is left where it is, since only the value
+  //! and the minimum cut are reported.
+  double pushRelabel(Index source, Index sink, std::vector<double>& residual) const
+  {
+    const size_t n = vertexCount();
+    const Index dead = static_cast<Index>(n);
+    std::vector<Index> height(n, 0);
+    std::vector<double> excess(n, 0);
+    std::vector<size_t> current(n);
+    // Active vertices per height as singly linked stacks, every live vertex per height as doubly linked lists
+    std::vector<Index> active_head(n, kNil), active_next(n, kNil);
+    std::vector<Index> all_head(n, kNil), all_next(n, kNil), all_prev(n, kNil);
+    ptrdiff_t max_active = -1, max_height = -1;
+
+    auto activate = [&](Index v)
+    {
+      active_next[v] = active_head[height[v]];
+      active_head[height[v]] = v;
+      max_active = std::max<ptrdiff_t>(max_active, height[v]);
+    };
+    auto link = [&](Index v)
+    {
+      const Index h = height[v];
+      all_prev[v] = kNil;
+      all_next[v] = all_head[h];
+      if (all_head[h] != kNil) { all_prev[all_head[h]] = v; }
+      all_head[h] = v;
+      max_height = std::max<ptrdiff_t>(max_height, h);
+    };
+    auto unlink = [&](Index v)
+    {
+      if (all_prev[v] != kNil) { all_next[all_prev[v]] = all_next[v]; }
+      else { all_head[height[v]] = all_next[v]; }
+      if (all_next[v] != kNil) { all_prev[all_next[v]] = all_prev[v]; }
+    };
+
+    // Exact heights are the residual distances to the sink
+    auto globalRelabel = [&]()
+    {
+      std::fill(active_head.begin(), active_head.end(), kNil);
+      std::fill(all_head.begin(), all_head.end(), kNil);
+      max_active = max_height = -1;
+      const auto distance = distancesToSink(sink, residual);
+      for (Index v = 0; v < n; v++)
+      {
+        if (v == source) { continue; }
+        height[v] = distance[v] == kNil ? dead : distance[v];
+        current[v] = offsets_[v];
+        if (height[v] == dead) { continue; }
+        link(v);
+        if (excess[v] > 0 && v != sink) { activate(v); }
+      }
+    };
+
+    height[source] = dead;
+    for (size_t a = offsets_[source]; a < offsets_[source + 1]; a++)
+    {
+      const double delta = residual[a];
+      if (delta <= 0) { continue; }
+      residual[a] = 0;
+      residual[mate_[a]] += delta;
+      excess[head_[a]] += delta;
+    }
+    globalRelabel();
+
+    const size_t relabel_interval = 6 * n + arcCount();
+    size_t work = 0;
+    while (max_active >= 0)
+    {
+      const Index v = active_head[max_active];
+      if (v == kNil) { max_active--; continue; }
+      active_head[max_active] = active_next[v];
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+
+      // Discharge v: push along admissible arcs, relabel when none is left
+      while (excess[v] > 0)
+      {
+        size_t a = current[v];
+        for (; a < offsets_[v + 1]; a++)
+        {
+          const Index u = head_[a];
+          if (residual[a] <= 0 || height[v] != height[u] + 1) { continue; }
+          const double delta = std::min(excess[v], residual[a]);
+          residual[a] -= delta;
+          residual[mate_[a]] += delta;
+          excess[v] -= delta;
+          if (excess[u] == 0 && u != sink) { excess[u] = delta; activate(u); }
+          else { excess[u] += delta; }
+          if (excess[v] == 0) { break; }
+        }
+        GRAPH_LIB_COUNT(EdgesScanned, a - current[v]);
+        current[v] = a;
+        if (excess[v] == 0) { break; }
+
+        const Index old_height = height[v];
+        if (all_head[old_height] == v && all_next[v] == kNil)
+        {
+          // Gap: v is alone at its height, so nothing at or above it can reach the sink
+          for (ptrdiff_t h = old_height; h <= max_height; h++)
+          {
+            for (Index x = all_head[h]; x != kNil; x = all_next[x]) { height[x] = dead; }
+            all_head[h] = kNil;
+            active_head[h] = kNil;
+          }
+          max_height = static_cast<ptrdiff_t>(old_height) - 1;
+          max_active = std::min(max_active, max_height);
+          break;
+        }
+
+        unlink(v);
+        Index lowest = dead;
+        for (size_t b = offsets_[v]; b < offsets_[v + 1]; b++)
+        {
+          if (residual[b] > 0) { lowest = std::min(lowest, height[head_[b]]); }
+        }
+        work += offsets_[v + 1] - offsets_[v] + 12;
+        if (lowest + 1 >= dead) { height[v] = dead; break; }
+        height[v] = lowest + 1;
+        current[v] = offsets_[v];
+        link(v);
+      }
+
+      if (work > relabel_interval)
+      {
+        // Vertices still holding excess are activated again by the relabel
+        work = 0;
+        globalRelabel();
+      }
+    }
+    return excess[sink];
+  }
+
+  //! \brief Dinic's algorithm, with an explicit stack for the blocking flow search.
+  double dinic(Index source, Index sink, std::vector<double>& residual) const
+  {
+    const size_t n = vertexCount();
+    std::vector<Index> level(n);
+    std::vector<size_t> current(n);
+    std::vector<Index> queue;
+    std::vector<size_t> path;
+    double total = 0;
+
+    while (true)
+    {
+      // Levels from the source over arcs with residual capacity
+      std::fill(level.begin(), level.end(), kNil);
+      level[source] = 0;
+      queue.assign(1, source);
+      for (size_t head = 0; head < queue.size() && level[sink] == kNil; head++)
+      {
+        const Index v = queue[head];
+        for (size_t a = offsets_[v]; a < offsets_[v + 1]; a++)
+        {
+          if (residual[a] <= 0 || level[head_[a]] != kNil) { continue; }
+          level[head_[a]] = level[v] + 1;
+          queue.push_back(head_[a]);
+        }
+      }
+      if (level[sink] == kNil) { return total; }
+
+      std::copy(offsets_.begin(), offsets_.end() - 1, current.begin());
+      path.clear();
+      Index v = source;
+      while (true)
+      {
+        if (v == sink)
+        {
+          double bottleneck = std::numeric_limits<double>::infinity();
+          for (size_t a : path) { bottleneck = std::min(bottleneck, residual[a]); }
+          size_t saturated = path.size();
+          for (size_t i = 0; i < path.size(); i++)
+          {
+            residual[path[i]] -= bottleneck;
+            residual[mate_[path[i]]] += bottleneck;
+            if (residual[path[i]] == 0 && saturated == path.size()) { saturated = i; }
+          }
+          total += bottleneck;
+          // Resume from the tail of the first saturated arc
+          path.resize(saturated);
+          v = path.empty() ? source : head_[path.back()];
+          continue;
+        }
+
+        size_t& a = current[v];
+        while (a < offsets_[v + 1] && (residual[a] <= 0 || level[head_[a]] != level[v] + 1)) { a++; }
+        if (a < offsets_[v + 1])
+        {
+          path.push_back(a);
+          v = head_[a];
+          continue;
+        }
+
+        // Dead end: retreat and never enter v again in this phase
+        level[v] = kNil;
+        if (path.empty()) { break; }
+        v = head_[mate_[path.back()]];
+        path.pop_back();
+        current[v]++;
+      }
+    }
+  }
+};
+
+//! \brief Compute a maximum flow and a minimum cut on a graph or graph view.
+//! The graph is snapshotted first. Callers issuing many queries should build a
+//! FlowNetwork once and query it.
+template <typename G> requires TraversableGraph<G>
+std::optional<FlowResult> maxFlow(const G& graph, unsigned int source_id, unsigned int sink_id, FlowMethod method = FlowMethod::PushRelabel)
+{
+  return FlowNetwork(CompactGraph::fromGraph(graph)).maxFlow(source_id, sink_id, method);
+}
+
+} // namespace graph_lib
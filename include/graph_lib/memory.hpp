@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <graph_lib/instrumentation.hpp>
+
+
+namespace graph_lib
+{
+enum class MemoryCategory : size_t
+{
+  VertexTable,
+  Payloads,
+  AdjacencyBuckets,
+  EdgeNodes,
+  AuxiliaryIndexes,
+  Count
+};
+
+//! \brief Bytes used by a graph, broken down by category.
+struct MemoryUsage
+{
+  //! \brief Vertex objects, their control blocks and the vertex set buckets and nodes.
+  size_t vertex_table = 0;
+  //! \brief The values stored in the vertices.
+  size_t payloads = 0;
+  //! \brief Buckets and nodes of the per-vertex adjacency sets.
+  size_t adjacency_buckets = 0;
+  //! \brief The Edge objects referenced by the adjacency sets.
+  size_t edge_nodes = 0;
+  //! \brief Indexes kept next to the adjacency, such as the ID -> vertex map.
+  size_t auxiliary_indexes = 0;
+
+  size_t total() const
+  {
+    return vertex_table + payloads + adjacency_buckets + edge_nodes + auxiliary_indexes;
+  }
+};
+
+//! \brief Byte counters shared by every tracking allocator of one graph.
+class MemoryAccount
+{
+public:
+  void add(MemoryCategory category, size_t bytes) noexcept
+  {
+    bytes_[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void subtract(MemoryCategory category, size_t bytes) noexcept
+  {
+    bytes_[static_cast<size_t>(category)].fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  size_t get(MemoryCategory category) const noexcept
+  {
+    return bytes_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+  }
+
+  //! \brief The bytes held by the tracked containers.
+  MemoryUsage usage() const noexcept
+  {
+    return {
+      get(MemoryCategory::VertexTable), get(MemoryCategory::Payloads), get(MemoryCategory::AdjacencyBuckets),
+      get(MemoryCategory::EdgeNodes), get(MemoryCategory::AuxiliaryIndexes)};
+  }
+
+private:
+  std::array<std::atomic<size_t>, static_cast<size_t>(MemoryCategory::Count)> bytes_{};
+};
+
+//! \brief Allocator that charges every allocation to a category of a MemoryAccount.
+//! An allocator without an account behaves like std::allocator. Copies of a
+//! container made with copy construction are not charged to the original account.
+template <typename U>
+class TrackingAllocator
+{
+public:
+  using value_type = U;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  TrackingAllocator() noexcept = default;
+
+  TrackingAllocator(std::shared_ptr<MemoryAccount> account, MemoryCategory category) noexcept:
+    account_(std::move(account)), category_(category)
+  {}
+
+  template <typename V>
+  TrackingAllocator(const TrackingAllocator<V>& other) noexcept:
+    account_(other.account()), category_(other.category())
+  {}
+
+  U* allocate(size_t n)
+  {
+    GRAPH_LIB_COUNT(Allocations, 1);
+    GRAPH_LIB_COUNT(BytesAllocated, n * sizeof(U));
+    U* ptr = std::allocator<U>().allocate(n);
+    if (account_) { account_->add(category_, n * sizeof(U)); }
+    return ptr;
+  }
+
+  void deallocate(U* ptr, size_t n) noexcept
+  {
+    if (account_) { account_->subtract(category_, n * sizeof(U)); }
+    std::allocator<U>().deallocate(ptr, n);
+  }
+
+  TrackingAllocator select_on_container_copy_construction() const noexcept { return {nullptr, category_}; }
+
+  const std::shared_ptr<MemoryAccount>& account() const noexcept { return account_; }
+  MemoryCategory category() const noexcept { return category_; }
+
+  template <typename V>
+  bool operator==(const TrackingAllocator<V>& rhs) const noexcept
+  {
+    return account_ == rhs.account() && category_ == rhs.category();
+  }
+
+private:
+  std::shared_ptr<MemoryAccount> account_;
+  MemoryCategory category_ = MemoryCategory::VertexTable;
+};
+
+//! \brief Bytes allocated for a vertex value, including the heap buffer of a std::string.
+template <typename T>
+size_t payloadBytes(const T&) noexcept { return sizeof(T); }
+
+template <typename C, typename Traits, typename A>
+size_t payloadBytes(const std::basic_string<C, Traits, A>& value) noexcept
+{
+  // Short strings live inside the object itself
+  const auto* data = reinterpret_cast<const char*>(value.data());
+  const auto* self = reinterpret_cast<const char*>(&value);
+  const bool local = data >= self && data < self + sizeof(value);
+  return sizeof(value) + (local ? 0 : (value.capacity() + 1) * sizeof(C));
+}
+
+} // namespace graph_lib
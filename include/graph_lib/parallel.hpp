@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace graph_lib
+{
+//! \brief Resolve a requested thread count.
+//!
+//! \param [in] threads The requested number of threads, 0 selects the hardware concurrency.
+//! \return unsigned The number of threads to use, at least 1.
+inline unsigned resolveThreads(unsigned threads) noexcept
+{
+  if (threads == 0) { threads = std::thread::hardware_concurrency(); }
+  return std::max(threads, 1u);
+}
+
+//! \brief Run a function over contiguous chunks of a range on several threads.
+//! The range is split into one chunk per thread. The calling thread runs the first chunk.
+//! The first exception thrown by any chunk is rethrown once every thread has finished.
+//!
+//! \param [in] first The first index of the range.
+//! \param [in] last One past the last index of the range.
+//! \param [in] threads The number of threads to use, 0 selects the hardware concurrency.
+//! \param [in] fn Callable invoked as fn(chunk_first, chunk_last, thread_index).
+template <typename F>
+void parallelForChunks(size_t first, size_t last, unsigned threads, F&& fn)
+{
+  if (last <= first) { return; }
+
+  const size_t count = last - first;
+  const size_t workers = std::min<size_t>(resolveThreads(threads), count);
+  const size_t chunk = (count + workers - 1) / workers;
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto run = [&](size_t worker)
+  {
+    const size_t chunk_first = first + worker * chunk;
+    const size_t chunk_last = std::min(last, chunk_first + chunk);
+    if (chunk_first >= chunk_last) { return; }
+    try { fn(chunk_first, chunk_last, static_cast<unsigned>(worker)); }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) { error = std::current_exception(); }
+    }
+  };
+
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(workers - 1);
+    for (size_t worker = 1; worker < workers; worker++) { pool.emplace_back(run, worker); }
+    run(0);
+  }
+
+  if (error) { std::rethrow_exception(error); }
+}
+
+//! \brief Run a function for every index of a range on several threads.
+//!
+//! \param [in] first The first index of the range.
+//! \param [in] last One past the last index of the range.
+//! \param [in] threads The number of threads to use, 0 selects the hardware concurrency.
+//! \param [in] fn Callable invoked as fn(index).
+template <typename F>
+void parallelFor(size_t first, size_t last, unsigned threads, F&& fn)
+{
+  parallelForChunks(first, last, threads, [&fn](size_t chunk_first, size_t chunk_last, unsigned)
+  {
+    for (size_t i = chunk_first; i < chunk_last; i++) { fn(i); }
+  });
+}
+
+//! \brief Run a function for every index of a range, handing out indices one at a time.
+//! Threads take the next unclaimed index as soon as they are free, which balances
+//! ranges whose items take very different amounts of work.
+//!
+//! \param [in] first The first index of the range.
+//! \param [in] last One past the last index of the range.
+//! \param [in] threads The number of threads to use, 0 selects the hardware concurrency.
+//! \param [in] fn Callable invoked as fn(index, thread_index).
+template <typename F>
+void parallelForDynamic(size_t first, size_t last, unsigned threads, F&& fn)
+{
+  if (last <= first) { return; }
+
+  const size_t workers = std::min<size_t>(resolveThreads(threads), last - first);
+  std::atomic<size_t> next{first};
+  parallelForChunks(0, workers, static_cast<unsigned>(workers), [&](size_t, size_t, unsigned thread)
+  {
+    for (size_t i = next++; i < last; i = next++) { fn(i, thread); }
+  });
+}
+
+} // namespace graph_lib
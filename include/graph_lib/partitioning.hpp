@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+
+
+namespace graph_lib
+{
+//! \brief How the streaming pass scores the parts a vertex could join.
+enum class PartitionMethod
+{
+  //! \brief Linear deterministic greedy: neighbors already in the part, scaled down linearly as the part fills.
+  LinearDeterministicGreedy,
+  //! \brief Fennel: neighbors already in the part minus a convex penalty on the part size.
+  Fennel
+};
+
+struct PartitionerOptions
+{
+  //! \brief The number of parts.
+  unsigned parts = 2;
+  PartitionMethod method = PartitionMethod::Fennel;
+  //! \brief How much larger than vertexCount() / parts a part may grow.
+  double imbalance = 1.1;
+  //! \brief The exponent of the Fennel size penalty, at least 1.
+  double fennel_gamma = 1.5;
+  //! \brief The maximum number of label propagation passes run after the streaming pass.
+  unsigned refinement_rounds = 10;
+};
+
+//! \brief An assignment of the vertices of a CompactGraph to parts.
+struct GraphPartition
+{
+  unsigned parts = 0;
+  //! \brief The part of each internal index.
+  std::vector<uint32_t> assignment;
+  //! \brief The number of vertices in each part.
+  std::vector<size_t> sizes;
+  //! \brief The number of edges whose ends are in different parts. Undirected edges are counted once.
+  size_t edge_cut = 0;
+
+  //! \brief The size of the largest part relative to a perfectly even split.
+  double imbalance() const noexcept
+  {
+    if (assignment.empty()) { return 1; }
+    return *std::max_element(sizes.begin(), sizes.end()) * static_cast<double>(parts) / assignment.size();
+  }
+};
+
+
+//! \brief Split a graph into balanced parts with few edges between them.
+//! Vertices are streamed once in index order and each joins the part scoring
+//! best under the chosen heuristic, among the parts below the size cap of
+//! imbalance * vertexCount() / parts. Label propagation then moves vertices to
+//! the part holding most of their neighbors, while the cap allows it, until a
+//! pass moves nothing. Directed edges count in both directions.
+//!
+//! \param [in] graph The graph, as a CSR snapshot.
+//! \param [in] options The number of parts, the heuristic and the balance constraint.
+//! \return GraphPartition The part of every vertex and the resulting edge cut.
+//! \exception std::invalid_argument Thrown when parts is 0, or imbalance or fennel_gamma is below 1.
+inline GraphPartition partitionGraph(const CompactGraph& graph, const PartitionerOptions& options = {})
+{
+  using Index = CompactGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("partition_graph");
+  if (options.parts == 0) { throw std::invalid_argument("A partition needs at least one part"); }
+  if (options.imbalance < 1) { throw std::invalid_argument("The imbalance must be at least 1"); }
+  if (!(options.fennel_gamma >= 1)) { throw std::invalid_argument("The Fennel exponent must be at least 1"); }
+
+  const size_t n = graph.vertexCount();
+  const unsigned k = options.parts;
+  constexpr uint32_t kUnassigned = std::numeric_limits<uint32_t>::max();
+  const CompactGraph reverse = graph.isDirected() ? graph.transpose() : CompactGraph();
+  auto forEachAdjacent = [&](Index v, auto&& fn)
+  {
+    for (Index u : graph.neighbors(v)) { fn(u); }
+    if (graph.isDirected()) { for (Index u : reverse.neighbors(v)) { fn(u); } }
+  };
+
+  GraphPartition result;
+  result.parts = k;
+  result.assignment.assign(n, kUnassigned);
+  result.sizes.assign(k, 0);
+  auto& assignment = result.assignment;
+  auto& sizes = result.sizes;
+
+  const size_t capacity = std::max<size_t>(1, static_cast<size_t>(std::ceil(options.imbalance * n / k)));
+  const double edges = graph.isDirected() ? graph.edgeCount() : graph.edgeCount() / 2.0;
+  const double alpha = n == 0 ? 0 : std::sqrt(static_cast<double>(k)) * edges / std::pow(static_cast<double>(n), 1.5);
+  std::vector<size_t> counts(k, 0);
+
+  for (Index v = 0; v < n; v++)
+  {
+    std::fill(counts.begin(), counts.end(), 0);
+    forEachAdjacent(v, [&](Index u) { if (assignment[u] != kUnassigned) { counts[assignment[u]]++; } });
+
+    uint32_t best = kUnassigned;
+    double best_score = -std::numeric_limits<double>::infinity();
+    for (uint32_t p = 0; p < k; p++)
+    {
+      if (sizes[p] >= capacity) { continue; }
+      const double score = options.method == PartitionMethod::LinearDeterministicGreedy
+                         ? counts[p] * (1 - static_cast<double>(sizes[p]) / capacity)
+                         : counts[p] - alpha * options.fennel_gamma * std::pow(static_cast<double>(sizes[p]), options.fennel_gamma - 1);
+      // Ties go to the smaller part, which spreads vertices without assigned neighbors evenly.
+      // The first open part is taken whatever its score, so a vertex always gets a part.
+      if (best == kUnassigned || score > best_score || (score == best_score && sizes[p] < sizes[best])) { best = p; best_score = score; }
+    }
+    assignment[v] = best;
+    sizes[best]++;
+  }
+
+  for (unsigned round = 0; round < options.refinement_rounds; round++)
+  {
+    size_t moved = 0;
+    for (Index v = 0; v < n; v++)
+    {
+      std::fill(counts.begin(), counts.end(), 0);
+      forEachAdjacent(v, [&](Index u) { if (u != v) { counts[assignment[u]]++; } });
+
+      const uint32_t current = assignment[v];
+      uint32_t best = current;
+      for (uint32_t p = 0; p < k; p++)
+      {
+        if (p != current && sizes[p] < capacity && counts[p] > counts[best]) { best = p; }
+      }
+      if (best == current) { continue; }
+      sizes[current]--;
+      sizes[best]++;
+      assignment[v] = best;
+      moved++;
+    }
+    GRAPH_LIB_COUNT(VerticesVisited, n);
+    if (moved == 0) { break; }
+  }
+
+  for (Index v = 0; v < n; v++)
+  {
+    for (Index u : graph.neighbors(v)) { result.edge_cut += assignment[u] != assignment[v]; }
+  }
+  if (!graph.isDirected()) { result.edge_cut /= 2; }
+  return result;
+}
+
+//! \brief Split a graph into balanced parts with few edges between them.
+//! The assignment is indexed by the internal indices of CompactGraph::fromGraph(graph),
+//! which follow the order of the external IDs.
+template <typename G> requires TraversableGraph<G>
+GraphPartition partitionGraph(const G& graph, const PartitionerOptions& options = {})
+{
+  return partitionGraph(CompactGraph::fromGraph(graph), options);
+}
+
+} // namespace graph_lib
@@ -0,0 +1,44 @@
+#pragma once
+
+// The graph classes and their iterators for the vertex types below are compiled
+// once into the graph_lib library. Targets linking it get GRAPH_LIB_PRECOMPILED,
+// which turns the list into extern template declarations so that including the
+// graph headers does not instantiate those classes again. Without the define,
+// or for any other vertex type, the headers are used as header-only templates.
+
+#include <cstdint>
+#include <string>
+
+//! \brief Call X(PREFIX, T) for every vertex type compiled into the library.
+#define GRAPH_LIB_FOR_EACH_PRECOMPILED_TYPE(X, PREFIX) \
+  X(PREFIX, int)                                       \
+  X(PREFIX, uint32_t)                                  \
+  X(PREFIX, uint64_t)                                  \
+  X(PREFIX, std::string)
+
+//! \brief Declare (PREFIX extern) or define (empty PREFIX) the instantiations for one vertex type.
+#define GRAPH_LIB_INSTANTIATE(PREFIX, T)                                                              \
+  PREFIX template struct graph_lib::Vertex<T>;                                                        \
+  PREFIX template class graph_lib::Graph<T>;                                                          \
+  PREFIX template class graph_lib::BasicGraph<T, graph_lib::Directed, graph_lib::Unweighted>;         \
+  PREFIX template class graph_lib::BasicGraph<T, graph_lib::Directed, graph_lib::Weighted>;           \
+  PREFIX template class graph_lib::BasicGraph<T, graph_lib::Undirected, graph_lib::Unweighted>;       \
+  PREFIX template class graph_lib::BasicGraph<T, graph_lib::Undirected, graph_lib::Weighted>;         \
+  PREFIX template struct graph_lib::GraphIteratorBase<T>;                                             \
+  PREFIX template struct graph_lib::GraphIterator<T>;                                                 \
+  PREFIX template struct graph_lib::BasicGraphIterator<T>;                                            \
+  PREFIX template struct graph_lib::DFSIterator<T>;                                                   \
+  PREFIX template struct graph_lib::BFSIterator<T>;
+
+#ifdef GRAPH_LIB_PRECOMPILED
+// GRAPH_LIB_INSTRUMENTATION adds members to the iterators, so the library and its users must agree on it
+#if defined(GRAPH_LIB_INSTRUMENTATION) != defined(GRAPH_LIB_PRECOMPILED_INSTRUMENTATION)
+#error "GRAPH_LIB_INSTRUMENTATION must match the graph_lib library: configure it with GRAPH_LIB_ENABLE_INSTRUMENTATION, or use the headers without linking it"
+#endif
+
+// Both graph headers include this one last, so every class is complete here
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+GRAPH_LIB_FOR_EACH_PRECOMPILED_TYPE(GRAPH_LIB_INSTANTIATE, extern)
+#endif
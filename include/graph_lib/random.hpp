@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+
+namespace graph_lib
+{
+//! \brief Counter-based random number generator (Philox4x32-10).
+//! The output is a pure function of (seed, stream, counter), so any thread can
+//! draw the value for any counter without sharing state. Results are therefore
+//! independent of how work is split between threads.
+class CounterRng
+{
+public:
+  //! \brief Construct a generator.
+  //!
+  //! \param [in] seed The key of the generator.
+  //! \param [in] stream Selects an independent sequence for the same seed.
+  constexpr CounterRng(uint64_t seed, uint64_t stream = 0) noexcept:
+    key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}, stream_(stream)
+  {}
+
+  //! \brief Get four 32 bit random words for a counter.
+  constexpr std::array<uint32_t, 4> block(uint64_t counter) const noexcept
+  {
+    std::array<uint32_t, 4> ctr{
+      static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+      static_cast<uint32_t>(stream_), static_cast<uint32_t>(stream_ >> 32)};
+    std::array<uint32_t, 2> key = key_;
+
+    for (int round = 0; round < 10; round++)
+    {
+      const uint64_t p0 = static_cast<uint64_t>(kMultiplier0) * ctr[0];
+      const uint64_t p1 = static_cast<uint64_t>(kMultiplier1) * ctr[2];
+      ctr = {
+        static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+        static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    return ctr;
+  }
+
+  //! \brief Get 64 random bits for a counter.
+  //!
+  //! \param [in] counter The position in the sequence.
+  //! \param [in] lane Selects one of the two 64 bit values of the block.
+  constexpr uint64_t bits(uint64_t counter, unsigned lane = 0) const noexcept
+  {
+    const auto words = block(counter);
+    const unsigned i = (lane & 1u) * 2;
+    return (static_cast<uint64_t>(words[i + 1]) << 32) | words[i];
+  }
+
+  //! \brief Get a uniform double in [0, 1) for a counter.
+  constexpr double uniform(uint64_t counter, unsigned lane = 0) const noexcept
+  {
+    return static_cast<double>(bits(counter, lane) >> 11) * 0x1.0p-53;
+  }
+
+  //! \brief Get a uniform integer in [0, bound) for a counter.
+  constexpr uint64_t below(uint64_t counter, uint64_t bound, unsigned lane = 0) const noexcept
+  {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(bits(counter, lane)) * bound) >> 64);
+  }
+
+private:
+  static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  std::array<uint32_t, 2> key_;
+  uint64_t stream_;
+};
+
+} // namespace graph_lib
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/parallel.hpp>
+#include <graph_lib/random.hpp>
+
+
+namespace graph_lib
+{
+struct RandomWalkOptions
+{
+  //! \brief The number of vertices in each walk, start included. Walks reaching a dead end are shorter.
+  unsigned walk_length = 80;
+  //! \brief The number of walks started from every vertex.
+  unsigned walks_per_vertex = 10;
+  //! \brief The node2vec return parameter p. Stepping back to the previous vertex is weighted 1 / p.
+  double return_param = 1.0;
+  //! \brief The node2vec in-out parameter q. Stepping away from the previous vertex is weighted 1 / q.
+  double in_out_param = 1.0;
+  //! \brief The seed of the walks. The same seed gives the same walks for any thread count.
+  uint64_t seed = 0;
+  //! \brief The number of worker threads, 0 selects the hardware concurrency.
+  unsigned threads = 0;
+  //! \brief Emit the internal indices of the snapshot instead of external vertex IDs.
+  //! Internal indices are dense, so they can index an embedding table directly.
+  bool internal_ids = false;
+};
+
+
+namespace detail
+{
+//! \brief The random draws of one walk. Each walk owns a stream of the counter based
+//! generator, so workers share no state and the walk does not depend on the worker.
+class WalkRng
+{
+public:
+  WalkRng(uint64_t seed, uint64_t walk) noexcept: rng_(seed, walk) {}
+
+  //! \brief The draws for one proposed step: a column below bound and two uniforms in [0, 1).
+  struct Draw
+  {
+    size_t column;
+    float coin;
+    float accept;
+  };
+
+  Draw next(size_t bound) noexcept
+  {
+    const auto words = rng_.block(counter_++);
+    const uint64_t bits = (static_cast<uint64_t>(words[1]) << 32) | words[0];
+    return {
+      static_cast<size_t>((static_cast<unsigned __int128>(bits) * bound) >> 64),
+      static_cast<float>(words[2] >> 8) * 0x1.0p-24f,
+      static_cast<float>(words[3] >> 8) * 0x1.0p-24f};
+  }
+
+private:
+  CounterRng rng_;
+  uint64_t counter_ = 0;
+};
+} // namespace detail
+
+
+//! \brief Parallel random walk generator for graph embeddings (DeepWalk and node2vec).
+//! Each vertex gets an alias table over the weights of its edges when the graph is
+//! built, so sampling a weighted neighbor takes one random draw and two array reads
+//! whatever the degree. Second order node2vec walks use rejection sampling on top of
+//! these tables: a neighbor is proposed from the first order table and accepted with
+//! its node2vec bias over the largest bias. This needs no per-edge-pair tables, and
+//! the test for an edge back to the previous vertex is a binary search of its sorted
+//! neighbor list. Walks are handed to a sink as they finish; nothing else is kept.
+class RandomWalker
+{
+public:
+  using Index = CompactGraph::Index;
+
+  //! \brief Build the alias tables of a graph.
+  //!
+  //! \param [in] graph The graph, as a CSR snapshot. Unweighted edges are sampled uniformly.
+  //! \param [in] threads The number of threads building the tables, 0 selects the hardware concurrency.
+  //! \exception std::invalid_argument Thrown when a weight is negative.
+  explicit RandomWalker(CompactGraph graph, unsigned threads = 0):
+    graph_(std::move(graph))
+  {
+    if (!graph_.isWeighted()) { return; }
+
+    const size_t n = graph_.vertexCount();
+    const auto& offsets = graph_.offsets();
+    probability_.resize(graph_.edgeCount());
+    alias_.resize(graph_.edgeCount());
+    dead_end_.assign(n, 0);
+    parallelForChunks(0, n, threads, [&](size_t first, size_t last, unsigned)
+    {
+      std::vector<double> scaled;
+      std::vector<Index> small, large;
+      for (size_t v = first; v < last; v++)
+      {
+        const auto weights = graph_.weights(static_cast<Index>(v));
+        dead_end_[v] = !buildAliasTable(weights, offsets[v], scaled, small, large);
+      }
+    });
+  }
+
+  //! \brief The snapshot the walks run on.
+  const CompactGraph& graph() const noexcept { return graph_; }
+
+  //! \brief Generate walks_per_vertex walks from every vertex and pass each one to a sink.
+  //! Walk w starts at internal index w % vertexCount(), so every round visits each vertex
+  //! once. With return_param and in_out_param both 1 the walks are first order (DeepWalk),
+  //! otherwise second order (node2vec). Each worker reuses one buffer for its walks, and
+  //! the sink is called from the workers concurrently: it must be thread safe, or keep
+  //! per-thread state indexed by the thread argument.
+  //!
+  //! \param [in] options Walk shape, node2vec parameters, seed and threads.
+  //! \param [in] sink Callable invoked as sink(std::span<const unsigned int> walk, unsigned thread).
+  //!                  The span is only valid during the call.
+  //! \return size_t The number of vertices over all walks.
+  //! \exception std::invalid_argument Thrown when return_param or in_out_param is not positive.
+  template <typename Sink> requires std::invocable<Sink&, std::span<const unsigned int>, unsigned>
+  size_t walk(const RandomWalkOptions& options, Sink&& sink) const
+  {
+    if (!(options.return_param > 0) || !(options.in_out_param > 0))
+    {
+      throw std::invalid_argument("node2vec parameters must be positive");
+    }
+    GRAPH_LIB_SCOPED_TIMER("random_walks");
+
+    const size_t n = graph_.vertexCount();
+    const size_t walks = n * options.walks_per_vertex;
+    if (walks == 0 || options.walk_length == 0) { return 0; }
+
+    const bool second_order = options.return_param != 1.0 || options.in_out_param != 1.0;
+    const Bias bias(options.return_param, options.in_out_param);
+    const unsigned threads = resolveThreads(options.threads);
+
+    std::vector<std::vector<unsigned int>> buffers(threads);
+    std::vector<size_t> emitted(threads, 0);
+    parallelForDynamic(0, walks, threads, [&](size_t w, unsigned thread)
+    {
+      auto& buffer = buffers[thread];
+      buffer.clear();
+      detail::WalkRng rng(options.seed, w);
+
+      Index previous = 0;
+      Index current = static_cast<Index>(w % n);
+      buffer.push_back(emit(current, options.internal_ids));
+      for (unsigned step = 1; step < options.walk_length; step++)
+      {
+        const auto next = (second_order && step > 1) ? sampleSecondOrder(previous, current, bias, rng) : sample(current, rng);
+        if (!next.has_value()) { break; }
+        previous = current;
+        current = *next;
+        buffer.push_back(emit(current, options.internal_ids));
+      }
+
+      GRAPH_LIB_COUNT(VerticesVisited, buffer.size());
+      emitted[thread] += buffer.size();
+      sink(std::span<const unsigned int>(buffer), thread);
+    });
+
+    size_t total = 0;
+    for (size_t count : emitted) { total += count; }
+    return total;
+  }
+
+private:
+  //! \brief The node2vec bias of each kind of step, scaled so the largest is 1.
+  struct Bias
+  {
+    Bias(double p, double q)
+    {
+      const double largest = std::max({1.0 / p, 1.0, 1.0 / q});
+      back = static_cast<float>(1.0 / p / largest);
+      stay = static_cast<float>(1.0 / largest);
+      out = static_cast<float>(1.0 / q / largest);
+    }
+
+    float back, stay, out;
+  };
+
+  //! \brief Fill the alias table of one row with Vose's method.
+  //! \return bool False when the weights add up to 0, leaving the row without a table.
+  bool buildAliasTable(std::span<const float> weights, size_t first, std::vector<double>& scaled,
+                       std::vector<Index>& small, std::vector<Index>& large)
+  {
+    double total = 0;
+    for (float weight : weights)
+    {
+      if (weight < 0) { throw std::invalid_argument("Random walks need non-negative edge weights"); }
+      total += weight;
+    }
+    if (!(total > 0)) { return false; }
+
+    const size_t degree = weights.size();
+    scaled.resize(degree);
+    small.clear();
+    large.clear();
+    for (size_t i = 0; i < degree; i++)
+    {
+      scaled[i] = weights[i] * degree / total;
+      (scaled[i] < 1.0 ? small : large).push_back(static_cast<Index>(i));
+    }
+    while (!small.empty() && !large.empty())
+    {
+      const Index less = small.back(), more = large.back();
+      small.pop_back();
+      probability_[first + less] = static_cast<float>(scaled[less]);
+      alias_[first + less] = more;
+      scaled[more] -= 1.0 - scaled[less];
+      if (scaled[more] < 1.0) { large.pop_back(); small.push_back(more); }
+    }
+    // Whatever is left is 1 up to rounding
+    for (Index i : large) { probability_[first + i] = 1.0f; alias_[first + i] = i; }
+    for (Index i : small) { probability_[first + i] = 1.0f; alias_[first + i] = i; }
+    return true;
+  }
+
+  //! \brief Sample a neighbor of v by edge weight. No value when v is a dead end.
+  std::optional<Index> sample(Index v, detail::WalkRng& rng) const noexcept
+  {
+    auto draw = propose(v, rng);
+    if (!draw.has_value()) { return {}; }
+    return graph_.targets()[*draw];
+  }
+
+  //! \brief Sample the node2vec step from current, having arrived from previous.
+  std::optional<Index> sampleSecondOrder(Index previous, Index current, const Bias& bias, detail::WalkRng& rng) const noexcept
+  {
+    const auto back_row = graph_.neighbors(previous);
+    while (true)
+    {
+      float accept = 0;
+      auto edge = propose(current, rng, &accept);
+      if (!edge.has_value()) { return {}; }
+
+      const Index next = graph_.targets()[*edge];
+      const float keep = next == previous ? bias.back :
+                         std::binary_search(back_row.begin(), back_row.end(), next) ? bias.stay : bias.out;
+      if (accept < keep) { return next; }
+    }
+  }
+
+  //! \brief Draw an edge leaving v from its alias table, as an index into targets().
+  std::optional<size_t> propose(Index v, detail::WalkRng& rng, float* accept = nullptr) const noexcept
+  {
+    const size_t degree = graph_.degree(v);
+    if (degree == 0 || (!dead_end_.empty() && dead_end_[v])) { return {}; }
+
+    GRAPH_LIB_COUNT(EdgesScanned, 1);
+    const auto draw = rng.next(degree);
+    if (accept != nullptr) { *accept = draw.accept; }
+    const size_t first = graph_.offsets()[v];
+    if (probability_.empty() || draw.coin < probability_[first + draw.column]) { return first + draw.column; }
+    return first + alias_[first + draw.column];
+  }
+
+  unsigned int emit(Index v, bool internal) const noexcept { return internal ? v : graph_.externalId(v); }
+
+  CompactGraph graph_;
+  //! \brief The alias tables, parallel to targets(). Column i keeps itself with probability_[i]
+  //! and otherwise yields alias_[i]. Empty for unweighted graphs, which sample uniformly.
+  std::vector<float> probability_;
+  std::vector<Index> alias_;
+  //! \brief Vertices whose edges all weigh 0. Empty for unweighted graphs.
+  std::vector<uint8_t> dead_end_;
+};
+
+//! \brief Generate random walks on a graph or graph view.
+//! The graph is snapshotted and its alias tables built for this call. Callers generating
+//! walks repeatedly should build a RandomWalker once and call walk on it.
+template <typename G, typename Sink> requires TraversableGraph<G>
+size_t randomWalks(const G& graph, const RandomWalkOptions& options, Sink&& sink)
+{
+  return RandomWalker(CompactGraph::fromGraph(graph), options.threads).walk(options, std::forward<Sink>(sink));
+}
+
+} // namespace graph_lib
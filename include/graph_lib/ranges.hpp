@@ -0,0 +1,162 @@
+#pragma once
+
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <unordered_set>
+
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/iterators.hpp>
+#include <graph_lib/vertex.hpp>
+
+
+namespace graph_lib
+{
+//! \brief Lazy single-source traversal as an input view.
+//! The traversal state lives in the view and only advances when the iterator is
+//! incremented, so adaptors such as std::views::take stop the search early.
+//! A vertex's neighbors are expanded only when the iterator moves past it.
+//! Every reachable vertex is produced once. The view is single pass.
+template <typename T, TraversalOrder Order> requires Graphable<T>
+class TraversalView : public std::ranges::view_interface<TraversalView<T, Order>>
+{
+public:
+  using VertexPtr = std::shared_ptr<Vertex<T>>;
+
+  class iterator
+  {
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using difference_type  = std::ptrdiff_t;
+    using value_type       = VertexPtr;
+
+    iterator() = default;
+    explicit iterator(TraversalView* view): view_(view) {}
+
+    const VertexPtr& operator*() const { return view_->current_; }
+    const VertexPtr* operator->() const { return &view_->current_; }
+
+    iterator& operator++() { view_->advance(); return *this; }
+    void operator++(int) { view_->advance(); }
+
+    friend bool operator==(const iterator& itr, std::default_sentinel_t) { return itr.atEnd(); }
+
+  private:
+    bool atEnd() const { return view_->current_ == nullptr; }
+
+    TraversalView* view_ = nullptr;
+  };
+
+  TraversalView() = default;
+
+  //! \brief Construct a traversal starting at a vertex, which may be null for an empty traversal.
+  explicit TraversalView(VertexPtr source):
+    current_(std::move(source))
+  {
+    if (current_ != nullptr) { visited_.insert(current_.get()); }
+  }
+
+  TraversalView(TraversalView&&) = default;
+  TraversalView& operator=(TraversalView&&) = default;
+
+  iterator begin() { return iterator(this); }
+  std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+private:
+  std::unordered_set<const Vertex<T>*> visited_;
+  std::deque<VertexPtr> frontier_;
+  VertexPtr current_;
+
+  void advance()
+  {
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    for (const auto& edge : current_->adj)
+    {
+      GRAPH_LIB_COUNT(EdgesScanned, 1);
+      GRAPH_LIB_COUNT(HashLookups, 1);
+      // Breadth first marks vertices when queued, depth first when produced
+      if constexpr (Order == TraversalOrder::BreadthFirst)
+      {
+        if (visited_.insert((*edge).vertex.get()).second) { frontier_.push_back((*edge).vertex); }
+      }
+      else
+      {
+        if (!visited_.contains((*edge).vertex.get())) { frontier_.push_back((*edge).vertex); }
+      }
+    }
+
+    current_ = nullptr;
+    if constexpr (Order == TraversalOrder::BreadthFirst)
+    {
+      if (frontier_.empty()) { return; }
+      current_ = std::move(frontier_.front());
+      frontier_.pop_front();
+    }
+    else
+    {
+      while (!frontier_.empty())
+      {
+        auto next = std::move(frontier_.back());
+        frontier_.pop_back();
+        if (visited_.insert(next.get()).second) { current_ = std::move(next); return; }
+      }
+    }
+  }
+};
+
+template <typename T> requires Graphable<T>
+using DFSView = TraversalView<T, TraversalOrder::DepthFirst>;
+
+template <typename T> requires Graphable<T>
+using BFSView = TraversalView<T, TraversalOrder::BreadthFirst>;
+
+//! \brief Projection from an adjacency set entry to the vertex it points to.
+template <typename T> requires Graphable<T>
+struct EdgeTarget
+{
+  const std::shared_ptr<Vertex<T>>& operator()(const std::unique_ptr<Edge<T>>& edge) const noexcept { return (*edge).vertex; }
+};
+
+template <typename T> requires Graphable<T>
+using NeighborView = std::ranges::transform_view<std::ranges::ref_view<const typename Vertex<T>::AdjacencySet>, EdgeTarget<T>>;
+
+//! \brief The origins of the edges to a vertex, read from the incoming index, most recent first.
+template <typename T> requires Graphable<T>
+class PredecessorView : public std::ranges::view_interface<PredecessorView<T>>
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using difference_type  = std::ptrdiff_t;
+    using value_type       = Vertex<T>;
+
+    iterator() = default;
+    explicit iterator(const IncomingEdge<T>* entry): entry_(entry) {}
+
+    const Vertex<T>& operator*() const { return *entry_->vertex; }
+    const Vertex<T>* operator->() const { return entry_->vertex.get(); }
+
+    iterator& operator++() { entry_ = entry_->next; return *this; }
+    iterator operator++(int) { auto previous = *this; entry_ = entry_->next; return previous; }
+
+    bool operator==(const iterator&) const = default;
+    friend bool operator==(const iterator& itr, std::default_sentinel_t) { return itr.entry_ == nullptr; }
+
+  private:
+    const IncomingEdge<T>* entry_ = nullptr;
+  };
+
+  PredecessorView() = default;
+  explicit PredecessorView(const IncomingEdge<T>* head): head_(head) {}
+
+  iterator begin() const { return iterator(head_); }
+  std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+private:
+  const IncomingEdge<T>* head_ = nullptr;
+};
+
+} // namespace graph_lib
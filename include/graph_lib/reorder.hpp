@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/instrumentation.hpp>
+
+
+namespace graph_lib
+{
+enum class ReorderMethod
+{
+  //! \brief Vertices with above average degree first, by descending degree. Others keep their order.
+  HubSort,
+  //! \brief Every vertex by descending degree.
+  DegreeSort,
+  //! \brief Reverse Cuthill–McKee, which keeps neighbors close and reduces the bandwidth.
+  ReverseCuthillMcKee,
+  //! \brief Gorder-style greedy ordering that places vertices sharing neighbors in the same window.
+  Gorder
+};
+
+//! \brief A permutation, where vertex v moves to internal index permutation[v].
+using Permutation = std::vector<CompactGraph::Index>;
+
+
+namespace detail
+{
+using Index = CompactGraph::Index;
+
+//! \brief Turn a sequence of vertices, in their new order, into a permutation.
+inline Permutation sequenceToPermutation(const std::vector<Index>& sequence)
+{
+  Permutation permutation(sequence.size());
+  for (Index i = 0; i < sequence.size(); i++) { permutation[sequence[i]] = i; }
+  return permutation;
+}
+
+//! \brief In-degree plus out-degree for directed graphs, degree for undirected graphs.
+inline std::vector<size_t> totalDegrees(const CompactGraph& graph)
+{
+  std::vector<size_t> degrees(graph.vertexCount());
+  for (Index v = 0; v < degrees.size(); v++) { degrees[v] = graph.degree(v); }
+  if (graph.isDirected()) { for (Index dest : graph.targets()) { degrees[dest]++; } }
+  return degrees;
+}
+
+//! \brief Vertices sorted by descending degree, ties kept in index order.
+inline std::vector<Index> byDescendingDegree(const std::vector<size_t>& degrees)
+{
+  std::vector<Index> sequence(degrees.size());
+  for (Index v = 0; v < sequence.size(); v++) { sequence[v] = v; }
+  std::stable_sort(sequence.begin(), sequence.end(), [&](Index a, Index b) { return degrees[a] > degrees[b]; });
+  return sequence;
+}
+} // namespace detail
+
+
+//! \brief Compute the hub sorting permutation.
+inline Permutation hubSortOrder(const CompactGraph& graph)
+{
+  const auto degrees = detail::totalDegrees(graph);
+  const double total = std::accumulate(degrees.begin(), degrees.end(), 0.0);
+  const double average = degrees.empty() ? 0.0 : total / degrees.size();
+
+  std::vector<detail::Index> sequence = detail::byDescendingDegree(degrees);
+  auto hubs_end = std::stable_partition(sequence.begin(), sequence.end(),
+                                        [&](detail::Index v) { return degrees[v] > average; });
+  std::sort(hubs_end, sequence.end());
+  return detail::sequenceToPermutation(sequence);
+}
+
+//! \brief Compute the permutation ordering every vertex by descending degree.
+inline Permutation degreeSortOrder(const CompactGraph& graph)
+{
+  return detail::sequenceToPermutation(detail::byDescendingDegree(detail::totalDegrees(graph)));
+}
+
+//! \brief Compute the Reverse Cuthill–McKee permutation.
+//! Edge direction is ignored. Each component starts from its lowest degree vertex.
+inline Permutation reverseCuthillMcKeeOrder(const CompactGraph& graph)
+{
+  using detail::Index;
+  const size_t n = graph.vertexCount();
+  const auto degrees = detail::totalDegrees(graph);
+  const CompactGraph transposed = graph.isDirected() ? graph.transpose() : CompactGraph();
+  const CompactGraph& reverse = graph.isDirected() ? transposed : graph;
+
+  std::vector<Index> starts(n);
+  for (Index v = 0; v < n; v++) { starts[v] = v; }
+  std::stable_sort(starts.begin(), starts.end(), [&](Index a, Index b) { return degrees[a] < degrees[b]; });
+
+  std::vector<Index> sequence;
+  sequence.reserve(n);
+  std::vector<bool> visited(n, false);
+  std::vector<Index> candidates;
+  for (Index start : starts)
+  {
+    if (visited[start]) { continue; }
+    visited[start] = true;
+    size_t head = sequence.size();
+    sequence.push_back(start);
+
+    while (head < sequence.size())
+    {
+      const Index v = sequence[head++];
+      candidates.clear();
+      for (Index u : graph.neighbors(v)) { if (!visited[u]) { visited[u] = true; candidates.push_back(u); } }
+      if (graph.isDirected())
+      {
+        for (Index u : reverse.neighbors(v)) { if (!visited[u]) { visited[u] = true; candidates.push_back(u); } }
+      }
+      std::stable_sort(candidates.begin(), candidates.end(), [&](Index a, Index b) { return degrees[a] < degrees[b]; });
+      sequence.insert(sequence.end(), candidates.begin(), candidates.end());
+    }
+  }
+
+  std::reverse(sequence.begin(), sequence.end());
+  return detail::sequenceToPermutation(sequence);
+}
+
+//! \brief Compute a Gorder-style permutation.
+//! Vertices are placed greedily, each time choosing the vertex with the most
+//! neighbor and sibling (shared in-neighbor) relations to the last `window`
+//! placed vertices. Sibling relations through vertices with more than
+//! sqrt(n) out-edges are ignored, as in the original Gorder heuristic.
+//!
+//! \param [in] graph The graph to order.
+//! \param [in] window The number of recently placed vertices that contribute to the score.
+//! \return Permutation The permutation.
+inline Permutation gorderOrder(const CompactGraph& graph, unsigned window = 5)
+{
+  using detail::Index;
+  const size_t n = graph.vertexCount();
+  if (n == 0) { return {}; }
+
+  const CompactGraph transposed = graph.isDirected() ? graph.transpose() : CompactGraph();
+  const CompactGraph& reverse = graph.isDirected() ? transposed : graph;
+  const size_t hub_degree = std::max<size_t>(32, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+  const auto fallback = detail::byDescendingDegree(detail::totalDegrees(graph));
+
+  std::vector<int64_t> score(n, 0);
+  std::vector<bool> placed(n, false);
+  std::priority_queue<std::pair<int64_t, Index>> heap;
+
+  auto bump = [&](Index u, int64_t delta)
+  {
+    if (placed[u]) { return; }
+    score[u] += delta;
+    if (score[u] > 0) { heap.emplace(score[u], u); }
+  };
+  auto update = [&](Index v, int64_t delta)
+  {
+    for (Index u : graph.neighbors(v)) { bump(u, delta); }
+    for (Index u : reverse.neighbors(v))
+    {
+      if (graph.isDirected()) { bump(u, delta); }
+      if (graph.degree(u) > hub_degree) { continue; }
+      for (Index sibling : graph.neighbors(u)) { if (sibling != v) { bump(sibling, delta); } }
+    }
+  };
+
+  std::vector<Index> sequence;
+  sequence.reserve(n);
+  size_t next_fallback = 0;
+  while (sequence.size() < n)
+  {
+    // Drop stale heap entries, whose score changed or whose vertex was placed
+    while (!heap.empty() && (placed[heap.top().second] || score[heap.top().second] != heap.top().first)) { heap.pop(); }
+
+    Index v;
+    if (!heap.empty()) { v = heap.top().second; heap.pop(); }
+    else
+    {
+      while (placed[fallback[next_fallback]]) { next_fallback++; }
+      v = fallback[next_fallback];
+    }
+
+    placed[v] = true;
+    sequence.push_back(v);
+    update(v, 1);
+    if (sequence.size() > window) { update(sequence[sequence.size() - 1 - window], -1); }
+  }
+  return detail::sequenceToPermutation(sequence);
+}
+
+//! \brief Compute the permutation of a reordering method.
+inline Permutation computeOrder(const CompactGraph& graph, ReorderMethod method)
+{
+  switch (method)
+  {
+    case ReorderMethod::HubSort:             return hubSortOrder(graph);
+    case ReorderMethod::DegreeSort:          return degreeSortOrder(graph);
+    case ReorderMethod::ReverseCuthillMcKee: return reverseCuthillMcKeeOrder(graph);
+    default:                                 return gorderOrder(graph);
+  }
+}
+
+//! \brief Reorder the storage of a graph for cache locality.
+//! External vertex IDs stay valid through CompactGraph::internalId().
+//!
+//! \param [in,out] graph The graph to relabel.
+//! \param [in] method The reordering method.
+//! \return Permutation The applied permutation, where vertex v moved to permutation[v].
+inline Permutation reorder(CompactGraph& graph, ReorderMethod method)
+{
+  GRAPH_LIB_SCOPED_TIMER("reorder");
+  Permutation permutation = computeOrder(graph, method);
+  graph.relabel(permutation);
+  return permutation;
+}
+
+} // namespace graph_lib
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/iterators.hpp>
+#include <graph_lib/vertex.hpp>
+
+
+namespace graph_lib
+{
+//! \brief Limits on the work a resumable traversal does before it suspends.
+//! Whichever limit is reached first suspends the traversal.
+struct TraversalBudget
+{
+  //! \brief The number of edges to scan.
+  size_t edges = std::numeric_limits<size_t>::max();
+  //! \brief The wall clock time to run for. Zero means no time limit.
+  std::chrono::microseconds time{0};
+
+  static TraversalBudget ofEdges(size_t edges) { return {edges, std::chrono::microseconds{0}}; }
+  static TraversalBudget ofTime(std::chrono::microseconds time) { return {std::numeric_limits<size_t>::max(), time}; }
+};
+
+enum class TraversalStatus
+{
+  //! \brief The budget ran out. Calling run() again continues where the traversal stopped.
+  Suspended,
+  //! \brief Every reachable vertex was produced.
+  Finished
+};
+
+//! \brief Single-source traversal that runs in budgeted slices.
+//! All of the traversal state lives in the object, so a long search can be
+//! suspended when its budget runs out and resumed later, possibly interleaved
+//! with other work on the same thread. Suspension can happen in the middle of a
+//! vertex's neighbor list. Every reachable vertex is produced once, with its depth
+//! in the traversal tree. The graph must outlive the traversal and must not be
+//! modified while a traversal is in progress.
+//!
+//! \tparam G The graph or graph view.
+//! \tparam Order Depth first or breadth first.
+template <typename G, TraversalOrder Order> requires TraversableGraph<G>
+class ResumableTraversal
+{
+public:
+  using VertexPtr = typename G::VertexPtr;
+
+  //! \brief Prepare a traversal from a vertex. Nothing is visited until run() is called.
+  //!
+  //! \param [in] graph The graph or graph view.
+  //! \param [in] source_id The ID of the vertex to start from. A missing vertex gives an empty traversal.
+  ResumableTraversal(const G& graph, unsigned int source_id):
+    graph_(&graph)
+  {
+    auto source = graph.getVertex(source_id);
+    if (!source.has_value()) { return; }
+    if constexpr (Order == TraversalOrder::BreadthFirst) { visited_.insert(&**source); }
+    frontier_.emplace_back(*source, 0);
+  }
+
+  //! \brief Continue the traversal until it finishes or the budget runs out.
+  //!
+  //! \param [in] budget The work allowed in this slice.
+  //! \param [in] sink Called as sink(const VertexPtr& vertex, unsigned depth) for each vertex produced in this slice.
+  //! \return TraversalStatus Whether the traversal finished or was suspended.
+  template <typename F>
+  TraversalStatus run(const TraversalBudget& budget, F&& sink)
+  {
+    GRAPH_LIB_SCOPED_TIMER("resumable_traversal");
+    const auto start = std::chrono::steady_clock::now();
+    size_t edges = 0;
+    size_t steps = 0;
+
+    // The clock is only read every kClockInterval steps
+    auto exhausted = [&]()
+    {
+      if (edges >= budget.edges) { return true; }
+      if (budget.time.count() == 0 || ++steps % kClockInterval != 0) { return false; }
+      return std::chrono::steady_clock::now() - start >= budget.time;
+    };
+
+    while (true)
+    {
+      // Scan the rest of the neighbor list of the vertex being expanded
+      for (; next_ < pending_.size(); next_++)
+      {
+        if (exhausted()) { return TraversalStatus::Suspended; }
+        edges++;
+        edges_scanned_++;
+        GRAPH_LIB_COUNT(EdgesScanned, 1);
+        GRAPH_LIB_COUNT(HashLookups, 1);
+
+        auto& dest = pending_[next_];
+        if constexpr (Order == TraversalOrder::BreadthFirst)
+        {
+          if (visited_.insert(&*dest).second) { frontier_.emplace_back(std::move(dest), depth_ + 1); }
+        }
+        else
+        {
+          if (!visited_.contains(&*dest)) { frontier_.emplace_back(std::move(dest), depth_ + 1); }
+        }
+      }
+      pending_.clear();
+      next_ = 0;
+
+      // Produce and expand the next vertex of the frontier
+      if (frontier_.empty()) { finished_ = true; return TraversalStatus::Finished; }
+      if (exhausted()) { return TraversalStatus::Suspended; }
+      if (!nextVertex()) { finished_ = true; return TraversalStatus::Finished; }
+      sink(current_, depth_);
+      graph_->forEachNeighbor(*current_, [this](const VertexPtr& dest, float) { pending_.push_back(dest); });
+    }
+  }
+
+  //! \brief Continue the traversal until it finishes or the budget runs out.
+  //!
+  //! \param [in] budget The work allowed in this slice.
+  //! \return std::vector<VertexPtr> The vertices produced in this slice, in traversal order.
+  std::vector<VertexPtr> run(const TraversalBudget& budget)
+  {
+    std::vector<VertexPtr> produced;
+    run(budget, [&produced](const VertexPtr& vertex, unsigned) { produced.push_back(vertex); });
+    return produced;
+  }
+
+  //! \brief Whether every reachable vertex was produced.
+  bool finished() const noexcept { return finished_; }
+
+  //! \brief The number of vertices produced so far.
+  size_t verticesProduced() const noexcept { return vertices_produced_; }
+
+  //! \brief The number of edges scanned so far.
+  size_t edgesScanned() const noexcept { return edges_scanned_; }
+
+private:
+  static constexpr size_t kClockInterval = 64;
+
+  const G* graph_;
+  std::unordered_set<const Vertex<typename G::ValueType>*> visited_;
+  std::deque<std::pair<VertexPtr, unsigned>> frontier_;
+  //! \brief The last produced vertex.
+  VertexPtr current_;
+  unsigned depth_ = 0;
+  //! \brief The neighbors of the current vertex, scanned up to next_.
+  std::vector<VertexPtr> pending_;
+  size_t next_ = 0;
+  size_t vertices_produced_ = 0;
+  size_t edges_scanned_ = 0;
+  bool finished_ = false;
+
+  //! \brief Take the next vertex to produce off the frontier.
+  //! \return bool False when the frontier is empty.
+  bool nextVertex()
+  {
+    while (!frontier_.empty())
+    {
+      if constexpr (Order == TraversalOrder::BreadthFirst)
+      {
+        std::tie(current_, depth_) = std::move(frontier_.front());
+        frontier_.pop_front();
+      }
+      else
+      {
+        std::tie(current_, depth_) = std::move(frontier_.back());
+        frontier_.pop_back();
+        // Depth first marks vertices when produced, so stale stack entries are skipped here
+        if (!visited_.insert(&*current_).second) { continue; }
+      }
+      vertices_produced_++;
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+      return true;
+    }
+    return false;
+  }
+};
+
+template <typename G> requires TraversableGraph<G>
+using ResumableBFS = ResumableTraversal<G, TraversalOrder::BreadthFirst>;
+
+template <typename G> requires TraversableGraph<G>
+using ResumableDFS = ResumableTraversal<G, TraversalOrder::DepthFirst>;
+
+//! \brief Prepare a resumable breadth first traversal of a graph or graph view.
+template <typename G> requires TraversableGraph<G>
+ResumableBFS<G> resumableBfs(const G& graph, unsigned int source_id) { return {graph, source_id}; }
+
+//! \brief Prepare a resumable depth first traversal of a graph or graph view.
+template <typename G> requires TraversableGraph<G>
+ResumableDFS<G> resumableDfs(const G& graph, unsigned int source_id) { return {graph, source_id}; }
+
+} // namespace graph_lib
@@ -0,0 +1,490 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/partitioning.hpp>
+
+
+namespace graph_lib
+{
+//! \brief The vertices of one part of a partitioned graph, with the edges leaving them.
+//! Internal indices [0, owned) are the vertices of the shard and [owned, vertexCount())
+//! are ghosts: vertices of other shards that owned vertices have edges to. Ghost
+//! rows are empty. Rows are stored as directed edges, so an undirected graph keeps
+//! both directions of every edge, as in CompactGraph.
+struct Shard
+{
+  using Index = CompactGraph::Index;
+
+  //! \brief The index of this shard among all shards.
+  unsigned id = 0;
+  CompactGraph graph;
+  size_t owned = 0;
+  //! \brief For each ghost, at ghost - owned, the shard owning it.
+  std::vector<unsigned> ghost_owner;
+  //! \brief For each ghost, at ghost - owned, its internal index in the shard owning it.
+  std::vector<Index> ghost_index;
+
+  bool isGhost(Index v) const noexcept { return v >= owned; }
+};
+
+//! \brief A distance proposed to a vertex owned by the receiving shard.
+struct ShardMessage
+{
+  //! \brief The internal index of the vertex in the receiving shard.
+  CompactGraph::Index target;
+  float value;
+};
+
+//! \brief Moves messages between the shards of a sharded computation.
+//! Computations run in supersteps: each shard works on its own vertices and then
+//! every shard calls exchange() once, which delivers what was sent to it and
+//! acts as a barrier. Implementations only have to provide that all to all step.
+class ShardTransport
+{
+public:
+  virtual ~ShardTransport() = default;
+
+  //! \brief The index of the calling shard.
+  virtual unsigned rank() const noexcept = 0;
+
+  //! \brief The number of shards.
+  virtual unsigned size() const noexcept = 0;
+
+  //! \brief Send one batch of messages to every shard and receive the batches sent to this one.
+  //! Every shard must call it the same number of times.
+  //!
+  //! \param [in,out] outgoing One batch per shard, indexed by destination, cleared on return.
+  //! \param [out] incoming The messages sent to this shard in this superstep.
+  //! \return bool Whether any shard sent a message in this superstep.
+  //! \exception std::runtime_error Thrown when the transport fails.
+  virtual bool exchange(std::vector<std::vector<ShardMessage>>& outgoing, std::vector<ShardMessage>& incoming) = 0;
+};
+
+
+//! \brief Mailboxes shared by shards running as threads of one process.
+//! Create one hub for all shards and one SharedMemoryTransport per shard thread.
+class SharedMemoryHub
+{
+public:
+  explicit SharedMemoryHub(unsigned size): size_(size), mailboxes_(size * size), barrier_(size) {}
+
+  unsigned size() const noexcept { return size_; }
+
+private:
+  unsigned size_;
+  //! \brief The batch from shard i to shard j, at i * size + j.
+  std::vector<std::vector<ShardMessage>> mailboxes_;
+  std::barrier<> barrier_;
+
+  friend class SharedMemoryTransport;
+};
+
+//! \brief Transport between shards running as threads of one process, through a SharedMemoryHub.
+class SharedMemoryTransport : public ShardTransport
+{
+public:
+  SharedMemoryTransport(SharedMemoryHub& hub, unsigned rank) noexcept: hub_(hub), rank_(rank) {}
+
+  unsigned rank() const noexcept override { return rank_; }
+  unsigned size() const noexcept override { return hub_.size_; }
+
+  bool exchange(std::vector<std::vector<ShardMessage>>& outgoing, std::vector<ShardMessage>& incoming) override
+  {
+    const unsigned n = hub_.size_;
+    outgoing.resize(n);
+    for (unsigned to = 0; to < n; to++)
+    {
+      hub_.mailboxes_[rank_ * n + to].swap(outgoing[to]);
+      outgoing[to].clear();
+    }
+    hub_.barrier_.arrive_and_wait();
+
+    incoming.clear();
+    bool any = false;
+    for (unsigned from = 0; from < n; from++)
+    {
+      for (unsigned to = 0; to < n; to++) { any |= !hub_.mailboxes_[from * n + to].empty(); }
+      const auto& batch = hub_.mailboxes_[from * n + rank_];
+      incoming.insert(incoming.end(), batch.begin(), batch.end());
+    }
+    // Nobody may refill a mailbox before every shard has read it
+    hub_.barrier_.arrive_and_wait();
+    return any;
+  }
+
+private:
+  SharedMemoryHub& hub_;
+  unsigned rank_;
+};
+
+
+//! \brief Create connected Unix domain sockets between every pair of shards.
+//! Call it before forking the worker processes. Shard i talks to shard j through
+//! mesh[i][j]; mesh[i][i] is -1. Each process should close the rows of the other ranks.
+//!
+//! \param [in] size The number of shards.
+//! \return std::vector<std::vector<int>> The socket descriptors, by rank then peer.
+//! \exception std::runtime_error Thrown when a socket pair cannot be created.
+inline std::vector<std::vector<int>> socketMesh(unsigned size)
+{
+  std::vector<std::vector<int>> mesh(size, std::vector<int>(size, -1));
+  for (unsigned i = 0; i < size; i++)
+  {
+    for (unsigned j = i + 1; j < size; j++)
+    {
+      int pair[2];
+      if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+      {
+        for (auto& row : mesh) { for (int fd : row) { if (fd >= 0) { ::close(fd); } } }
+        throw std::runtime_error(std::string("Failed to create a socket pair: ") + std::strerror(errno));
+      }
+      mesh[i][j] = pair[0];
+      mesh[j][i] = pair[1];
+    }
+  }
+  return mesh;
+}
+
+//! \brief Transport between shards over connected stream sockets, such as the Unix
+//! domain sockets made by socketMesh(). Works between processes and between threads.
+//! Each superstep writes a frame of (whether the sender sent anything to anyone,
+//! message count, messages) to every peer while reading theirs, multiplexed with
+//! poll() so large batches cannot deadlock.
+class SocketTransport : public ShardTransport
+{
+public:
+  //! \brief Take ownership of one socket per peer.
+  //!
+  //! \param [in] rank The index of this shard.
+  //! \param [in] peers The socket connected to each shard, -1 at rank.
+  SocketTransport(unsigned rank, std::vector<int> peers) noexcept: rank_(rank), peers_(std::move(peers)) {}
+
+  SocketTransport(const SocketTransport&) = delete;
+  SocketTransport& operator=(const SocketTransport&) = delete;
+
+  ~SocketTransport() override
+  {
+    for (int fd : peers_) { if (fd >= 0) { ::close(fd); } }
+  }
+
+  unsigned rank() const noexcept override { return rank_; }
+  unsigned size() const noexcept override { return static_cast<unsigned>(peers_.size()); }
+
+  bool exchange(std::vector<std::vector<ShardMessage>>& outgoing, std::vector<ShardMessage>& incoming) override
+  {
+    const size_t n = peers_.size();
+    outgoing.resize(n);
+    bool any = false;
+    for (const auto& batch : outgoing) { any |= !batch.empty(); }
+    std::vector<Channel> channels(n);
+    for (size_t peer = 0; peer < n; peer++)
+    {
+      if (peer == rank_) { continue; }
+      auto& channel = channels[peer];
+      const FrameHeader header{any, outgoing[peer].size()};
+      channel.send.resize(sizeof(header) + header.count * sizeof(ShardMessage));
+      std::memcpy(channel.send.data(), &header, sizeof(header));
+      std::memcpy(channel.send.data() + sizeof(header), outgoing[peer].data(), header.count * sizeof(ShardMessage));
+      channel.receive.resize(sizeof(FrameHeader));
+    }
+    // The batch a shard sends itself is delivered without going through a socket
+    std::vector<ShardMessage> own;
+    own.swap(outgoing[rank_]);
+    for (auto& batch : outgoing) { batch.clear(); }
+
+    std::vector<pollfd> polls;
+    std::vector<size_t> owners;
+    while (true)
+    {
+      polls.clear();
+      owners.clear();
+      for (size_t peer = 0; peer < n; peer++)
+      {
+        if (peer == rank_) { continue; }
+        const auto& channel = channels[peer];
+        short events = 0;
+        if (channel.sent < channel.send.size()) { events |= POLLOUT; }
+        if (channel.received < channel.receive.size()) { events |= POLLIN; }
+        if (events == 0) { continue; }
+        polls.push_back({peers_[peer], events, 0});
+        owners.push_back(peer);
+      }
+      if (polls.empty()) { break; }
+      if (::poll(polls.data(), polls.size(), -1) < 0)
+      {
+        if (errno == EINTR) { continue; }
+        throw std::runtime_error(std::string("Failed to poll shard sockets: ") + std::strerror(errno));
+      }
+      for (size_t i = 0; i < polls.size(); i++) { service(polls[i], channels[owners[i]]); }
+    }
+
+    incoming.clear();
+    for (size_t peer = 0; peer < n; peer++)
+    {
+      if (peer == rank_)
+      {
+        incoming.insert(incoming.end(), own.begin(), own.end());
+        continue;
+      }
+      const auto& channel = channels[peer];
+      FrameHeader header;
+      std::memcpy(&header, channel.receive.data(), sizeof(header));
+      any |= header.active != 0;
+      const size_t first = incoming.size();
+      incoming.resize(first + header.count);
+      std::memcpy(incoming.data() + first, channel.receive.data() + sizeof(header), header.count * sizeof(ShardMessage));
+    }
+    return any;
+  }
+
+private:
+  struct FrameHeader
+  {
+    uint64_t active;
+    uint64_t count;
+  };
+
+  //! \brief The frames exchanged with one peer during a superstep.
+  struct Channel
+  {
+    std::vector<char> send;
+    size_t sent = 0;
+    std::vector<char> receive;
+    size_t received = 0;
+  };
+
+  unsigned rank_;
+  std::vector<int> peers_;
+
+  static void service(const pollfd& poll, Channel& channel)
+  {
+    if (poll.revents & (POLLERR | POLLNVAL)) { throw std::runtime_error("Shard socket failed"); }
+    if ((poll.revents & POLLOUT) && channel.sent < channel.send.size())
+    {
+      const ssize_t written = ::send(poll.fd, channel.send.data() + channel.sent, channel.send.size() - channel.sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      {
+        throw std::runtime_error(std::string("Failed to send to a shard: ") + std::strerror(errno));
+      }
+      if (written > 0) { channel.sent += static_cast<size_t>(written); }
+    }
+    if ((poll.revents & (POLLIN | POLLHUP)) && channel.received < channel.receive.size())
+    {
+      const ssize_t read = ::recv(poll.fd, channel.receive.data() + channel.received, channel.receive.size() - channel.received, MSG_DONTWAIT);
+      if (read == 0) { throw std::runtime_error("A shard closed its socket"); }
+      if (read < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      {
+        throw std::runtime_error(std::string("Failed to receive from a shard: ") + std::strerror(errno));
+      }
+      if (read > 0) { channel.received += static_cast<size_t>(read); }
+      // Once the header has arrived, grow the buffer to the whole frame
+      if (channel.received == sizeof(FrameHeader) && channel.receive.size() == sizeof(FrameHeader))
+      {
+        FrameHeader header;
+        std::memcpy(&header, channel.receive.data(), sizeof(header));
+        channel.receive.resize(sizeof(header) + header.count * sizeof(ShardMessage));
+      }
+    }
+  }
+};
+
+
+//! \brief Build the shards of a partitioned graph.
+//!
+//! \param [in] graph The graph, as a CSR snapshot.
+//! \param [in] partition A partition of graph, as returned by partitionGraph().
+//! \return std::vector<Shard> One shard per part.
+//! \exception std::invalid_argument Thrown when the partition does not cover the graph.
+inline std::vector<Shard> buildShards(const CompactGraph& graph, const GraphPartition& partition)
+{
+  using Index = CompactGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("build_shards");
+  const size_t n = graph.vertexCount();
+  if (partition.assignment.size() != n) { throw std::invalid_argument("The partition does not match the graph"); }
+  for (uint32_t part : partition.assignment)
+  {
+    if (part >= partition.parts) { throw std::invalid_argument("The partition assigns a vertex to a missing part"); }
+  }
+
+  // The index of each vertex in the shard owning it
+  std::vector<Index> local(n);
+  std::vector<size_t> owned(partition.parts, 0);
+  for (Index v = 0; v < n; v++) { local[v] = static_cast<Index>(owned[partition.assignment[v]]++); }
+
+  std::vector<Shard> shards(partition.parts);
+  std::vector<std::vector<Index>> members(partition.parts);
+  for (Index v = 0; v < n; v++) { members[partition.assignment[v]].push_back(v); }
+
+  std::vector<Index> ghost_of(n, std::numeric_limits<Index>::max());
+  for (unsigned s = 0; s < partition.parts; s++)
+  {
+    auto& shard = shards[s];
+    shard.id = s;
+    shard.owned = members[s].size();
+
+    std::vector<unsigned int> ids;
+    std::vector<Index> ghosts;
+    for (Index v : members[s])
+    {
+      ids.push_back(graph.externalId(v));
+      for (Index u : graph.neighbors(v))
+      {
+        if (partition.assignment[u] == s || ghost_of[u] != std::numeric_limits<Index>::max()) { continue; }
+        ghost_of[u] = static_cast<Index>(shard.owned + ghosts.size());
+        ghosts.push_back(u);
+      }
+    }
+    for (Index u : ghosts)
+    {
+      ids.push_back(graph.externalId(u));
+      shard.ghost_owner.push_back(partition.assignment[u]);
+      shard.ghost_index.push_back(local[u]);
+    }
+
+    std::vector<std::tuple<Index, Index, float>> edges;
+    for (Index v : members[s])
+    {
+      const auto row = graph.neighbors(v);
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        const Index u = row[i];
+        edges.emplace_back(local[v], partition.assignment[u] == s ? local[u] : ghost_of[u], graph.weight(v, i));
+      }
+    }
+    shard.graph = CompactGraph::fromEdges(std::move(ids), edges, true, graph.isWeighted());
+    for (Index u : ghosts) { ghost_of[u] = std::numeric_limits<Index>::max(); }
+  }
+  return shards;
+}
+
+//! \brief Partition a graph and build its shards.
+//! Internal indices follow the order of the external IDs, as in CompactGraph::fromGraph.
+template <typename G> requires TraversableGraph<G>
+std::vector<Shard> buildShards(const G& graph, const PartitionerOptions& options = {})
+{
+  const auto compact = CompactGraph::fromGraph(graph);
+  return buildShards(compact, partitionGraph(compact, options));
+}
+
+
+namespace detail
+{
+//! \brief Label correcting shortest paths across shards.
+//! Each superstep runs Dijkstra inside the shard from every vertex whose distance
+//! improved, then sends the improved ghost distances to their owners.
+inline std::vector<float> shardedSearch(const Shard& shard, ShardTransport& transport, unsigned int source_id, bool weighted)
+{
+  using Index = CompactGraph::Index;
+  using HeapEntry = std::pair<float, Index>;
+  constexpr float kInfinity = std::numeric_limits<float>::infinity();
+  const auto& graph = shard.graph;
+
+  std::vector<float> distance(graph.vertexCount(), kInfinity);
+  std::vector<bool> dirty(graph.vertexCount() - shard.owned, false);
+  std::vector<Index> dirty_ghosts;
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+  std::vector<std::vector<ShardMessage>> outgoing(transport.size());
+  std::vector<ShardMessage> incoming;
+
+  auto source = graph.internalId(source_id);
+  if (source.has_value() && !shard.isGhost(*source))
+  {
+    distance[*source] = 0;
+    heap.emplace(0.0f, *source);
+  }
+
+  do
+  {
+    for (const auto& message : incoming)
+    {
+      if (message.value < distance[message.target])
+      {
+        distance[message.target] = message.value;
+        heap.emplace(message.value, message.target);
+      }
+    }
+
+    while (!heap.empty())
+    {
+      auto [d, v] = heap.top();
+      heap.pop();
+      if (d > distance[v]) { continue; }
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+      GRAPH_LIB_COUNT(EdgesScanned, graph.degree(v));
+      const auto row = graph.neighbors(v);
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        const Index u = row[i];
+        const float candidate = d + (weighted ? graph.weight(v, i) : 1.0f);
+        if (candidate >= distance[u]) { continue; }
+        distance[u] = candidate;
+        if (!shard.isGhost(u)) { heap.emplace(candidate, u); }
+        else if (!dirty[u - shard.owned])
+        {
+          dirty[u - shard.owned] = true;
+          dirty_ghosts.push_back(u);
+        }
+      }
+    }
+
+    for (Index ghost : dirty_ghosts)
+    {
+      const size_t g = ghost - shard.owned;
+      outgoing[shard.ghost_owner[g]].push_back({shard.ghost_index[g], distance[ghost]});
+      dirty[g] = false;
+    }
+    dirty_ghosts.clear();
+  } while (transport.exchange(outgoing, incoming));
+
+  distance.resize(shard.owned);
+  return distance;
+}
+} // namespace detail
+
+
+//! \brief Breadth first search across shards. Call it from every shard with the same source.
+//!
+//! \param [in] shard The shard of the caller.
+//! \param [in] transport The transport connecting the shards, of rank shard.id.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<float> The number of hops to each owned vertex, infinity when unreachable.
+inline std::vector<float> shardedBfs(const Shard& shard, ShardTransport& transport, unsigned int source_id)
+{
+  GRAPH_LIB_SCOPED_TIMER("sharded_bfs");
+  return detail::shardedSearch(shard, transport, source_id, false);
+}
+
+//! \brief Single source shortest paths across shards. Call it from every shard with the same source.
+//! Edge weights must not be negative. Unweighted edges weigh 1.
+//!
+//! \param [in] shard The shard of the caller.
+//! \param [in] transport The transport connecting the shards, of rank shard.id.
+//! \param [in] source_id The external ID of the vertex to start from.
+//! \return std::vector<float> The distance to each owned vertex, infinity when unreachable.
+inline std::vector<float> shardedShortestPaths(const Shard& shard, ShardTransport& transport, unsigned int source_id)
+{
+  GRAPH_LIB_SCOPED_TIMER("sharded_shortest_paths");
+  return detail::shardedSearch(shard, transport, source_id, true);
+}
+
+} // namespace graph_lib
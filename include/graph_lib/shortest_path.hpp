@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/instrumentation.hpp>
+
+
+namespace graph_lib
+{
+//! \brief The answer to a point-to-point shortest path query.
+struct PathResult
+{
+  //! \brief The length of the shortest path, infinity when the target is unreachable.
+  float distance = std::numeric_limits<float>::infinity();
+  //! \brief The external IDs along the path, source first. Empty when the target is unreachable.
+  std::vector<unsigned int> path;
+  //! \brief The number of vertices settled by the search.
+  size_t settled = 0;
+
+  bool found() const noexcept { return !path.empty(); }
+};
+
+//! \brief Search state for point-to-point queries, reused between queries.
+//! Distances are only valid for vertices stamped with the current generation, so
+//! nothing is cleared or allocated between queries once the arrays reached the size
+//! of the graph. Use one state per thread.
+class PathSearchState
+{
+public:
+  PathSearchState() = default;
+
+private:
+  using Index = CompactGraph::Index;
+  using HeapEntry = std::pair<float, Index>;
+
+  struct Side
+  {
+    std::vector<float> distance;
+    std::vector<Index> parent;
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> settled;
+    std::vector<HeapEntry> heap;
+
+    bool reached(Index v, uint32_t generation) const noexcept { return stamp[v] == generation; }
+  };
+
+  Side sides_[2];
+  uint32_t generation_ = 0;
+
+  //! \brief Start a new query on a graph with n vertices.
+  void begin(size_t n)
+  {
+    for (auto& side : sides_)
+    {
+      if (side.stamp.size() != n)
+      {
+        side.distance.assign(n, 0);
+        side.parent.assign(n, 0);
+        side.stamp.assign(n, 0);
+        side.settled.assign(n, 0);
+        generation_ = 0;
+      }
+      side.heap.clear();
+    }
+    if (++generation_ == 0)
+    {
+      for (auto& side : sides_) { std::fill(side.stamp.begin(), side.stamp.end(), 0); std::fill(side.settled.begin(), side.settled.end(), 0); }
+      generation_ = 1;
+    }
+  }
+
+  friend class ShortestPathEngine;
+  friend class ContractionHierarchy;
+};
+
+//! \brief Point-to-point shortest path queries on a snapshot of a weighted graph.
+//! The engine owns the graph and, for directed graphs, its transpose for the
+//! backward search. Queries are const and can run concurrently as long as each
+//! thread uses its own PathSearchState. Edge weights must not be negative.
+class ShortestPathEngine
+{
+public:
+  using Index = CompactGraph::Index;
+
+  //! \brief Take ownership of a graph snapshot and prepare the backward search.
+  explicit ShortestPathEngine(CompactGraph graph):
+    forward_(std::move(graph)), backward_(forward_.isDirected() ? forward_.transpose() : CompactGraph())
+  {}
+
+  const CompactGraph& graph() const noexcept { return forward_; }
+
+  //! \brief Bidirectional Dijkstra between two vertices.
+  //! A forward search from the source and a backward search from the target take
+  //! turns, and the query stops as soon as the sum of the smallest tentative
+  //! distances of both searches reaches the best path found so far.
+  //!
+  //! \param [in] source_id The external ID of the source vertex.
+  //! \param [in] target_id The external ID of the target vertex.
+  //! \param [in,out] state The search state to reuse.
+  //! \return PathResult The distance and path, not found when a vertex is missing or unreachable.
+  PathResult bidirectionalDijkstra(unsigned int source_id, unsigned int target_id, PathSearchState& state) const
+  {
+    GRAPH_LIB_SCOPED_TIMER("bidirectional_dijkstra");
+    PathResult result;
+    auto source = forward_.internalId(source_id);
+    auto target = forward_.internalId(target_id);
+    if (!source.has_value() || !target.has_value()) { return result; }
+
+    state.begin(forward_.vertexCount());
+    const uint32_t generation = state.generation_;
+    auto& sides = state.sides_;
+    reach(sides[0], *source, 0, *source, generation);
+    reach(sides[1], *target, 0, *target, generation);
+
+    float best = std::numeric_limits<float>::infinity();
+    std::optional<Index> meet;
+    if (*source == *target) { best = 0; meet = *source; }
+
+    while (!sides[0].heap.empty() && !sides[1].heap.empty())
+    {
+      if (sides[0].heap.front().first + sides[1].heap.front().first >= best) { break; }
+
+      // Expand the side with the smaller frontier
+      const int s = sides[0].heap.size() <= sides[1].heap.size() ? 0 : 1;
+      auto& side = sides[s];
+      auto& other = sides[1 - s];
+      const CompactGraph& graph = s == 0 ? forward_ : reverse();
+
+      auto [distance, v] = popMin(side.heap);
+      if (side.settled[v] == generation || distance > side.distance[v]) { continue; }
+      side.settled[v] = generation;
+      result.settled++;
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+
+      const auto row = graph.neighbors(v);
+      GRAPH_LIB_COUNT(EdgesScanned, row.size());
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        const Index u = row[i];
+        const float candidate = distance + graph.weight(v, i);
+        if (!side.reached(u, generation) || candidate < side.distance[u]) { reach(side, u, candidate, v, generation); }
+        if (other.reached(u, generation) && side.distance[u] + other.distance[u] < best)
+        {
+          best = side.distance[u] + other.distance[u];
+          meet = u;
+        }
+      }
+    }
+
+    if (!meet.has_value()) { return result; }
+    result.distance = best;
+    for (Index v = *meet; ; v = sides[0].parent[v])
+    {
+      result.path.push_back(forward_.externalId(v));
+      if (v == *source) { break; }
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    for (Index v = *meet; v != *target; )
+    {
+      v = sides[1].parent[v];
+      result.path.push_back(forward_.externalId(v));
+    }
+    return result;
+  }
+
+  //! \brief A* search between two vertices.
+  //! The heuristic must be admissible: it never overestimates the distance left to the target.
+  //!
+  //! \param [in] source_id The external ID of the source vertex.
+  //! \param [in] target_id The external ID of the target vertex.
+  //! \param [in] heuristic Callable as float(unsigned int vertex_id, unsigned int target_id), on external IDs.
+  //! \param [in,out] state The search state to reuse.
+  //! \return PathResult The distance and path, not found when a vertex is missing or unreachable.
+  template <typename H>
+  PathResult aStar(unsigned int source_id, unsigned int target_id, H&& heuristic, PathSearchState& state) const
+  {
+    GRAPH_LIB_SCOPED_TIMER("a_star");
+    PathResult result;
+    auto source = forward_.internalId(source_id);
+    auto target = forward_.internalId(target_id);
+    if (!source.has_value() || !target.has_value()) { return result; }
+
+    state.begin(forward_.vertexCount());
+    const uint32_t generation = state.generation_;
+    auto& side = state.sides_[0];
+    auto estimate = [&](Index v) { return static_cast<float>(heuristic(forward_.externalId(v), target_id)); };
+
+    side.distance[*source] = 0;
+    side.parent[*source] = *source;
+    side.stamp[*source] = generation;
+    push(side.heap, estimate(*source), *source);
+
+    while (!side.heap.empty())
+    {
+      const Index v = popMin(side.heap).second;
+      if (side.settled[v] == generation) { continue; }
+      side.settled[v] = generation;
+      result.settled++;
+      GRAPH_LIB_COUNT(VerticesVisited, 1);
+      if (v == *target) { break; }
+
+      const auto row = forward_.neighbors(v);
+      GRAPH_LIB_COUNT(EdgesScanned, row.size());
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        const Index u = row[i];
+        const float candidate = side.distance[v] + forward_.weight(v, i);
+        if (side.reached(u, generation) && candidate >= side.distance[u]) { continue; }
+        // A heuristic that is admissible but not consistent can improve a settled vertex, which is reopened
+        side.settled[u] = 0;
+        side.distance[u] = candidate;
+        side.parent[u] = v;
+        side.stamp[u] = generation;
+        push(side.heap, candidate + estimate(u), u);
+      }
+    }
+
+    if (side.settled[*target] != generation) { return result; }
+    result.distance = side.distance[*target];
+    for (Index v = *target; ; v = side.parent[v])
+    {
+      result.path.push_back(forward_.externalId(v));
+      if (v == *source) { break; }
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    return result;
+  }
+
+  //! \brief Bidirectional Dijkstra with the calling thread's own search state.
+  PathResult bidirectionalDijkstra(unsigned int source_id, unsigned int target_id) const
+  {
+    return bidirectionalDijkstra(source_id, target_id, threadState());
+  }
+
+  //! \brief A* with the calling thread's own search state.
+  template <typename H>
+  PathResult aStar(unsigned int source_id, unsigned int target_id, H&& heuristic) const
+  {
+    return aStar(source_id, target_id, std::forward<H>(heuristic), threadState());
+  }
+
+private:
+  using HeapEntry = PathSearchState::HeapEntry;
+
+  CompactGraph forward_;
+  CompactGraph backward_;
+
+  //! \brief The graph searched backwards from the target. Undirected graphs are their own transpose.
+  const CompactGraph& reverse() const noexcept { return forward_.isDirected() ? backward_ : forward_; }
+
+  static PathSearchState& threadState()
+  {
+    thread_local PathSearchState state;
+    return state;
+  }
+
+  static void push(std::vector<HeapEntry>& heap, float key, Index v)
+  {
+    heap.emplace_back(key, v);
+    std::push_heap(heap.begin(), heap.end(), std::greater<>());
+  }
+
+  static HeapEntry popMin(std::vector<HeapEntry>& heap)
+  {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+    HeapEntry top = heap.back();
+    heap.pop_back();
+    return top;
+  }
+
+  static void reach(PathSearchState::Side& side, Index v, float distance, Index parent, uint32_t generation)
+  {
+    side.distance[v] = distance;
+    side.parent[v] = parent;
+    side.stamp[v] = generation;
+    push(side.heap, distance, v);
+  }
+};
+
+} // namespace graph_lib
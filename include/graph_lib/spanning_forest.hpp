@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/parallel.hpp>
+
+
+namespace graph_lib
+{
+//! \brief An edge of a spanning forest, between external vertex IDs.
+struct ForestEdge
+{
+  unsigned int origin;
+  unsigned int dest;
+  float weight;
+};
+
+//! \brief A minimum spanning forest: one minimum spanning tree per connected component.
+struct SpanningForest
+{
+  std::vector<ForestEdge> edges;
+  //! \brief The sum of the weights of the forest edges.
+  double total_weight = 0;
+  //! \brief The number of trees, which is the number of connected components.
+  size_t trees = 0;
+};
+
+struct SpanningForestOptions
+{
+  //! \brief The number of worker threads, 0 selects the hardware concurrency.
+  unsigned threads = 0;
+};
+
+
+namespace detail
+{
+//! \brief Map a float to an unsigned integer with the same order.
+inline uint32_t orderedBits(float weight) noexcept
+{
+  const uint32_t bits = std::bit_cast<uint32_t>(weight);
+  return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+//! \brief Lower value to candidate if candidate is smaller, atomically.
+inline void atomicMin(uint64_t& value, uint64_t candidate) noexcept
+{
+  std::atomic_ref<uint64_t> ref(value);
+  uint64_t current = ref.load(std::memory_order_relaxed);
+  while (candidate < current && !ref.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {}
+}
+} // namespace detail
+
+
+//! \brief Compute a minimum spanning forest with parallel Borůvka.
+//! Every round, each component picks its lightest outgoing edge and hooks onto
+//! the component at the other end, which at least halves the number of
+//! components. Lightest edges are found with an atomic minimum over a key of
+//! (weight, edge index), so ties are broken consistently and the picked edges
+//! never form a cycle. Edges inside a component are dropped between rounds, so
+//! later rounds only scan the edges still crossing components.
+//!
+//! \param [in] graph An undirected graph, as a CSR snapshot. Unweighted edges weigh 1.
+//! \param [in] options The thread count.
+//! \return SpanningForest The forest edges, their total weight and the number of trees.
+//! \exception std::invalid_argument Thrown when the graph is directed or has 2³² edges or more.
+inline SpanningForest minimumSpanningForest(const CompactGraph& graph, const SpanningForestOptions& options = {})
+{
+  using Index = CompactGraph::Index;
+  GRAPH_LIB_SCOPED_TIMER("minimum_spanning_forest");
+  if (graph.isDirected()) { throw std::invalid_argument("Spanning forests need an undirected graph"); }
+  if (graph.edgeCount() / 2 >= std::numeric_limits<uint32_t>::max()) { throw std::invalid_argument("Too many edges for a spanning forest"); }
+
+  const size_t n = graph.vertexCount();
+  const unsigned threads = resolveThreads(options.threads);
+  constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+
+  // Each undirected edge once, from its smaller endpoint, laid out by origin
+  std::vector<size_t> first_edge(n + 1, 0);
+  parallelFor(0, n, threads, [&](size_t v)
+  {
+    const auto row = graph.neighbors(static_cast<Index>(v));
+    first_edge[v + 1] = row.end() - std::upper_bound(row.begin(), row.end(), static_cast<Index>(v));
+  });
+  std::partial_sum(first_edge.begin(), first_edge.end(), first_edge.begin());
+  const size_t m = first_edge[n];
+  std::vector<Index> origin(m), dest(m);
+  std::vector<float> weight(m);
+  parallelFor(0, n, threads, [&](size_t v)
+  {
+    const auto row = graph.neighbors(static_cast<Index>(v));
+    size_t slot = first_edge[v];
+    for (size_t i = std::upper_bound(row.begin(), row.end(), static_cast<Index>(v)) - row.begin(); i < row.size(); i++)
+    {
+      origin[slot] = static_cast<Index>(v);
+      dest[slot] = row[i];
+      weight[slot++] = graph.weight(static_cast<Index>(v), i);
+    }
+  });
+
+  std::vector<Index> component(n);
+  std::iota(component.begin(), component.end(), Index{0});
+  std::vector<uint64_t> best(n, kNone);
+  std::vector<uint32_t> live(m);
+  std::iota(live.begin(), live.end(), uint32_t{0});
+  std::vector<std::vector<uint32_t>> kept(threads);
+  std::vector<uint32_t> picked;
+
+  SpanningForest forest;
+  while (!live.empty())
+  {
+    // Drop edges inside a component and find the lightest edge leaving each component
+    parallelForChunks(0, live.size(), threads, [&](size_t chunk_first, size_t chunk_last, unsigned thread)
+    {
+      auto& out = kept[thread];
+      out.clear();
+      for (size_t i = chunk_first; i < chunk_last; i++)
+      {
+        const uint32_t e = live[i];
+        const Index a = component[origin[e]], b = component[dest[e]];
+        if (a == b) { continue; }
+        out.push_back(e);
+        const uint64_t key = uint64_t{detail::orderedBits(weight[e])} << 32 | e;
+        detail::atomicMin(best[a], key);
+        detail::atomicMin(best[b], key);
+      }
+      GRAPH_LIB_COUNT(EdgesScanned, chunk_last - chunk_first);
+    });
+    live.clear();
+    for (const auto& out : kept) { live.insert(live.end(), out.begin(), out.end()); }
+    if (live.empty()) { break; }
+
+    // Hook every component onto its neighbor across its lightest edge. Two components
+    // picking each other share the same edge, and the smaller one stays a root.
+    std::vector<Index> parent(component);
+    parallelFor(0, n, threads, [&](size_t c)
+    {
+      if (best[c] == kNone) { return; }
+      const uint32_t e = static_cast<uint32_t>(best[c]);
+      const Index other = component[origin[e]] == c ? component[dest[e]] : component[origin[e]];
+      if (best[other] == best[c] && c < other) { return; }
+      parent[c] = other;
+    });
+    picked.clear();
+    for (size_t c = 0; c < n; c++)
+    {
+      if (best[c] != kNone && parent[c] != c) { picked.push_back(static_cast<uint32_t>(best[c])); }
+    }
+    for (uint32_t e : picked) { forest.edges.push_back({graph.externalId(origin[e]), graph.externalId(dest[e]), weight[e]}); }
+
+    // Pointer jumping flattens the hooked trees, then every vertex takes its new root
+    std::vector<Index> jumped(n);
+    for (bool changed = true; changed; )
+    {
+      std::atomic<bool> any{false};
+      parallelFor(0, n, threads, [&](size_t c)
+      {
+        jumped[c] = parent[parent[c]];
+        if (jumped[c] != parent[c]) { any.store(true, std::memory_order_relaxed); }
+      });
+      parent.swap(jumped);
+      changed = any.load();
+    }
+    parallelFor(0, n, threads, [&](size_t v)
+    {
+      component[v] = parent[component[v]];
+      best[v] = kNone;
+    });
+  }
+
+  for (const auto& edge : forest.edges) { forest.total_weight += edge.weight; }
+  forest.trees = n - forest.edges.size();
+  return forest;
+}
+
+//! \brief Compute a minimum spanning forest of an undirected graph or graph view.
+//! The graph is snapshotted first; see the overload taking a CompactGraph.
+template <typename G> requires TraversableGraph<G>
+SpanningForest minimumSpanningForest(const G& graph, const SpanningForestOptions& options = {})
+{
+  return minimumSpanningForest(CompactGraph::fromGraph(graph), options);
+}
+
+} // namespace graph_lib
@@ -5,6 +5,7 @@
 #include <unordered_set>
 
 #include <graph_lib/concepts.hpp>
+#include <graph_lib/memory.hpp>
 
 
 namespace graph_lib
@@ -76,31 +77,72 @@ struct EdgePtrCompare {
 };
 
 
+//! \brief An entry of the incoming index: the origin of an edge to a vertex.
+//! Entries live in a pool owned by the graph and each vertex links its own,
+//! most recent first. The entry owns its origin: a copy of the graph may add an
+//! edge from a vertex of its own to a shared one, and that vertex must outlive the copy.
+template <typename T> requires Graphable<T>
+struct IncomingEdge
+{
+  std::shared_ptr<const Vertex<T>> vertex;
+  float weight;
+  const IncomingEdge* next;
+};
+
+
 template <typename T> requires Graphable<T>
 struct Vertex
 {
+  using AdjacencyAllocator = TrackingAllocator<std::unique_ptr<Edge<T>>>;
+  using AdjacencySet = std::unordered_set<std::unique_ptr<Edge<T>>, EdgePtrHash<T>, EdgePtrCompare<T>, AdjacencyAllocator>;
+
+private:
+  //! \brief The ID of the vertex.
+  unsigned int id_;
+
+  //! \brief The cached hash of the stored value, so lookups never rehash it.
+  size_t hash_;
+
+public:
   //! \brief Construct a graph vertex with the specified value.
   //! \param [in] value The value to store in the vertex.
   Vertex(const T& value):
-    id_(getCount()), data(new T(value))
+    id_(getCount()), hash_(std::hash<T>()(value)), data(new T(value))
+  {}
+
+  //! \brief Construct a graph vertex whose adjacency set is charged to a memory account.
+  //! \param [in] value The value to store in the vertex.
+  //! \param [in] allocator The allocator of the adjacency set.
+  Vertex(const T& value, const AdjacencyAllocator& allocator):
+    id_(getCount()), hash_(std::hash<T>()(value)), data(new T(value)), adj(allocator)
   {}
 
   //! \brief Copy constructor
   //! \param [in] vertex The vertex from which to construct the copy.
   Vertex(const Vertex<T>& vertex):
-    id_(vertex.id_), data(new T(*vertex.data))
+    id_(vertex.id_), hash_(vertex.hash_), data(new T(*vertex.data))
   {}
 
-  unsigned int getID() { return id_; }
+  unsigned int getID() const { return id_; }
+
+  //! \brief The hash of the stored value, computed once when the vertex is created.
+  size_t getHash() const noexcept { return hash_; }
 
   //! \brief The value stored in the vertex.
   std::unique_ptr<T> data;
 
   //! \brief The adjacent vertices in the graph.
-  std::unordered_set<std::unique_ptr<Edge<T>>, EdgePtrHash<T>, EdgePtrCompare<T>> adj;
+  AdjacencySet adj;
+
+  //! \brief The most recent entry of the incoming index for this vertex.
+  //! Only set while the graph keeps an incoming index.
+  const IncomingEdge<T>* incoming = nullptr;
+
+  //! \brief The number of edges to this vertex, while the graph keeps an incoming index.
+  size_t in_degree = 0;
 
   // EQ operator
-  inline        bool operator==(const Vertex<T>& rhs)               const { return *data == *rhs.data; }
+  inline        bool operator==(const Vertex<T>& rhs)               const { return hash_ == rhs.hash_ && *data == *rhs.data; }
   inline        bool operator==(const T& rhs)                       const { return *data == rhs; }
   inline friend bool operator==(const T& lhs, const Vertex<T>& rhs)       { return lhs == *rhs.data; }
 
@@ -109,9 +151,6 @@ struct Vertex
   inline friend std::ostream& operator<<(std::ostream& os, const Vertex<T>& vertex) { os << "[id: " << vertex.id_ << " data: " << *vertex.data << "]"; return os;}
 
 private:
-  //! \brief The value stored in the vertex.
-  unsigned int id_;
-
   static unsigned int getCount()
   {
     static unsigned int count = 0;
@@ -124,7 +163,7 @@ struct VertexHash
 {
   size_t operator()(const graph_lib::Vertex<T> &x) const
   {
-    return std::hash<T>()(*x.data);
+    return x.getHash();
   }
 };
 
@@ -141,7 +180,7 @@ template <typename T> requires Graphable<T>
 struct VertexPtrCompare {
   using is_transparent = void;
 
-  bool operator() (const std::shared_ptr<Vertex<T>>& a, const std::shared_ptr<Vertex<T>>& b) const { return (*a) == (*b); }
+  bool operator() (const std::shared_ptr<Vertex<T>>& a, const std::shared_ptr<Vertex<T>>& b) const { return a == b || (*a) == (*b); }
 
   bool operator() (const Vertex<T>& a, const std::shared_ptr<Vertex<T>>& b)                  const { return a == (*b); }
   bool operator() (const std::shared_ptr<Vertex<T>>& a, const Vertex<T>& b)                  const { return (*a) == b; }
@@ -150,4 +189,8 @@ struct VertexPtrCompare {
   bool operator() (const std::shared_ptr<Vertex<T>>& a, const T& b)                          const { return (*a) == b; }
 };
 
+template <typename T> requires Graphable<T>
+using VertexPtrSet = std::unordered_set<std::shared_ptr<Vertex<T>>, VertexPtrHash<T>, VertexPtrCompare<T>,
+                                        TrackingAllocator<std::shared_ptr<Vertex<T>>>>;
+
 } // namespace graph_lib
\ No newline at end of file
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/concepts.hpp>
+#include <graph_lib/instrumentation.hpp>
+#include <graph_lib/vertex.hpp>
+
+
+namespace graph_lib
+{
+//! \brief What a visitor callback asks the traversal to do next.
+enum class VisitAction
+{
+  //! \brief Carry on normally.
+  Continue,
+  //! \brief From discoverVertex: do not expand the vertex. From examineEdge: do not follow the edge.
+  Skip,
+  //! \brief End the traversal immediately.
+  Stop
+};
+
+constexpr unsigned kUnlimitedDepth = std::numeric_limits<unsigned>::max();
+
+//! \brief Outcome of a visitor traversal.
+struct VisitSummary
+{
+  //! \brief Whether a callback returned VisitAction::Stop.
+  bool stopped = false;
+  size_t vertices_discovered = 0;
+  size_t edges_examined = 0;
+};
+
+
+namespace detail
+{
+//! \brief Call an optional visitor callback. Missing callbacks and void callbacks continue.
+template <typename R>
+VisitAction toAction(R&& result)
+{
+  if constexpr (std::is_same_v<std::decay_t<R>, VisitAction>) { return result; }
+  else { return VisitAction::Continue; }
+}
+
+template <typename Visitor, typename VertexPtr>
+VisitAction discover(Visitor& visitor, const VertexPtr& vertex, unsigned depth)
+{
+  if constexpr (requires { visitor.discoverVertex(vertex, depth); })
+  {
+    if constexpr (std::is_void_v<decltype(visitor.discoverVertex(vertex, depth))>)
+    {
+      visitor.discoverVertex(vertex, depth);
+      return VisitAction::Continue;
+    }
+    else { return toAction(visitor.discoverVertex(vertex, depth)); }
+  }
+  return VisitAction::Continue;
+}
+
+template <typename Visitor, typename VertexPtr>
+VisitAction examine(Visitor& visitor, const VertexPtr& origin, const VertexPtr& dest, float weight)
+{
+  if constexpr (requires { visitor.examineEdge(origin, dest, weight); })
+  {
+    if constexpr (std::is_void_v<decltype(visitor.examineEdge(origin, dest, weight))>)
+    {
+      visitor.examineEdge(origin, dest, weight);
+      return VisitAction::Continue;
+    }
+    else { return toAction(visitor.examineEdge(origin, dest, weight)); }
+  }
+  return VisitAction::Continue;
+}
+
+template <typename Visitor, typename VertexPtr>
+VisitAction finish(Visitor& visitor, const VertexPtr& vertex)
+{
+  if constexpr (requires { visitor.finishVertex(vertex); })
+  {
+    if constexpr (std::is_void_v<decltype(visitor.finishVertex(vertex))>)
+    {
+      visitor.finishVertex(vertex);
+      return VisitAction::Continue;
+    }
+    else { return toAction(visitor.finishVertex(vertex)); }
+  }
+  return VisitAction::Continue;
+}
+} // namespace detail
+
+
+//! \brief Breadth first traversal from one vertex, driven by a visitor.
+//! Only the vertices reachable from the source within the depth limit are touched.
+//! The visitor may define any of:
+//!   - discoverVertex(const VertexPtr& vertex, unsigned depth), when a vertex is first reached.
+//!   - examineEdge(const VertexPtr& origin, const VertexPtr& dest, float weight), for each edge of an expanded vertex.
+//!   - finishVertex(const VertexPtr& vertex), once every edge of the vertex was examined.
+//! Each may return a VisitAction or void, which continues.
+//!
+//! \param [in] graph The graph or graph view.
+//! \param [in] source_id The ID of the vertex to start from.
+//! \param [in] visitor The visitor.
+//! \param [in] max_depth Vertices at this depth are discovered but not expanded.
+//! \return VisitSummary Whether the traversal was stopped and how much it touched.
+template <typename G, typename Visitor> requires TraversableGraph<G>
+VisitSummary breadthFirstVisit(const G& graph, unsigned int source_id, Visitor&& visitor, unsigned max_depth = kUnlimitedDepth)
+{
+  GRAPH_LIB_SCOPED_TIMER("bfs_visit");
+  using VertexPtr = typename G::VertexPtr;
+
+  VisitSummary summary;
+  auto source = graph.getVertex(source_id);
+  if (!source.has_value()) { return summary; }
+
+  std::unordered_set<const Vertex<typename G::ValueType>*> discovered{&**source};
+  std::deque<std::pair<VertexPtr, unsigned>> queue;
+
+  // Discover a vertex and queue it unless the visitor skips it
+  auto reach = [&](const VertexPtr& vertex, unsigned depth)
+  {
+    summary.vertices_discovered++;
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    const auto action = detail::discover(visitor, vertex, depth);
+    if (action == VisitAction::Continue) { queue.emplace_back(vertex, depth); }
+    else if (action == VisitAction::Skip && detail::finish(visitor, vertex) == VisitAction::Stop) { return VisitAction::Stop; }
+    return action;
+  };
+
+  if (reach(*source, 0) == VisitAction::Stop) { summary.stopped = true; return summary; }
+
+  while (!queue.empty())
+  {
+    auto [vertex, depth] = std::move(queue.front());
+    queue.pop_front();
+
+    if (depth < max_depth)
+    {
+      bool stop = false;
+      graph.forEachNeighbor(*vertex, [&](const VertexPtr& dest, float weight)
+      {
+        if (stop) { return; }
+        summary.edges_examined++;
+        GRAPH_LIB_COUNT(EdgesScanned, 1);
+        const auto action = detail::examine(visitor, vertex, dest, weight);
+        if (action == VisitAction::Stop) { stop = true; return; }
+        if (action == VisitAction::Skip) { return; }
+
+        GRAPH_LIB_COUNT(HashLookups, 1);
+        if (!discovered.insert(&*dest).second) { return; }
+        if (reach(dest, depth + 1) == VisitAction::Stop) { stop = true; }
+      });
+      if (stop) { summary.stopped = true; return summary; }
+    }
+
+    if (detail::finish(visitor, vertex) == VisitAction::Stop) { summary.stopped = true; return summary; }
+  }
+  return summary;
+}
+
+//! \brief Depth first traversal from one vertex, driven by a visitor.
+//! Takes the same visitor as breadthFirstVisit. A vertex is finished once every
+//! vertex discovered through it has been finished, giving a post-order.
+//!
+//! \param [in] graph The graph or graph view.
+//! \param [in] source_id The ID of the vertex to start from.
+//! \param [in] visitor The visitor.
+//! \param [in] max_depth Vertices at this depth are discovered but not expanded.
+//! \return VisitSummary Whether the traversal was stopped and how much it touched.
+template <typename G, typename Visitor> requires TraversableGraph<G>
+VisitSummary depthFirstVisit(const G& graph, unsigned int source_id, Visitor&& visitor, unsigned max_depth = kUnlimitedDepth)
+{
+  GRAPH_LIB_SCOPED_TIMER("dfs_visit");
+  using VertexPtr = typename G::VertexPtr;
+
+  struct Frame
+  {
+    VertexPtr vertex;
+    unsigned depth;
+    //! \brief The frame's edges start at edges[first]. While the frame is on top
+    //! of the stack its pending edges are edges[next, edges.size()).
+    size_t first;
+    size_t next;
+  };
+
+  VisitSummary summary;
+  auto source = graph.getVertex(source_id);
+  if (!source.has_value()) { return summary; }
+
+  std::unordered_set<const Vertex<typename G::ValueType>*> discovered;
+  std::vector<Frame> stack;
+  // Edges of every open frame, stacked in the same order as the frames
+  std::vector<std::pair<VertexPtr, float>> edges;
+
+  // Discover a vertex and open a frame for it unless the visitor skips it
+  auto enter = [&](const VertexPtr& vertex, unsigned depth)
+  {
+    discovered.insert(&*vertex);
+    summary.vertices_discovered++;
+    GRAPH_LIB_COUNT(VerticesVisited, 1);
+    const auto action = detail::discover(visitor, vertex, depth);
+    if (action == VisitAction::Stop) { return VisitAction::Stop; }
+    if (action == VisitAction::Skip) { return detail::finish(visitor, vertex); }
+
+    const size_t first = edges.size();
+    if (depth < max_depth)
+    {
+      graph.forEachNeighbor(*vertex, [&](const VertexPtr& dest, float weight) { edges.emplace_back(dest, weight); });
+    }
+    stack.push_back({vertex, depth, first, first});
+    return VisitAction::Continue;
+  };
+
+  if (enter(*source, 0) == VisitAction::Stop) { summary.stopped = true; return summary; }
+
+  while (!stack.empty())
+  {
+    Frame& frame = stack.back();
+    if (frame.next == edges.size())
+    {
+      auto vertex = std::move(frame.vertex);
+      edges.resize(frame.first);
+      stack.pop_back();
+      if (detail::finish(visitor, vertex) == VisitAction::Stop) { summary.stopped = true; return summary; }
+      continue;
+    }
+
+    auto [dest, weight] = edges[frame.next++];
+    const auto vertex = frame.vertex;
+    const unsigned depth = frame.depth;
+
+    summary.edges_examined++;
+    GRAPH_LIB_COUNT(EdgesScanned, 1);
+    const auto action = detail::examine(visitor, vertex, dest, weight);
+    if (action == VisitAction::Stop) { summary.stopped = true; return summary; }
+    if (action == VisitAction::Skip) { continue; }
+
+    GRAPH_LIB_COUNT(HashLookups, 1);
+    if (discovered.contains(&*dest)) { continue; }
+    if (enter(dest, depth + 1) == VisitAction::Stop) { summary.stopped = true; return summary; }
+  }
+  return summary;
+}
+
+} // namespace graph_lib
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/apsp.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+#include "reference_dijkstra.hpp"
+
+using graph_lib::ApspMethod;
+using graph_lib::CompactGraph;
+
+
+static void expectMatrixNear(const graph_lib::DistanceMatrix& matrix, const CompactGraph& graph)
+{
+  ASSERT_EQ(matrix.size(), graph.vertexCount());
+  ASSERT_EQ(matrix.data().size(), graph.vertexCount() * graph.vertexCount());
+  for (CompactGraph::Index s = 0; s < graph.vertexCount(); s++)
+  {
+    const auto expected = referenceDistances(graph, s);
+    for (size_t t = 0; t < expected.size(); t++)
+    {
+      if (std::isinf(expected[t])) { EXPECT_TRUE(std::isinf(matrix.at(s, t))); }
+      else { EXPECT_NEAR(matrix.at(s, t), expected[t], 1e-3) << s << " -> " << t; }
+    }
+  }
+}
+
+template <typename G>
+static void checkAgainstReference(uint64_t vertices, uint64_t edges)
+{
+  auto list = graph_lib::erdosRenyiEdges(vertices, edges, {.seed = 5, .weights = graph_lib::WeightDistribution::uniform(1, 10)});
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<G>(list));
+  // A tile size that does not divide the vertex count exercises the padding
+  for (auto method : {ApspMethod::FloydWarshall, ApspMethod::Johnson, ApspMethod::Automatic})
+  {
+    auto matrix = graph_lib::allPairsShortestPaths(graph, {.threads = 4, .method = method, .block_size = 16});
+    ASSERT_TRUE(matrix.has_value());
+    expectMatrixNear(*matrix, graph);
+  }
+}
+
+TEST(ApspTest, TestDirectedMatchesDijkstra) { checkAgainstReference<graph_lib::WeightedDirectedGraph<int>>(150, 600); }
+
+TEST(ApspTest, TestUndirectedMatchesDijkstra) { checkAgainstReference<graph_lib::WeightedUndirectedGraph<int>>(150, 400); }
+
+TEST(ApspTest, TestDenseGraphMatchesDijkstra) { checkAgainstReference<graph_lib::WeightedDirectedGraph<int>>(70, 3000); }
+
+TEST(ApspTest, TestNegativeWeights)
+{
+  // 0 -> 1 -> 2 is cheaper than 0 -> 2 thanks to the negative edge, and 3 is unreachable
+  const std::vector<std::tuple<size_t, size_t, float>> edges{{0, 1, 4}, {1, 2, -3}, {0, 2, 2}, {2, 0, 5}};
+  auto graph = CompactGraph::fromEdges({10, 11, 12, 13}, edges, true, true);
+  for (auto method : {ApspMethod::FloydWarshall, ApspMethod::Johnson})
+  {
+    auto matrix = graph_lib::allPairsShortestPaths(graph, {.threads = 2, .method = method, .block_size = 3});
+    ASSERT_TRUE(matrix.has_value());
+    EXPECT_FLOAT_EQ(*matrix->distance(10, 12), 1);
+    EXPECT_FLOAT_EQ(*matrix->distance(11, 10), 2);
+    EXPECT_FLOAT_EQ(*matrix->distance(12, 11), 9);
+    EXPECT_TRUE(std::isinf(*matrix->distance(10, 13)));
+    EXPECT_FLOAT_EQ(*matrix->distance(13, 13), 0);
+    EXPECT_FALSE(matrix->distance(10, 99).has_value());
+  }
+}
+
+TEST(ApspTest, TestNegativeCycle)
+{
+  const std::vector<std::tuple<size_t, size_t, float>> edges{{0, 1, 1}, {1, 2, -2}, {2, 0, 0.5f}, {2, 3, 1}};
+  auto graph = CompactGraph::fromEdges({0, 1, 2, 3}, edges, true, true);
+  EXPECT_FALSE(graph_lib::allPairsShortestPaths(graph, {.method = ApspMethod::FloydWarshall}).has_value());
+  EXPECT_FALSE(graph_lib::allPairsShortestPaths(graph, {.method = ApspMethod::Johnson}).has_value());
+}
+
+TEST(ApspTest, TestGraphOverloadAndRowLayout)
+{
+  graph_lib::WeightedUndirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+  for (int i = 0; i < 5; i++) { ids.push_back(*graph.addVertex(i)); }
+  for (int i = 0; i + 1 < 5; i++) { graph.addEdge(ids[i], ids[i + 1], 2.0f); }
+
+  auto matrix = graph_lib::allPairsShortestPaths(graph);
+  ASSERT_TRUE(matrix.has_value());
+  for (size_t i = 0; i < matrix->size(); i++)
+  {
+    const auto row = matrix->row(i);
+    for (size_t j = 0; j < row.size(); j++) { EXPECT_EQ(row[j], matrix->data()[i * matrix->size() + j]); }
+  }
+  EXPECT_FLOAT_EQ(*matrix->distance(ids[0], ids[4]), 8);
+  EXPECT_FLOAT_EQ(*matrix->distance(ids[3], ids[1]), 4);
+}
+
+TEST(ApspTest, TestEmptyGraph)
+{
+  auto matrix = graph_lib::allPairsShortestPaths(CompactGraph());
+  ASSERT_TRUE(matrix.has_value());
+  EXPECT_EQ(matrix->size(), 0u);
+  EXPECT_TRUE(matrix->data().empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
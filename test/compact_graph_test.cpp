@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <set>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/reorder.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+
+class CompactGraphTestBasic : public testing::Test
+{
+public:
+  graph_lib::WeightedDirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+
+  void SetUp()
+  {
+    for (int i = 0; i < 5; i++) { ids.push_back(*graph.addVertex(i)); }
+
+    graph.addEdge(ids[0], ids[1], 0.1);
+    graph.addEdge(ids[0], ids[3], 0.2);
+    graph.addEdge(ids[1], ids[2], 0.4);
+    graph.addEdge(ids[3], ids[2], 0.5);
+    graph.addEdge(ids[3], ids[4], 0.6);
+  }
+};
+
+//! \brief The external IDs of the neighbors of an external ID.
+static std::set<unsigned int> externalNeighbors(const graph_lib::CompactGraph& graph, unsigned int id)
+{
+  std::set<unsigned int> result;
+  for (auto v : graph.neighbors(*graph.internalId(id))) { result.insert(graph.externalId(v)); }
+  return result;
+}
+
+TEST_F(CompactGraphTestBasic, TestFromGraph)
+{
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  EXPECT_EQ(compact.vertexCount(), 5u);
+  EXPECT_EQ(compact.edgeCount(), 5u);
+  EXPECT_TRUE(compact.isDirected());
+  EXPECT_TRUE(compact.isWeighted());
+
+  EXPECT_EQ(externalNeighbors(compact, ids[3]), (std::set<unsigned int>{ids[2], ids[4]}));
+  auto v0 = *compact.internalId(ids[0]);
+  EXPECT_FLOAT_EQ(compact.weight(v0, 1), 0.2f);
+}
+
+TEST_F(CompactGraphTestBasic, TestTranspose)
+{
+  auto transposed = graph_lib::CompactGraph::fromGraph(graph).transpose();
+  EXPECT_EQ(externalNeighbors(transposed, ids[2]), (std::set<unsigned int>{ids[1], ids[3]}));
+  EXPECT_TRUE(externalNeighbors(transposed, ids[0]).empty());
+}
+
+TEST_F(CompactGraphTestBasic, TestRelabelKeepsExternalIds)
+{
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  std::vector<graph_lib::CompactGraph::Index> permutation{4, 3, 2, 1, 0};
+  compact.relabel(permutation);
+
+  EXPECT_EQ(compact.externalId(4), ids[0]);
+  EXPECT_EQ(externalNeighbors(compact, ids[0]), (std::set<unsigned int>{ids[1], ids[3]}));
+  EXPECT_EQ(externalNeighbors(compact, ids[3]), (std::set<unsigned int>{ids[2], ids[4]}));
+
+  auto v0 = *compact.internalId(ids[0]);
+  auto neighbors = compact.neighbors(v0);
+  auto pos = std::find(neighbors.begin(), neighbors.end(), *compact.internalId(ids[3])) - neighbors.begin();
+  EXPECT_FLOAT_EQ(compact.weight(v0, pos), 0.2f);
+}
+
+TEST_F(CompactGraphTestBasic, TestRelabelRejectsInvalidPermutation)
+{
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  std::vector<graph_lib::CompactGraph::Index> permutation{0, 0, 1, 2, 3};
+  EXPECT_THROW(compact.relabel(permutation), std::invalid_argument);
+}
+
+TEST(ReorderTest, TestEveryMethodIsAPermutation)
+{
+  auto list = graph_lib::rmatEdges(9, 4000, {}, {3});
+  auto graph = graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list);
+  auto original = graph_lib::CompactGraph::fromGraph(graph);
+
+  for (auto method : {graph_lib::ReorderMethod::HubSort, graph_lib::ReorderMethod::DegreeSort,
+                      graph_lib::ReorderMethod::ReverseCuthillMcKee, graph_lib::ReorderMethod::Gorder})
+  {
+    auto compact = original;
+    auto permutation = graph_lib::reorder(compact, method);
+
+    std::vector<bool> seen(permutation.size(), false);
+    for (auto p : permutation) { ASSERT_FALSE(seen[p]); seen[p] = true; }
+
+    EXPECT_EQ(compact.edgeCount(), original.edgeCount());
+    for (auto id : original.externalIds()) { EXPECT_EQ(externalNeighbors(compact, id), externalNeighbors(original, id)); }
+  }
+}
+
+TEST(ReorderTest, TestDegreeSortPutsHubFirst)
+{
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+  for (int i = 0; i < 6; i++) { ids.push_back(*graph.addVertex(i)); }
+  for (int i = 0; i < 5; i++) { graph.addEdge(ids[5], ids[i]); }
+
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  graph_lib::reorder(compact, graph_lib::ReorderMethod::DegreeSort);
+  EXPECT_EQ(compact.externalId(0), ids[5]);
+}
+
+TEST(ReorderTest, TestReverseCuthillMcKeeReducesBandwidth)
+{
+  // A path whose vertices were inserted in a scrambled order
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  const std::vector<int> order{0, 7, 3, 9, 1, 5, 8, 2, 6, 4};
+  std::vector<unsigned int> ids(order.size());
+  for (int value = 0; value < 10; value++) { ids[value] = *graph.addVertex(value); }
+  for (size_t i = 0; i + 1 < order.size(); i++) { graph.addEdge(ids[order[i]], ids[order[i + 1]]); }
+
+  auto bandwidth = [](const graph_lib::CompactGraph& compact)
+  {
+    size_t result = 0;
+    for (graph_lib::CompactGraph::Index v = 0; v < compact.vertexCount(); v++)
+    {
+      for (auto u : compact.neighbors(v)) { result = std::max<size_t>(result, u > v ? u - v : v - u); }
+    }
+    return result;
+  };
+
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  EXPECT_GT(bandwidth(compact), 1u);
+  graph_lib::reorder(compact, graph_lib::ReorderMethod::ReverseCuthillMcKee);
+  EXPECT_EQ(bandwidth(compact), 1u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compressed_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::AdjacencyEncoding;
+using graph_lib::CompactGraph;
+using graph_lib::CompressedGraph;
+
+static const AdjacencyEncoding kEncodings[] = {AdjacencyEncoding::Varint, AdjacencyEncoding::StreamVByte};
+
+
+static void expectSameRows(const CompactGraph& compact, const CompressedGraph& compressed)
+{
+  ASSERT_EQ(compressed.vertexCount(), compact.vertexCount());
+  EXPECT_EQ(compressed.edgeCount(), compact.edgeCount());
+  EXPECT_EQ(compressed.isDirected(), compact.isDirected());
+  std::vector<CompactGraph::Index> buffer;
+  for (CompactGraph::Index v = 0; v < compact.vertexCount(); v++)
+  {
+    const auto expected = compact.neighbors(v);
+    const auto actual = compressed.neighbors(v, buffer);
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end())) << "row " << v;
+    const auto weights = compact.weights(v);
+    const auto stored = compressed.weights(v);
+    EXPECT_TRUE(std::equal(weights.begin(), weights.end(), stored.begin(), stored.end()));
+  }
+}
+
+//! \brief Breadth first order on the CSR snapshot, as a reference.
+static std::vector<unsigned int> referenceBfs(const CompactGraph& graph, CompactGraph::Index source)
+{
+  std::vector<bool> visited(graph.vertexCount(), false);
+  std::vector<CompactGraph::Index> queue{source};
+  std::vector<unsigned int> order;
+  visited[source] = true;
+  for (size_t head = 0; head < queue.size(); head++)
+  {
+    order.push_back(graph.externalId(queue[head]));
+    for (auto u : graph.neighbors(queue[head])) { if (!visited[u]) { visited[u] = true; queue.push_back(u); } }
+  }
+  return order;
+}
+
+//! \brief Recursive depth first preorder on the CSR snapshot, as a reference.
+static void referenceDfs(const CompactGraph& graph, CompactGraph::Index v, std::vector<bool>& visited, std::vector<unsigned int>& order)
+{
+  visited[v] = true;
+  order.push_back(graph.externalId(v));
+  for (auto u : graph.neighbors(v)) { if (!visited[u]) { referenceDfs(graph, u, visited, order); } }
+}
+
+TEST(CompressedGraphTest, TestRoundTripDirected)
+{
+  auto list = graph_lib::rmatEdges(10, 8000, {}, {.seed = 3});
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+  for (auto encoding : kEncodings)
+  {
+    expectSameRows(compact, CompressedGraph::fromCompact(compact, {.encoding = encoding, .threads = 3}));
+  }
+}
+
+TEST(CompressedGraphTest, TestRoundTripWeightedUndirected)
+{
+  auto list = graph_lib::erdosRenyiEdges(300, 2000, {.seed = 4, .weights = graph_lib::WeightDistribution::uniform(1, 5)});
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list);
+  auto compact = CompactGraph::fromGraph(graph);
+  for (auto encoding : kEncodings)
+  {
+    auto compressed = CompressedGraph::fromGraph(graph, {.encoding = encoding});
+    EXPECT_TRUE(compressed.isWeighted());
+    expectSameRows(compact, compressed);
+  }
+}
+
+TEST(CompressedGraphTest, TestLargeGapsAndBackwardNeighbors)
+{
+  // Neighbors far below and far above the vertex exercise every gap length
+  const CompactGraph::Index n = 1u << 18;
+  std::vector<unsigned int> ids(n);
+  std::iota(ids.begin(), ids.end(), 0u);
+  const std::vector<std::tuple<size_t, size_t, float>> edges{
+    {1u << 17, 0, 1}, {1u << 17, 5, 1}, {1u << 17, (1u << 17) + 1, 1}, {1u << 17, n - 1, 1}, {7, 300, 1}, {7, 70000, 1}, {n - 1, 0, 1}};
+  auto compact = CompactGraph::fromEdges(ids, edges, true, false);
+  for (auto encoding : kEncodings) { expectSameRows(compact, CompressedGraph::fromCompact(compact, {.encoding = encoding})); }
+}
+
+TEST(CompressedGraphTest, TestFirstGapAcrossFullIndexRange)
+{
+  // Graphs past 2^31 vertices are too large to build here, so check the first gap's code directly
+  using graph_lib::detail::zigzag;
+  using graph_lib::detail::unzigzag;
+  const std::vector<CompactGraph::Index> indices{0, 1, 5, (1u << 31) - 1, 1u << 31, (1u << 31) + 1, 0xfffffffeu, 0xffffffffu};
+  for (auto v : indices)
+  {
+    for (auto u : indices) { EXPECT_EQ(static_cast<CompactGraph::Index>(v + unzigzag(zigzag(u - v))), u) << v << " -> " << u; }
+  }
+
+  // Small differences of either sign keep small codes
+  EXPECT_EQ(zigzag(0), 0u);
+  EXPECT_EQ(zigzag(0u - 1), 1u);
+  EXPECT_EQ(zigzag(1), 2u);
+  EXPECT_EQ(zigzag(0u - 64), 127u);
+}
+
+TEST(CompressedGraphTest, TestTraversalsMatchCompactGraph)
+{
+  auto list = graph_lib::rmatEdges(9, 3000, {}, {.seed = 8});
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+  for (auto encoding : kEncodings)
+  {
+    auto compressed = CompressedGraph::fromCompact(compact, {.encoding = encoding});
+    for (CompactGraph::Index source : {0u, 17u, 200u})
+    {
+      EXPECT_EQ(graph_lib::breadthFirstOrder(compressed, compact.externalId(source)), referenceBfs(compact, source));
+
+      std::vector<bool> visited(compact.vertexCount(), false);
+      std::vector<unsigned int> expected;
+      referenceDfs(compact, source, visited, expected);
+      EXPECT_EQ(graph_lib::depthFirstOrder(compressed, compact.externalId(source)), expected);
+    }
+    EXPECT_TRUE(graph_lib::breadthFirstOrder(compressed, 1u << 30).empty());
+  }
+}
+
+TEST(CompressedGraphTest, TestCompressesLocalGraphs)
+{
+  // Grid neighbors are close in index, so most gaps fit in one byte
+  auto list = graph_lib::gridEdges(100, 100);
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedUndirectedGraph<int>>(list));
+  for (auto encoding : kEncodings)
+  {
+    auto compressed = CompressedGraph::fromCompact(compact, {.encoding = encoding});
+    EXPECT_LT(compressed.bytesPerEdge(), 1.5);
+    EXPECT_LT(compressed.adjacencyBytes(), compact.edgeCount() * sizeof(CompactGraph::Index) / 2);
+  }
+}
+
+TEST(CompressedGraphTest, TestIds)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  auto b = *graph.addVertex(2);
+  graph.addEdge(a, b);
+  auto compressed = CompressedGraph::fromGraph(graph);
+  ASSERT_TRUE(compressed.internalId(b).has_value());
+  EXPECT_EQ(compressed.externalId(*compressed.internalId(b)), b);
+  EXPECT_FALSE(compressed.internalId(b + 1).has_value());
+  EXPECT_EQ(graph_lib::breadthFirstOrder(compressed, a), (std::vector<unsigned int>{a, b}));
+}
+
+TEST(CompressedGraphTest, TestEmptyGraph)
+{
+  auto compressed = CompressedGraph::fromCompact(CompactGraph());
+  EXPECT_EQ(compressed.vertexCount(), 0u);
+  EXPECT_EQ(compressed.bytesPerEdge(), 0);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
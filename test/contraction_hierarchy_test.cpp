@@ -0,0 +1,204 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/contraction_hierarchy.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/shortest_path.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::CompactGraph;
+using graph_lib::ContractionHierarchy;
+
+
+//! \brief Check every hierarchy query against the bidirectional Dijkstra of the same graph.
+static void expectMatchesDijkstra(const ContractionHierarchy& hierarchy, const graph_lib::ShortestPathEngine& engine, size_t stride)
+{
+  const auto& graph = engine.graph();
+  for (CompactGraph::Index s = 0; s < graph.vertexCount(); s += stride)
+  {
+    for (CompactGraph::Index t = 0; t < graph.vertexCount(); t += stride + 1)
+    {
+      const auto source = graph.externalId(s), target = graph.externalId(t);
+      auto expected = engine.bidirectionalDijkstra(source, target);
+      auto actual = hierarchy.query(source, target);
+      ASSERT_EQ(actual.found(), expected.found());
+      if (!expected.found()) { continue; }
+      EXPECT_NEAR(actual.distance, expected.distance, 1e-3);
+
+      // The unpacked path only uses edges of the original graph and adds up to the distance
+      ASSERT_EQ(actual.path.front(), source);
+      ASSERT_EQ(actual.path.back(), target);
+      float length = 0;
+      for (size_t i = 0; i + 1 < actual.path.size(); i++)
+      {
+        const auto v = *graph.internalId(actual.path[i]), u = *graph.internalId(actual.path[i + 1]);
+        float edge = std::numeric_limits<float>::infinity();
+        for (size_t e = 0; e < graph.degree(v); e++) { if (graph.neighbors(v)[e] == u) { edge = std::min(edge, graph.weight(v, e)); } }
+        ASSERT_TRUE(std::isfinite(edge));
+        length += edge;
+      }
+      EXPECT_NEAR(length, actual.distance, 1e-3);
+    }
+  }
+}
+
+TEST(ContractionHierarchyTest, TestDirected)
+{
+  auto list = graph_lib::erdosRenyiEdges(300, 1000, {.seed = 5, .weights = graph_lib::WeightDistribution::uniform(1, 20)});
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<unsigned int>>(list));
+  auto hierarchy = ContractionHierarchy::build(compact, {.threads = 4});
+  graph_lib::ShortestPathEngine engine(compact);
+
+  EXPECT_EQ(hierarchy.vertexCount(), 300u);
+  expectMatchesDijkstra(hierarchy, engine, 7);
+}
+
+TEST(ContractionHierarchyTest, TestUndirectedGrid)
+{
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<unsigned int>>(
+    graph_lib::gridEdges(20, 20, {.seed = 2, .weights = graph_lib::WeightDistribution::uniform(1, 3)}));
+  auto hierarchy = ContractionHierarchy::build(graph, {.threads = 2});
+  graph_lib::ShortestPathEngine engine(CompactGraph::fromGraph(graph));
+
+  expectMatchesDijkstra(hierarchy, engine, 11);
+  EXPECT_GT(hierarchy.shortcutCount(), 0u);
+
+  // The query climbs the hierarchy instead of settling most of the grid
+  const auto& compact = engine.graph();
+  auto result = hierarchy.query(compact.externalId(0), compact.externalId(399));
+  EXPECT_LT(result.settled, engine.bidirectionalDijkstra(compact.externalId(0), compact.externalId(399)).settled);
+}
+
+TEST(ContractionHierarchyTest, TestSaveAndLoad)
+{
+  auto list = graph_lib::erdosRenyiEdges(120, 400, {.seed = 9, .weights = graph_lib::WeightDistribution::uniform(1, 5)});
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<unsigned int>>(list));
+  auto hierarchy = ContractionHierarchy::build(compact, {.threads = 1});
+
+  std::stringstream stream;
+  hierarchy.save(stream);
+  auto loaded = ContractionHierarchy::load(stream);
+
+  EXPECT_EQ(loaded.vertexCount(), hierarchy.vertexCount());
+  EXPECT_EQ(loaded.edgeCount(), hierarchy.edgeCount());
+  EXPECT_EQ(loaded.level(compact.externalId(3)), hierarchy.level(compact.externalId(3)));
+  for (CompactGraph::Index s = 0; s < 120; s += 13)
+  {
+    for (CompactGraph::Index t = 0; t < 120; t += 5)
+    {
+      auto a = hierarchy.query(compact.externalId(s), compact.externalId(t));
+      auto b = loaded.query(compact.externalId(s), compact.externalId(t));
+      EXPECT_EQ(a.path, b.path);
+      if (a.found()) { EXPECT_FLOAT_EQ(a.distance, b.distance); }
+    }
+  }
+}
+
+TEST(ContractionHierarchyTest, TestLoadRejectsBadInput)
+{
+  std::stringstream garbage("not a hierarchy");
+  EXPECT_THROW(ContractionHierarchy::load(garbage), std::runtime_error);
+
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<unsigned int>>(
+    graph_lib::erdosRenyiEdges(30, 60, {.seed = 1})));
+  std::stringstream stream;
+  ContractionHierarchy::build(compact).save(stream);
+  std::string bytes = stream.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+  EXPECT_THROW(ContractionHierarchy::load(truncated), std::runtime_error);
+}
+
+//! \brief The stored edges of one direction of a hand-written hierarchy file.
+struct ArcLists
+{
+  std::vector<uint64_t> offsets;
+  std::vector<CompactGraph::Index> targets;
+  std::vector<float> weights;
+  std::vector<CompactGraph::Index> middles;
+};
+
+template <typename V>
+static void writeVector(std::ostream& stream, const std::vector<V>& values)
+{
+  const uint64_t size = values.size();
+  stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(V)));
+}
+
+//! \brief A hierarchy file in the format written by ContractionHierarchy::save.
+static std::stringstream hierarchyFile(const std::vector<CompactGraph::Index>& ranks, const ArcLists& upward, const ArcLists& downward)
+{
+  std::stringstream stream;
+  stream.write("GLCH0001", 8);
+  writeVector(stream, std::vector<unsigned int>{10, 11, 12});
+  writeVector(stream, ranks);
+  for (const auto* arcs : {&upward, &downward})
+  {
+    writeVector(stream, arcs->offsets);
+    writeVector(stream, arcs->targets);
+    writeVector(stream, arcs->weights);
+    writeVector(stream, arcs->middles);
+  }
+  return stream;
+}
+
+TEST(ContractionHierarchyTest, TestLoadRejectsInconsistentHierarchies)
+{
+  // The path 10 -> 11 -> 12 with 11 contracted first, leaving the shortcut 10 -> 12 through it
+  constexpr auto kNone = std::numeric_limits<CompactGraph::Index>::max();
+  const std::vector<CompactGraph::Index> ranks{1, 0, 2};
+  const ArcLists upward{{0, 1, 2, 2}, {2, 2}, {2, 1}, {1, kNone}};
+  const ArcLists downward{{0, 0, 1, 1}, {0}, {1}, {kNone}};
+
+  auto valid = hierarchyFile(ranks, upward, downward);
+  auto loaded = ContractionHierarchy::load(valid);
+  EXPECT_EQ(loaded.query(10, 12).path, (std::vector<unsigned int>{10, 11, 12}));
+
+  // A level that no contraction of three vertices reaches
+  auto level = hierarchyFile({1, 0, 7}, upward, downward);
+  EXPECT_THROW(ContractionHierarchy::load(level), std::runtime_error);
+
+  // 11 and 12 on one level, so the edge 11 -> 12 does not go up
+  auto flat = hierarchyFile({1, 0, 0}, upward, downward);
+  EXPECT_THROW(ContractionHierarchy::load(flat), std::runtime_error);
+
+  // The edge 10 -> 11 that the shortcut expands into is missing
+  auto missing = hierarchyFile(ranks, upward, {{0, 0, 0, 0}, {}, {}, {}});
+  EXPECT_THROW(ContractionHierarchy::load(missing), std::runtime_error);
+
+  // A shortcut through one of its own ends would expand forever
+  ArcLists looping = upward;
+  looping.middles[0] = 0;
+  auto cyclic = hierarchyFile(ranks, looping, downward);
+  EXPECT_THROW(ContractionHierarchy::load(cyclic), std::runtime_error);
+}
+
+TEST(ContractionHierarchyTest, TestEdgeCases)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto id0 = graph.addVertex(0);
+  auto id1 = graph.addVertex(1);
+  auto id2 = graph.addVertex(2);
+  graph.addEdge(*id0, *id1, 0.0f);
+  graph.addEdge(*id1, *id2, 0.0f);
+  graph.addEdge(*id0, *id2, 1.0f);
+  auto hierarchy = ContractionHierarchy::build(graph);
+
+  auto path = hierarchy.query(*id0, *id2);
+  EXPECT_FLOAT_EQ(path.distance, 0.0f);
+  EXPECT_EQ(path.path, (std::vector<unsigned int>{*id0, *id1, *id2}));
+  EXPECT_EQ(hierarchy.query(*id1, *id1).path, (std::vector<unsigned int>{*id1}));
+  EXPECT_FALSE(hierarchy.query(*id2, *id0).found());
+  EXPECT_FALSE(hierarchy.query(*id0, *id2 + 1000).found());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
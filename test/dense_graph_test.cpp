@@ -0,0 +1,192 @@
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/dense_graph.hpp>
+#include <graph_lib/visitor.hpp>
+
+static_assert(graph_lib::TraversableGraph<graph_lib::DenseUnweightedDirectedGraph<int>>);
+static_assert(graph_lib::TraversableGraph<graph_lib::DenseWeightedUndirectedGraph<int>>);
+static_assert(std::input_iterator<graph_lib::DenseGraphIterator<graph_lib::DenseUnweightedDirectedGraph<int>>>);
+
+//! \brief A value whose copy throws once a countdown of copies runs out.
+struct FragileValue
+{
+  static inline int copies_left = -1;
+
+  int value;
+
+  FragileValue(int v): value(v) {}
+  FragileValue(const FragileValue& other): value(other.value)
+  {
+    if (copies_left >= 0 && copies_left-- == 0) { throw std::runtime_error("copy failed"); }
+  }
+
+  bool operator==(const FragileValue& other) const { return value == other.value; }
+};
+
+template <>
+struct std::hash<FragileValue>
+{
+  size_t operator()(const FragileValue& v) const noexcept { return std::hash<int>()(v.value); }
+};
+
+
+class DenseGraphTestBasic : public testing::Test
+{
+public:
+  graph_lib::DenseUnweightedDirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+
+  //! \brief 200 vertices, so the matrix grows past one word per row.
+  //! Vertex i has edges to 2i and 2i + 1.
+  void SetUp()
+  {
+    for (int i = 0; i < 200; i++) { ids.push_back(*graph.addVertex(i)); }
+    for (int i = 0; i < 100; i++)
+    {
+      graph.addEdge(ids[i], ids[2 * i]);
+      graph.addEdge(ids[i], ids[2 * i + 1]);
+    }
+  }
+
+  template <typename Itr>
+  static std::vector<int> values(Itr first, Itr last)
+  {
+    std::vector<int> result;
+    for (; first != last; ++first) { result.push_back(*(**first).data); }
+    return result;
+  }
+};
+
+TEST_F(DenseGraphTestBasic, TestAddAndQuery)
+{
+  EXPECT_EQ(graph.getSize(), 200u);
+  EXPECT_FALSE(graph.addVertex(5).has_value());
+  EXPECT_FALSE(graph.addEdge(ids[3], ids[6]));
+  EXPECT_FALSE(graph.addEdge(ids[3], ids.back() + 1000));
+
+  EXPECT_TRUE(graph.hasEdge(ids[3], ids[6]));
+  EXPECT_TRUE(graph.hasEdge(ids[99], ids[199]));
+  EXPECT_FALSE(graph.hasEdge(ids[6], ids[3]));
+  EXPECT_EQ(graph.degree(ids[0]), 2u);
+  EXPECT_EQ(graph.degree(ids[150]), 0u);
+  EXPECT_EQ(*(**graph.getVertex(ids[42])).data, 42);
+
+  std::vector<int> neighbors;
+  graph.forEachNeighbor(**graph.getVertex(ids[70]), [&](const auto& dest, float) { neighbors.push_back(*(*dest).data); });
+  EXPECT_EQ(neighbors, (std::vector<int>{140, 141}));
+}
+
+TEST_F(DenseGraphTestBasic, TestIterators)
+{
+  auto all = values(graph.begin(), graph.end());
+  EXPECT_EQ(all.size(), 200u);
+  EXPECT_EQ(all.front(), 0);
+
+  // A binary tree rooted at 1, with 0 looping to itself and 1
+  auto bfs = values(graph.bfs_begin(), graph.bfs_end());
+  ASSERT_EQ(bfs.size(), 200u);
+  EXPECT_EQ(std::vector<int>(bfs.begin(), bfs.begin() + 8), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+
+  auto dfs = values(graph.dfs_begin(), graph.dfs_end());
+  ASSERT_EQ(dfs.size(), 200u);
+  EXPECT_EQ(std::set<int>(dfs.begin(), dfs.end()).size(), 200u);
+  EXPECT_EQ(dfs[0], 0);
+  EXPECT_EQ(dfs[1], 1);
+  // Depth first goes down a branch before visiting its sibling
+  EXPECT_EQ(dfs[2], 3);
+}
+
+TEST_F(DenseGraphTestBasic, TestAlgorithms)
+{
+  auto compact = graph_lib::CompactGraph::fromGraph(graph);
+  EXPECT_EQ(compact.vertexCount(), 200u);
+  EXPECT_EQ(compact.edgeCount(), 200u);
+
+  struct
+  {
+    unsigned deepest = 0;
+    void discoverVertex(const std::shared_ptr<graph_lib::Vertex<int>>&, unsigned depth) { deepest = std::max(deepest, depth); }
+  } visitor;
+  auto summary = graph_lib::breadthFirstVisit(graph, ids[1], visitor);
+  EXPECT_EQ(summary.vertices_discovered, 199u);
+  EXPECT_EQ(visitor.deepest, 7u);
+}
+
+TEST(DenseGraphTest, TestWeightedUndirected)
+{
+  graph_lib::DenseWeightedUndirectedGraph<std::string> graph;
+  auto a = graph.addVertex("a");
+  auto b = graph.addVertex("b");
+  auto c = graph.addVertex("c");
+  auto d = graph.addVertex("d");
+
+  EXPECT_TRUE(graph.addEdge(*a, *b, 1.5f));
+  EXPECT_TRUE(graph.addEdge(*a, *c, 2.0f));
+  EXPECT_TRUE(graph.addEdge(*b, *c, 3.0f));
+  EXPECT_TRUE(graph.addEdge(*d, *d, 4.0f));
+  EXPECT_FALSE(graph.addEdge(*b, *a, 9.0f));
+
+  EXPECT_TRUE(graph.hasEdge(*b, *a));
+  EXPECT_EQ(graph.getWeight(*b, *a), 1.5f);
+  EXPECT_EQ(graph.getWeight(*d, *d), 4.0f);
+  EXPECT_FALSE(graph.getWeight(*a, *d).has_value());
+  EXPECT_EQ(graph.degree(*a), 2u);
+  EXPECT_EQ(graph.commonNeighbors(*a, *b), 1u);
+
+  float total = 0;
+  graph.forEachNeighbor(**graph.getVertex(*c), [&](const auto&, float weight) { total += weight; });
+  EXPECT_FLOAT_EQ(total, 5.0f);
+}
+
+TEST(DenseGraphTest, TestEmpty)
+{
+  graph_lib::DenseUnweightedUndirectedGraph<int> graph;
+  EXPECT_TRUE(graph.begin() == graph.end());
+  EXPECT_TRUE(graph.dfs_begin() == graph.dfs_end());
+  EXPECT_TRUE(graph.bfs_begin() == graph.bfs_end());
+  EXPECT_FALSE(graph.getVertex(0).has_value());
+}
+
+TEST(DenseGraphTest, TestFailedInsertLeavesGraphUnchanged)
+{
+  graph_lib::DenseUnweightedDirectedGraph<FragileValue> graph;
+  std::vector<unsigned int> ids;
+  for (int i = 0; i < 64; i++) { ids.push_back(*graph.addVertex(i)); }
+  graph.addEdge(ids[0], ids[63]);
+
+  // The copy into the vertex fails after the matrices grew, then the copy into the value map fails
+  for (int copies : {0, 1})
+  {
+    FragileValue::copies_left = copies;
+    EXPECT_FALSE(graph.addVertex(64).has_value());
+    FragileValue::copies_left = -1;
+    EXPECT_EQ(graph.getSize(), 64u);
+    EXPECT_EQ(graph.getVertices().size(), 64u);
+    EXPECT_FALSE(graph.findVertex(64).has_value());
+    EXPECT_TRUE(graph.hasEdge(ids[0], ids[63]));
+  }
+
+  auto id = graph.addVertex(64);
+  ASSERT_TRUE(id.has_value());
+  EXPECT_EQ(graph.findVertex(64), id);
+  EXPECT_TRUE(graph.addEdge(*id, ids[0]));
+}
+
+TEST(DenseGraphTest, TestFindVertex)
+{
+  graph_lib::DenseUnweightedDirectedGraph<int> graph;
+  auto a = graph.addVertex(3);
+  EXPECT_EQ(graph.findVertex(3), a);
+  EXPECT_FALSE(graph.findVertex(4).has_value());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
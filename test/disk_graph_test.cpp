@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/disk_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::CompactGraph;
+using graph_lib::DiskGraph;
+using graph_lib::DiskGraphWriter;
+
+
+//! \brief A scratch directory removed at the end of the test.
+class TempDirectory
+{
+public:
+  explicit TempDirectory(const std::string& name)
+    : path_(std::filesystem::temp_directory_path() / ("graph_lib_" + name + "_" + std::to_string(::getpid())))
+  {
+    std::filesystem::remove_all(path_);
+  }
+  ~TempDirectory() { std::filesystem::remove_all(path_); }
+
+  const std::filesystem::path& path() const { return path_; }
+
+private:
+  std::filesystem::path path_;
+};
+
+static CompactGraph rmatGraph(unsigned seed)
+{
+  auto list = graph_lib::rmatEdges(9, 3000, {}, {.seed = seed});
+  return CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+}
+
+static void expectSameRows(const CompactGraph& compact, const DiskGraph& disk)
+{
+  ASSERT_EQ(disk.vertexCount(), compact.vertexCount());
+  EXPECT_EQ(disk.edgeCount(), compact.edgeCount());
+  EXPECT_EQ(disk.isDirected(), compact.isDirected());
+  EXPECT_EQ(disk.isWeighted(), compact.isWeighted());
+  std::vector<CompactGraph::Index> buffer;
+  std::vector<float> weight_buffer;
+  for (CompactGraph::Index v = 0; v < compact.vertexCount(); v++)
+  {
+    EXPECT_EQ(disk.externalId(v), compact.externalId(v));
+    EXPECT_EQ(disk.degree(v), compact.degree(v));
+    const auto expected = compact.neighbors(v);
+    const auto actual = disk.neighbors(v, buffer);
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end())) << "row " << v;
+    const auto weights = compact.weights(v);
+    const auto stored = disk.weights(v, weight_buffer);
+    EXPECT_TRUE(std::equal(weights.begin(), weights.end(), stored.begin(), stored.end()));
+  }
+}
+
+TEST(DiskGraphTest, TestRoundTripDirected)
+{
+  TempDirectory directory("round_trip");
+  auto compact = rmatGraph(1);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 100});
+  auto disk = DiskGraph::open(directory.path());
+  EXPECT_EQ(disk.partitionCount(), (compact.vertexCount() + 99) / 100);
+  expectSameRows(compact, disk);
+
+  size_t edges = 0;
+  disk.streamEdges([&](auto origin, auto dest, float weight)
+  {
+    EXPECT_TRUE(std::binary_search(compact.neighbors(origin).begin(), compact.neighbors(origin).end(), dest));
+    EXPECT_EQ(weight, 1.0f);
+    edges++;
+  });
+  EXPECT_EQ(edges, compact.edgeCount());
+}
+
+TEST(DiskGraphTest, TestRoundTripWeightedUndirected)
+{
+  TempDirectory directory("weighted");
+  auto list = graph_lib::erdosRenyiEdges(300, 2000, {.seed = 4, .weights = graph_lib::WeightDistribution::uniform(1, 5)});
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list);
+  auto compact = CompactGraph::fromGraph(graph);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 64});
+  expectSameRows(compact, DiskGraph::open(directory.path()));
+}
+
+TEST(DiskGraphTest, TestWriterSpillsEdges)
+{
+  TempDirectory directory("writer");
+  const size_t n = 1000;
+  std::vector<unsigned int> ids(n);
+  std::iota(ids.begin(), ids.end(), 5000u);
+  std::vector<std::tuple<size_t, size_t, float>> edges;
+  for (size_t i = 0; i < 20000; i++) { edges.emplace_back((i * 7919) % n, (i * 104729 + 3) % n, static_cast<float>(i % 13)); }
+
+  {
+    DiskGraphWriter writer(directory.path(), ids, true, true, {.partition_vertices = 128, .spill_edges = 1000});
+    for (const auto& [origin, dest, weight] : edges) { writer.addEdge(origin, dest, weight); }
+    EXPECT_THROW(writer.addEdge(0, n), std::invalid_argument);
+    writer.finish();
+  }
+  auto disk = DiskGraph::open(directory.path());
+  expectSameRows(CompactGraph::fromEdges(ids, edges, true, true), disk);
+  EXPECT_EQ(disk.internalId(5007), 7u);
+  EXPECT_FALSE(disk.internalId(4999).has_value());
+  EXPECT_FALSE(std::filesystem::exists(directory.path() / "partition-0.spill"));
+}
+
+TEST(DiskGraphTest, TestCacheBudget)
+{
+  TempDirectory directory("cache");
+  auto compact = rmatGraph(2);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 64});
+
+  // A budget of one byte keeps only the partition being read
+  auto small = DiskGraph::open(directory.path(), {.cache_bytes = 1});
+  for (int pass = 0; pass < 2; pass++)
+  {
+    for (size_t p = 0; p < small.partitionCount(); p++)
+    {
+      small.streamPartition(p, [&](auto, auto, auto) {});
+      EXPECT_EQ(small.mappedBytes(), std::filesystem::file_size(directory.path() / ("partition-" + std::to_string(p) + ".bin")));
+    }
+  }
+  EXPECT_EQ(small.partitionLoads(), 2 * small.partitionCount());
+
+  // Nested reads keep the outer partition mapped
+  const auto last = static_cast<CompactGraph::Index>(compact.vertexCount() - 1);
+  size_t nested = 0;
+  small.forEachNeighbor(0, [&](auto) { nested += small.degree(last); });
+  EXPECT_EQ(nested, compact.degree(0) * compact.degree(last));
+
+  auto large = DiskGraph::open(directory.path());
+  for (int pass = 0; pass < 2; pass++) { large.streamEdges([](auto, auto, auto) {}); }
+  EXPECT_EQ(large.partitionLoads(), large.partitionCount());
+}
+
+TEST(DiskGraphTest, TestTraversals)
+{
+  TempDirectory directory("traversals");
+  auto compact = rmatGraph(8);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 50});
+  auto disk = DiskGraph::open(directory.path(), {.cache_bytes = 4096});
+
+  for (CompactGraph::Index source : {0u, 17u, 200u})
+  {
+    // Reference BFS levels and order on the CSR snapshot
+    std::vector<uint32_t> levels(compact.vertexCount(), graph_lib::kUnreachedLevel);
+    std::vector<unsigned int> order;
+    std::vector<CompactGraph::Index> queue{source};
+    levels[source] = 0;
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+      order.push_back(compact.externalId(queue[head]));
+      for (auto u : compact.neighbors(queue[head]))
+      {
+        if (levels[u] == graph_lib::kUnreachedLevel) { levels[u] = levels[queue[head]] + 1; queue.push_back(u); }
+      }
+    }
+
+    EXPECT_EQ(graph_lib::streamingBfs(disk, compact.externalId(source)), levels);
+    EXPECT_EQ(graph_lib::breadthFirstOrder(disk, compact.externalId(source)), order);
+    auto dfs = graph_lib::depthFirstOrder(disk, compact.externalId(source));
+    EXPECT_EQ(dfs.size(), order.size());
+    EXPECT_EQ(dfs.front(), compact.externalId(source));
+  }
+  EXPECT_TRUE(graph_lib::streamingBfs(disk, 1u << 30).empty());
+  EXPECT_TRUE(graph_lib::depthFirstOrder(disk, 1u << 30).empty());
+}
+
+TEST(DiskGraphTest, TestComponents)
+{
+  TempDirectory directory("components");
+  // Two chains, 0 -> 1 -> ... -> 9 and 19 -> 18 -> ... -> 10, plus the isolated vertex 20
+  const size_t n = 21;
+  std::vector<unsigned int> ids(n);
+  std::iota(ids.begin(), ids.end(), 0u);
+  std::vector<std::tuple<size_t, size_t, float>> edges;
+  for (size_t v = 0; v < 9; v++) { edges.emplace_back(v, v + 1, 1); }
+  for (size_t v = 19; v > 10; v--) { edges.emplace_back(v, v - 1, 1); }
+  DiskGraph::write(CompactGraph::fromEdges(ids, edges, true, false), directory.path(), {.partition_vertices = 4});
+
+  auto labels = graph_lib::streamingComponents(DiskGraph::open(directory.path()));
+  ASSERT_EQ(labels.size(), n);
+  for (size_t v = 0; v < 10; v++) { EXPECT_EQ(labels[v], 0u); }
+  for (size_t v = 10; v < 20; v++) { EXPECT_EQ(labels[v], 10u); }
+  EXPECT_EQ(labels[20], 20u);
+}
+
+TEST(DiskGraphTest, TestComponentsMatchUnionFind)
+{
+  TempDirectory directory("union_find");
+  auto list = graph_lib::erdosRenyiEdges(2000, 1500, {.seed = 6});
+  auto compact = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedUndirectedGraph<int>>(list));
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 256});
+
+  std::vector<CompactGraph::Index> parent(compact.vertexCount());
+  std::iota(parent.begin(), parent.end(), 0u);
+  auto find = [&](CompactGraph::Index v) { while (parent[v] != v) { v = parent[v] = parent[parent[v]]; } return v; };
+  for (CompactGraph::Index v = 0; v < compact.vertexCount(); v++)
+  {
+    for (auto u : compact.neighbors(v))
+    {
+      auto a = find(v), b = find(u);
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+  auto labels = graph_lib::streamingComponents(DiskGraph::open(directory.path(), {.cache_bytes = 1}));
+  for (CompactGraph::Index v = 0; v < compact.vertexCount(); v++) { EXPECT_EQ(labels[v], find(v)) << "vertex " << v; }
+}
+
+TEST(DiskGraphTest, TestPageRank)
+{
+  TempDirectory directory("pagerank");
+  auto compact = rmatGraph(5);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 100});
+  auto ranks = graph_lib::streamingPageRank(DiskGraph::open(directory.path()), {.tolerance = 1e-12});
+
+  // Reference power iteration over the CSR snapshot
+  const size_t n = compact.vertexCount();
+  std::vector<double> expected(n, 1.0 / n), next(n);
+  for (int iteration = 0; iteration < 100; iteration++)
+  {
+    double dangling = 0;
+    std::fill(next.begin(), next.end(), 0.0);
+    for (CompactGraph::Index v = 0; v < n; v++)
+    {
+      if (compact.degree(v) == 0) { dangling += expected[v]; }
+      for (auto u : compact.neighbors(v)) { next[u] += expected[v] / compact.degree(v); }
+    }
+    for (size_t v = 0; v < n; v++) { next[v] = 0.15 / n + 0.85 * (next[v] + dangling / n); }
+    expected.swap(next);
+  }
+
+  ASSERT_EQ(ranks.size(), n);
+  EXPECT_NEAR(std::accumulate(ranks.begin(), ranks.end(), 0.0), 1.0, 1e-9);
+  for (size_t v = 0; v < n; v++) { EXPECT_NEAR(ranks[v], expected[v], 1e-9); }
+}
+
+TEST(DiskGraphTest, TestInvalidFiles)
+{
+  TempDirectory directory("invalid");
+  EXPECT_THROW(DiskGraph::open(directory.path()), std::runtime_error);
+
+  auto compact = rmatGraph(3);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 100});
+  std::filesystem::resize_file(directory.path() / "partition-1.bin", 100);
+  auto disk = DiskGraph::open(directory.path());
+  EXPECT_NO_THROW(disk.degree(0));
+  EXPECT_THROW(disk.degree(100), std::runtime_error);
+
+  std::filesystem::remove(directory.path() / "partition-2.bin");
+  EXPECT_THROW(DiskGraph::open(directory.path()), std::runtime_error);
+  EXPECT_THROW(DiskGraphWriter(directory.path(), {1, 2}, true, false, {.partition_vertices = 0}), std::invalid_argument);
+}
+
+//! \brief Overwrite a word of a file in place.
+template <typename V>
+static void patchFile(const std::filesystem::path& path, size_t position, V value)
+{
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(static_cast<std::streamoff>(position));
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST(DiskGraphTest, TestCorruptRows)
+{
+  TempDirectory directory("corrupt");
+  auto compact = rmatGraph(4);
+  DiskGraph::write(compact, directory.path(), {.partition_vertices = 100});
+  const auto partition = directory.path() / "partition-0.bin";
+  const size_t offsets = sizeof(graph_lib::detail::PartitionHeader), targets = offsets + 101 * sizeof(uint64_t);
+  ASSERT_GT(compact.offsets()[100], compact.offsets()[1]);
+
+  // A row ending before it starts
+  patchFile(partition, offsets + sizeof(uint64_t), static_cast<uint64_t>(compact.offsets()[100] + 1));
+  EXPECT_THROW(DiskGraph::open(directory.path()).degree(0), std::runtime_error);
+  patchFile(partition, offsets + sizeof(uint64_t), static_cast<uint64_t>(compact.offsets()[1]));
+  EXPECT_NO_THROW(DiskGraph::open(directory.path()).degree(0));
+
+  // A target past the last vertex
+  patchFile(partition, targets, static_cast<DiskGraph::Index>(compact.vertexCount()));
+  EXPECT_THROW(DiskGraph::open(directory.path()).degree(0), std::runtime_error);
+}
+
+TEST(DiskGraphTest, TestEmptyGraph)
+{
+  TempDirectory directory("empty");
+  DiskGraph::write(CompactGraph(), directory.path());
+  auto disk = DiskGraph::open(directory.path());
+  EXPECT_EQ(disk.vertexCount(), 0u);
+  EXPECT_EQ(disk.partitionCount(), 0u);
+  EXPECT_TRUE(graph_lib::streamingComponents(disk).empty());
+  EXPECT_TRUE(graph_lib::streamingPageRank(disk).empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+
+static bool sameEdges(const graph_lib::EdgeList& a, const graph_lib::EdgeList& b)
+{
+  if (a.vertex_count != b.vertex_count || a.edges.size() != b.edges.size()) { return false; }
+  for (size_t i = 0; i < a.edges.size(); i++)
+  {
+    if (a.edges[i].origin != b.edges[i].origin) { return false; }
+    if (a.edges[i].dest != b.edges[i].dest) { return false; }
+    if (a.edges[i].weight != b.edges[i].weight) { return false; }
+  }
+  return true;
+}
+
+TEST(GeneratorsTest, TestIndependentOfThreadCount)
+{
+  graph_lib::GeneratorOptions one{42, 1, graph_lib::WeightDistribution::uniform(1.0f, 10.0f)};
+  graph_lib::GeneratorOptions four{42, 4, graph_lib::WeightDistribution::uniform(1.0f, 10.0f)};
+
+  EXPECT_TRUE(sameEdges(graph_lib::rmatEdges(10, 5000, {}, one), graph_lib::rmatEdges(10, 5000, {}, four)));
+  EXPECT_TRUE(sameEdges(graph_lib::erdosRenyiEdges(500, 5000, one), graph_lib::erdosRenyiEdges(500, 5000, four)));
+  EXPECT_TRUE(sameEdges(graph_lib::barabasiAlbertEdges(500, 3, one), graph_lib::barabasiAlbertEdges(500, 3, four)));
+  EXPECT_TRUE(sameEdges(graph_lib::gridEdges(20, 30, one), graph_lib::gridEdges(20, 30, four)));
+}
+
+TEST(GeneratorsTest, TestSeedChangesGraph)
+{
+  EXPECT_FALSE(sameEdges(graph_lib::rmatEdges(10, 1000, {}, {1}), graph_lib::rmatEdges(10, 1000, {}, {2})));
+}
+
+TEST(GeneratorsTest, TestEdgeEndpointsInRange)
+{
+  auto rmat = graph_lib::rmatEdges(8, 2000);
+  for (const auto& edge : rmat.edges) { EXPECT_LT(edge.origin, 256u); EXPECT_LT(edge.dest, 256u); }
+
+  auto er = graph_lib::erdosRenyiEdges(100, 2000);
+  for (const auto& edge : er.edges) { EXPECT_NE(edge.origin, edge.dest); EXPECT_LT(edge.dest, 100u); }
+
+  auto ba = graph_lib::barabasiAlbertEdges(100, 2);
+  EXPECT_EQ(ba.edges.size(), 198u);
+  for (const auto& edge : ba.edges) { EXPECT_LT(edge.dest, edge.origin); }
+  for (const auto& edge : graph_lib::barabasiAlbertEdges(2000, 5, {.seed = 3}).edges) { EXPECT_LT(edge.dest, edge.origin); }
+}
+
+TEST(GeneratorsTest, TestWeightDistribution)
+{
+  graph_lib::GeneratorOptions options{7, 2, graph_lib::WeightDistribution::uniform(2.0f, 3.0f)};
+  for (const auto& edge : graph_lib::erdosRenyiEdges(50, 500, options).edges)
+  {
+    EXPECT_GE(edge.weight, 2.0f);
+    EXPECT_LT(edge.weight, 3.0f);
+  }
+}
+
+TEST(GeneratorsTest, TestBuildGrid)
+{
+  auto list = graph_lib::gridEdges(3, 4);
+  EXPECT_EQ(list.edges.size(), 17u);
+
+  auto directed = graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list);
+  auto undirected = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list);
+  EXPECT_EQ(directed.getSize(), 12u);
+  EXPECT_EQ(undirected.getSize(), 12u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,9 @@
 #include <algorithm>
+#include <concepts>
 #include <optional>
+#include <ranges>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <graph_lib/directed_graph.hpp>
@@ -213,6 +217,239 @@ TEST_F(GraphTestWithVertices, TestGraphSize)
   EXPECT_EQ(weighted_undirected_graph.getSize(), 2);
 }
 
+TEST_F(UnweightedDirectedGraphTestBasic, TestMemoryUsage)
+{
+  auto usage = graph.memoryUsage();
+  EXPECT_GT(usage.vertex_table, 5 * sizeof(graph_lib::Vertex<int>));
+  EXPECT_EQ(usage.payloads, 5 * sizeof(int));
+  EXPECT_GT(usage.adjacency_buckets, 0u);
+  EXPECT_EQ(usage.edge_nodes, 5 * sizeof(graph_lib::Edge<int>));
+  EXPECT_GT(usage.auxiliary_indexes, 0u);
+  EXPECT_EQ(usage.total(), usage.vertex_table + usage.payloads + usage.adjacency_buckets
+                           + usage.edge_nodes + usage.auxiliary_indexes);
+
+  // Adding an edge grows the adjacency and edge categories
+  auto id5 = graph.addVertex(5);
+  graph.addEdge(*id5, *id5);
+  auto grown = graph.memoryUsage();
+  EXPECT_GT(grown.vertex_table, usage.vertex_table);
+  EXPECT_EQ(grown.edge_nodes, 6 * sizeof(graph_lib::Edge<int>));
+}
+
+TEST(GraphTestMemory, TestMemoryUsageOfCopies)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  for (int i = 0; i < 100; i++) { graph.addVertex(i); }
+  const size_t before = graph.memoryUsage().total();
+
+  auto copy = graph;
+  EXPECT_EQ(copy.getSize(), 100u);
+  EXPECT_GT(copy.memoryUsage().auxiliary_indexes, 0u);
+  for (int i = 100; i < 1100; i++) { copy.addVertex(i); }
+  EXPECT_EQ(copy.getSize(), 1100u);
+  EXPECT_EQ(graph.getSize(), 100u);
+  EXPECT_EQ(graph.memoryUsage().total(), before);
+  EXPECT_GT(copy.memoryUsage().total(), before);
+
+  graph = copy;
+  EXPECT_EQ(graph.getSize(), 1100u);
+  EXPECT_GT(graph.memoryUsage().total(), before);
+}
+
+TEST(GraphTestMemory, TestMemoryUsageStrings)
+{
+  graph_lib::UnweightedUndirectedGraph<std::string> graph;
+  graph.addVertex("a");
+  graph.addVertex(std::string(100, 'b'));
+
+  auto usage = graph.memoryUsage();
+  EXPECT_GE(usage.payloads, 2 * sizeof(std::string) + 101);
+}
+
+TEST(GraphTestFind, TestFindVertex)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto a = graph.addVertex(5);
+  auto b = graph.addVertex(9);
+  EXPECT_EQ(graph.findVertex(5), a);
+  EXPECT_EQ(graph.findVertex(9), b);
+  EXPECT_FALSE(graph.findVertex(7).has_value());
+}
+
+TEST(GraphTestFind, TestFindVertexStrings)
+{
+  graph_lib::UnweightedUndirectedGraph<std::string> graph;
+  auto a = graph.addVertex("alpha");
+  auto b = graph.addVertex(std::string(64, 'b'));
+  EXPECT_EQ(graph.findVertex("alpha"), a);
+  EXPECT_EQ(graph.findVertex(std::string(64, 'b')), b);
+  EXPECT_FALSE(graph.findVertex("beta").has_value());
+
+  // Equal values hash equally, so cached hashes still find the vertex through a copy
+  graph_lib::Vertex<std::string> copy(**graph.getVertex(*a));
+  EXPECT_EQ(copy.getHash(), std::hash<std::string>()("alpha"));
+  EXPECT_TRUE(graph.getVertices().contains(copy));
+}
+
+TEST(GraphTestIncoming, TestIndexMaintainedByAddEdge)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  auto b = *graph.addVertex(2);
+  auto c = *graph.addVertex(3);
+  EXPECT_FALSE(graph.hasIncomingIndex());
+  EXPECT_FALSE(graph.inDegree(a).has_value());
+
+  graph.enableIncomingIndex();
+  EXPECT_TRUE(graph.addEdge(a, c));
+  EXPECT_TRUE(graph.addEdge(b, c));
+  EXPECT_TRUE(graph.addEdge(c, c));
+  EXPECT_FALSE(graph.addEdge(a, c));
+
+  EXPECT_EQ(graph.inDegree(c), 3u);
+  EXPECT_EQ(graph.inDegree(a), 0u);
+  EXPECT_EQ(graph.outDegree(a), 1u);
+  EXPECT_EQ(graph.outDegree(c), 1u);
+  EXPECT_FALSE(graph.inDegree(c + 100).has_value());
+  EXPECT_FALSE(graph.outDegree(c + 100).has_value());
+
+  std::vector<unsigned int> origins;
+  for (const auto& vertex : graph.predecessors(c)) { origins.push_back(vertex.getID()); }
+  EXPECT_EQ(origins, (std::vector<unsigned int>{c, b, a}));
+  EXPECT_TRUE(std::ranges::empty(graph.predecessors(a)));
+  EXPECT_TRUE(std::ranges::empty(graph.predecessors(c + 100)));
+}
+
+TEST(GraphTestIncoming, TestEnableAfterEdges)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  auto b = *graph.addVertex(2);
+  auto c = *graph.addVertex(3);
+  graph.addEdge(a, b, 2.5);
+  graph.addEdge(c, b, 4);
+  graph.addEdge(b, a, 1);
+
+  // Enabling the index picks up the existing edges, and later ones are added by addEdge
+  graph.enableIncomingIndex();
+  graph.enableIncomingIndex();
+  auto d = *graph.addVertex(4);
+  graph.addEdge(d, b, 8);
+  EXPECT_EQ(graph.inDegree(b), 3u);
+  EXPECT_EQ(graph.inDegree(a), 1u);
+  EXPECT_EQ(graph.inDegree(d), 0u);
+
+  float total = 0;
+  graph.forEachPredecessor(**graph.getVertex(b), [&](const auto& origin, float weight)
+  {
+    EXPECT_NE(origin.getID(), b);
+    total += weight;
+  });
+  EXPECT_FLOAT_EQ(total, 14.5);
+
+  const size_t with_index = graph.memoryUsage().auxiliary_indexes;
+  graph.disableIncomingIndex();
+  EXPECT_FALSE(graph.inDegree(b).has_value());
+  EXPECT_TRUE(std::ranges::empty(graph.predecessors(b)));
+  EXPECT_LT(graph.memoryUsage().auxiliary_indexes, with_index);
+  graph.addEdge(a, c, 1);
+  EXPECT_TRUE(std::ranges::empty(graph.predecessors(c)));
+}
+
+TEST(GraphTestIncoming, TestIndexSharedWithCopies)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  auto b = *graph.addVertex(2);
+  graph.addEdge(a, b, 1);
+  graph.enableIncomingIndex();
+
+  // The copy shares the vertices, so it sees edges added through either graph
+  auto copy = graph;
+  auto c = *copy.addVertex(3);
+  copy.addEdge(a, c, 2);
+  EXPECT_TRUE(copy.hasIncomingIndex());
+  EXPECT_EQ(copy.inDegree(c), 1u);
+
+  // Dropping the index through one graph drops it for the copy, including the copy's own vertices
+  graph.disableIncomingIndex();
+  EXPECT_FALSE(copy.hasIncomingIndex());
+  EXPECT_FALSE(copy.inDegree(b).has_value());
+  EXPECT_TRUE(std::ranges::empty(copy.predecessors(c)));
+
+  copy.enableIncomingIndex();
+  EXPECT_TRUE(graph.hasIncomingIndex());
+  EXPECT_EQ(graph.inDegree(b), 1u);
+  EXPECT_EQ(copy.inDegree(c), 1u);
+  EXPECT_EQ(std::ranges::distance(copy.predecessors(b)), 1);
+}
+
+TEST(GraphTestIncoming, TestCopyVerticesOutliveCopy)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  graph.enableIncomingIndex();
+
+  // An edge from a vertex only the copy holds into a vertex shared with the original
+  unsigned int b = 0;
+  {
+    auto copy = graph;
+    b = *copy.addVertex(2);
+    copy.addEdge(b, a);
+  }
+
+  ASSERT_EQ(graph.inDegree(a), 1u);
+  for (const auto& origin : graph.predecessors(a))
+  {
+    EXPECT_EQ(origin.getID(), b);
+    EXPECT_EQ(*origin.data, 2);
+  }
+  size_t visited = 0;
+  graph.forEachPredecessor(**graph.getVertex(a), [&](const auto& origin, float) { visited += origin.getID() == b; });
+  EXPECT_EQ(visited, 1u);
+}
+
+TEST(GraphTestIncoming, TestOutDegreeUndirected)
+{
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  auto b = *graph.addVertex(2);
+  graph.addEdge(a, b);
+  graph.addEdge(a, a);
+  EXPECT_EQ(graph.outDegree(a), 2u);
+  EXPECT_EQ(graph.outDegree(b), 1u);
+}
+
+template <typename G>
+concept AddsUnweightedEdges = requires (G g) { g.addEdge(0u, 0u); };
+
+template <typename G>
+concept AddsWeightedEdges = requires (G g) { g.addEdge(0u, 0u, 1.0f); };
+
+template <typename G>
+concept KeepsIncomingIndex = requires (G g) { g.enableIncomingIndex(); };
+
+TEST(GraphTestPolicies, TestAliasesAndCapabilities)
+{
+  using Graph = graph_lib::BasicGraph<int, graph_lib::Directed, graph_lib::Weighted>;
+  static_assert(std::same_as<Graph, graph_lib::WeightedDirectedGraph<int>>);
+  static_assert(Graph::is_directed && Graph::is_weighted);
+  static_assert(AddsWeightedEdges<Graph> && !AddsUnweightedEdges<Graph> && KeepsIncomingIndex<Graph>);
+  static_assert(AddsUnweightedEdges<graph_lib::UnweightedUndirectedGraph<int>>);
+  static_assert(!KeepsIncomingIndex<graph_lib::UnweightedUndirectedGraph<int>>);
+  static_assert(graph_lib::UnweightedGraph<graph_lib::UnweightedUndirectedGraph<int>>);
+  static_assert(graph_lib::WeightedGraph<Graph> && !graph_lib::UnweightedGraph<Graph>);
+
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  auto a = *graph.addVertex(1);
+  auto b = *graph.addVertex(2);
+  EXPECT_TRUE(graph.addEdge(a, b));
+  EXPECT_FALSE(graph.addEdge(b, a));
+  int visited = 0;
+  for (auto it = graph.dfs_begin(); it != graph.dfs_end(); ++it) { visited++; }
+  EXPECT_EQ(visited, 2);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,109 @@
+#include <set>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/graph_view.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+
+class GraphViewTestBasic : public testing::Test
+{
+public:
+  graph_lib::WeightedDirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+
+  void SetUp()
+  {
+    for (int i = 0; i < 6; i++) { ids.push_back(*graph.addVertex(i)); }
+
+    graph.addEdge(ids[0], ids[1], 0.1);
+    graph.addEdge(ids[0], ids[3], 0.2);
+    graph.addEdge(ids[1], ids[2], 0.4);
+    graph.addEdge(ids[3], ids[2], 0.5);
+    graph.addEdge(ids[3], ids[4], 0.6);
+    graph.addEdge(ids[4], ids[5], 0.7);
+  }
+
+  template <typename Itr>
+  static std::vector<int> values(Itr begin, Itr end)
+  {
+    std::vector<int> result;
+    for (auto itr = begin; itr != end; ++itr) { result.push_back(*(**itr).data); }
+    return result;
+  }
+};
+
+TEST_F(GraphViewTestBasic, TestFilterEdges)
+{
+  auto heavy = graph_lib::filterEdges(graph, [](const auto&, const auto&, float weight) { return weight > 0.3f; });
+  EXPECT_EQ(heavy.getSize(), 6u);
+
+  auto compact = graph_lib::CompactGraph::fromGraph(heavy);
+  EXPECT_EQ(compact.edgeCount(), 4u);
+  EXPECT_EQ(compact.degree(*compact.internalId(ids[0])), 0u);
+}
+
+TEST_F(GraphViewTestBasic, TestFilterVertices)
+{
+  auto even = graph_lib::filterVertices(graph, [](const auto& vertex) { return *vertex.data % 2 == 0; });
+  EXPECT_EQ(even.getSize(), 3u);
+  EXPECT_TRUE(even.getVertex(ids[2]).has_value());
+  EXPECT_FALSE(even.getVertex(ids[3]).has_value());
+
+  auto all = values(even.begin(), even.end());
+  EXPECT_EQ(std::set<int>(all.begin(), all.end()), (std::set<int>{0, 2, 4}));
+
+  // No edge connects two even vertices
+  EXPECT_EQ(graph_lib::CompactGraph::fromGraph(even).edgeCount(), 0u);
+}
+
+TEST_F(GraphViewTestBasic, TestInducedSubgraphTraversal)
+{
+  graph_lib::VertexBitmap bitmap;
+  for (int i : {0, 3, 4, 5}) { bitmap.set(ids[i]); }
+  auto subgraph = graph_lib::inducedSubgraph(graph, bitmap);
+
+  auto dfs = values(subgraph.dfs_begin(), subgraph.dfs_end());
+  auto bfs = values(subgraph.bfs_begin(), subgraph.bfs_end());
+  EXPECT_EQ(dfs.size(), 4u);
+  EXPECT_EQ(bfs.size(), 4u);
+  EXPECT_EQ(std::set<int>(dfs.begin(), dfs.end()), (std::set<int>{0, 3, 4, 5}));
+
+  // Each vertex is reached only through its one visible in-edge
+  auto compact = graph_lib::CompactGraph::fromGraph(subgraph);
+  EXPECT_EQ(compact.edgeCount(), 3u);
+}
+
+TEST_F(GraphViewTestBasic, TestNestedViews)
+{
+  graph_lib::VertexBitmap bitmap;
+  for (int i : {0, 1, 2, 3}) { bitmap.set(ids[i]); }
+  auto subgraph = graph_lib::inducedSubgraph(graph, bitmap);
+  auto heavy = graph_lib::filterEdges(subgraph, [](const auto&, const auto&, float weight) { return weight > 0.3f; });
+
+  EXPECT_EQ(heavy.getSize(), 4u);
+  EXPECT_EQ(graph_lib::CompactGraph::fromGraph(heavy).edgeCount(), 2u);
+  EXPECT_EQ(values(heavy.dfs_begin(), heavy.dfs_end()).size(), 4u);
+}
+
+TEST(GraphViewTest, TestDepthFirstVisitsEachVertexOnce)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  auto id0 = graph.addVertex(0);
+  auto id1 = graph.addVertex(1);
+  auto id2 = graph.addVertex(2);
+  graph.addEdge(*id0, *id2);
+  graph.addEdge(*id0, *id1);
+  graph.addEdge(*id1, *id2);
+
+  auto view = graph_lib::filterVertices(graph, graph_lib::AcceptVertices());
+  size_t count = 0;
+  for (auto itr = view.dfs_begin(); itr != view.dfs_end(); itr++) { count++; }
+  EXPECT_EQ(count, 3u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
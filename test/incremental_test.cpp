@@ -0,0 +1,436 @@
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/incremental.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::IncrementalUpdate;
+using graph_lib::MutationKind;
+
+//! \brief The bytes allocated by the process, counted by the replacement operator new below.
+static std::atomic<size_t> allocated_bytes{0};
+//! \brief The number of allocations left before operator new throws, or -1 to never throw.
+static std::atomic<long> allocations_until_failure{-1};
+
+void* operator new(std::size_t size)
+{
+  if (allocations_until_failure.load() >= 0 && allocations_until_failure.fetch_sub(1) == 0) { throw std::bad_alloc(); }
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* block = std::malloc(size == 0 ? 1 : size)) { return block; }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+//! \brief Add vertices storing 0 .. count - 1 and return their IDs.
+template <typename G>
+static std::vector<unsigned int> addVertices(G& graph, int count)
+{
+  std::vector<unsigned int> ids;
+  const int first = static_cast<int>(graph.getSize());
+  for (int i = 0; i < count; i++) { ids.push_back(*graph.addVertex(first + i)); }
+  return ids;
+}
+
+//! \brief Add random edges between the given vertices.
+template <typename G>
+static void addRandomEdges(G& graph, const std::vector<unsigned int>& ids, int count, std::mt19937& rng)
+{
+  std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+  for (int i = 0; i < count; i++) { graph.addEdge(ids[pick(rng)], ids[pick(rng)]); }
+}
+
+//! \brief Reference PageRank by power iteration. The rank of dangling vertices is spread over every vertex.
+template <typename G>
+static std::unordered_map<unsigned int, double> referencePageRank(const G& graph, double damping)
+{
+  using VertexPtr = typename G::VertexPtr;
+  const double n = static_cast<double>(graph.getSize());
+  std::unordered_map<unsigned int, double> rank, next;
+  graph.forEachVertex([&](const VertexPtr& vertex) { rank[(*vertex).getID()] = 1 / n; });
+  for (int iteration = 0; iteration < 500; iteration++)
+  {
+    double dangling = 0;
+    for (auto& [id, value] : rank) { next[id] = 0; }
+    graph.forEachVertex([&](const VertexPtr& vertex)
+    {
+      const double value = rank[(*vertex).getID()];
+      const auto degree = (*vertex).adj.size();
+      if (degree == 0) { dangling += value; return; }
+      graph.forEachNeighbor(*vertex, [&](const VertexPtr& dest, float) { next[(*dest).getID()] += value / degree; });
+    });
+    for (auto& [id, value] : next) { value = (1 - damping + damping * dangling) / n + damping * value; }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+//! \brief Reference hop counts by a fresh breadth first search.
+template <typename G>
+static std::unordered_map<unsigned int, unsigned> referenceLevels(const G& graph, unsigned int source)
+{
+  using VertexPtr = typename G::VertexPtr;
+  std::unordered_map<unsigned int, unsigned> levels{{source, 0}};
+  std::vector<unsigned int> frontier{source};
+  for (size_t i = 0; i < frontier.size(); i++)
+  {
+    const unsigned next = levels[frontier[i]] + 1;
+    graph.forEachNeighbor(**graph.getVertex(frontier[i]), [&](const VertexPtr& dest, float)
+    {
+      if (levels.try_emplace((*dest).getID(), next).second) { frontier.push_back((*dest).getID()); }
+    });
+  }
+  return levels;
+}
+
+TEST(IncrementalTest, TestJournalRecordsInserts)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto before = *graph.addVertex(1);
+  EXPECT_FALSE(graph.journal().recording());
+  EXPECT_EQ(graph.journal().size(), 0u);
+
+  graph.enableJournal();
+  const auto start = graph.journal().head();
+  EXPECT_TRUE(graph.journal().covers(start));
+  auto a = *graph.addVertex(2);
+  EXPECT_TRUE(graph.addEdge(before, a, 2.5));
+  EXPECT_FALSE(graph.addEdge(before, a, 3));
+  EXPECT_FALSE(graph.addVertex(2).has_value());
+
+  auto entries = graph.journal().since(start);
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[0].kind, MutationKind::AddVertex);
+  EXPECT_EQ(entries[0].origin, a);
+  EXPECT_EQ(entries[0].sequence, start);
+  EXPECT_EQ(entries[1].kind, MutationKind::AddEdge);
+  EXPECT_EQ(entries[1].origin, before);
+  EXPECT_EQ(entries[1].dest, a);
+  EXPECT_FLOAT_EQ(entries[1].weight, 2.5);
+  EXPECT_EQ(entries[1].sequence, start + 1);
+
+  // Discarded positions are no longer covered, later ones still are
+  graph.discardJournalBefore(start + 1);
+  EXPECT_FALSE(graph.journal().covers(start));
+  ASSERT_EQ(graph.journal().since(start + 1).size(), 1u);
+  EXPECT_EQ(graph.journal().since(start + 1)[0].kind, MutationKind::AddEdge);
+
+  // Inserts made while not recording leave a gap that no earlier position covers
+  const auto end = graph.journal().head();
+  graph.disableJournal();
+  graph.addVertex(3);
+  graph.enableJournal();
+  EXPECT_FALSE(graph.journal().covers(end));
+  EXPECT_EQ(graph.journal().size(), 0u);
+}
+
+TEST(IncrementalTest, TestCopiesLeaveJournalBehind)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  auto ids = addVertices(graph, 150);
+  graph.enableJournal();
+  graph.addEdge(ids[0], ids[1]);
+
+  // The bytes allocated to create an iterator, which holds a copy of the graph
+  auto iteratorBytes = [&]
+  {
+    const size_t before = allocated_bytes.load();
+    auto itr = graph.begin();
+    return allocated_bytes.load() - before;
+  };
+  const size_t small = iteratorBytes();
+
+  // Grow the journal without adding vertices, so only the journal could make copies dearer
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    for (size_t j = i + 1; j < ids.size(); j++) { graph.addEdge(ids[i], ids[j]); }
+  }
+  ASSERT_GT(graph.journal().size(), 10000u);
+  EXPECT_EQ(iteratorBytes(), small);
+
+  auto copy = graph;
+  EXPECT_FALSE(copy.journal().recording());
+  EXPECT_EQ(copy.journal().size(), 0u);
+  EXPECT_GT(graph.journal().size(), 10000u);
+
+  // Assigning releases the journal of the assigned graph
+  copy.enableJournal();
+  copy.addVertex(1000);
+  copy = graph;
+  EXPECT_FALSE(copy.journal().recording());
+  EXPECT_EQ(copy.journal().size(), 0u);
+}
+
+//! \brief Run an insert with each of its allocations failing in turn, until it succeeds.
+//! After every failed attempt, unchanged() must hold.
+template <typename Insert, typename Unchanged>
+static void failEachAllocation(Insert insert, Unchanged unchanged)
+{
+  for (long failing = 0; failing < 100; failing++)
+  {
+    allocations_until_failure = failing;
+    const bool inserted = insert();
+    allocations_until_failure = -1;
+    if (inserted) { return; }
+    unchanged();
+  }
+  ADD_FAILURE() << "The insert never succeeded";
+}
+
+TEST(IncrementalTest, TestFailedInsertsLeaveNoTrace)
+{
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  auto ids = addVertices(graph, 2);
+  graph.enableJournal();
+
+  failEachAllocation([&] { return graph.addVertex(100).has_value(); }, [&]
+  {
+    EXPECT_EQ(graph.getSize(), 2u);
+    EXPECT_FALSE(graph.findVertex(100).has_value());
+    EXPECT_EQ(graph.journal().size(), 0u);
+  });
+  ASSERT_EQ(graph.journal().size(), 1u);
+
+  // Either half of an undirected edge may fail
+  failEachAllocation([&] { return graph.addEdge(ids[0], ids[1]); }, [&]
+  {
+    EXPECT_EQ(graph.outDegree(ids[0]), 0u);
+    EXPECT_EQ(graph.outDegree(ids[1]), 0u);
+    EXPECT_EQ(graph.journal().size(), 1u);
+  });
+  EXPECT_EQ(graph.outDegree(ids[0]), 1u);
+  EXPECT_EQ(graph.outDegree(ids[1]), 1u);
+  EXPECT_EQ(graph.journal().size(), 2u);
+}
+
+TEST(IncrementalTest, TestFailedEdgeLeavesIncomingIndex)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto ids = addVertices(graph, 3);
+  graph.enableIncomingIndex();
+  graph.enableJournal();
+
+  // The first edge into a vertex also adds it to the index's list of heads
+  for (auto origin : {ids[0], ids[1]})
+  {
+    const size_t degree = *graph.inDegree(ids[2]);
+    failEachAllocation([&] { return graph.addEdge(origin, ids[2], 1.5f); }, [&]
+    {
+      EXPECT_EQ(graph.outDegree(origin), 0u);
+      EXPECT_EQ(graph.inDegree(ids[2]), degree);
+      EXPECT_EQ(std::ranges::distance(graph.predecessors(ids[2])), static_cast<std::ptrdiff_t>(degree));
+    });
+    EXPECT_EQ(graph.inDegree(ids[2]), degree + 1);
+    EXPECT_EQ(graph.predecessors(ids[2]).begin()->getID(), origin);
+  }
+
+  graph.disableIncomingIndex();
+  EXPECT_TRUE(std::ranges::empty(graph.predecessors(ids[2])));
+  EXPECT_EQ(graph.journal().size(), 2u);
+}
+
+TEST(IncrementalTest, TestBfsMatchesRecompute)
+{
+  std::mt19937 rng(7);
+  graph_lib::UnweightedDirectedGraph<int> directed;
+  graph_lib::UnweightedUndirectedGraph<int> undirected;
+  directed.enableJournal();
+  undirected.enableJournal();
+  auto directed_ids = addVertices(directed, 300);
+  auto undirected_ids = addVertices(undirected, 300);
+  addRandomEdges(directed, directed_ids, 250, rng);
+  addRandomEdges(undirected, undirected_ids, 120, rng);
+
+  graph_lib::IncrementalBfs directed_bfs(directed, directed_ids[0]);
+  graph_lib::IncrementalBfs undirected_bfs(undirected, undirected_ids[0]);
+  for (int batch = 0; batch < 6; batch++)
+  {
+    const auto start = directed.journal().head();
+    auto more = addVertices(directed, 5);
+    directed_ids.insert(directed_ids.end(), more.begin(), more.end());
+    addRandomEdges(directed, directed_ids, 40, rng);
+    addRandomEdges(undirected, undirected_ids, 20, rng);
+
+    auto directed_update = directed_bfs.update();
+    auto undirected_update = undirected_bfs.update();
+    EXPECT_FALSE(directed_update.recomputed);
+    EXPECT_FALSE(undirected_update.recomputed);
+    EXPECT_EQ(directed_update.mutations, directed.journal().head() - start);
+    EXPECT_EQ(directed_bfs.levels(), referenceLevels(directed, directed_ids[0]));
+    EXPECT_EQ(undirected_bfs.levels(), referenceLevels(undirected, undirected_ids[0]));
+    directed.discardJournalBefore(directed.journal().head());
+  }
+}
+
+TEST(IncrementalTest, TestBfsSourceAddedLater)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  graph.enableJournal();
+  auto a = *graph.addVertex(1);
+  graph_lib::IncrementalBfs bfs(graph, a + 1);
+  EXPECT_TRUE(bfs.levels().empty());
+
+  auto b = *graph.addVertex(2);
+  ASSERT_EQ(b, a + 1);
+  graph.addEdge(b, a);
+  auto update = bfs.update();
+  EXPECT_EQ(update.mutations, 2u);
+  EXPECT_EQ(bfs.level(b), 0u);
+  EXPECT_EQ(bfs.level(a), 1u);
+}
+
+TEST(IncrementalTest, TestRecomputeWhenJournalNotCovered)
+{
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  auto ids = addVertices(graph, 4);
+  graph.addEdge(ids[0], ids[1]);
+
+  // Not recording: the update has to start over
+  graph_lib::IncrementalBfs bfs(graph, ids[0]);
+  graph_lib::IncrementalComponents components(graph);
+  graph_lib::IncrementalPageRank rank(graph);
+  graph.addEdge(ids[1], ids[2]);
+  EXPECT_TRUE(bfs.update().recomputed);
+  EXPECT_TRUE(components.update().recomputed);
+  EXPECT_TRUE(rank.update().recomputed);
+  EXPECT_EQ(bfs.level(ids[2]), 2u);
+  EXPECT_TRUE(components.connected(ids[0], ids[2]));
+
+  // Recording, but the entries were discarded before being read
+  graph.enableJournal();
+  bfs.recompute();
+  graph.addEdge(ids[2], ids[3]);
+  graph.discardJournalBefore(graph.journal().head());
+  EXPECT_TRUE(bfs.update().recomputed);
+  EXPECT_EQ(bfs.level(ids[3]), 3u);
+
+  graph.addEdge(ids[0], ids[3]);
+  auto update = bfs.update();
+  EXPECT_FALSE(update.recomputed);
+  EXPECT_EQ(update.mutations, 1u);
+  EXPECT_EQ(bfs.level(ids[3]), 1u);
+}
+
+TEST(IncrementalTest, TestComponents)
+{
+  std::mt19937 rng(11);
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  graph.enableJournal();
+  auto ids = addVertices(graph, 400);
+  addRandomEdges(graph, ids, 150, rng);
+  graph_lib::IncrementalComponents components(graph);
+
+  for (int batch = 0; batch < 5; batch++)
+  {
+    auto more = addVertices(graph, 10);
+    ids.insert(ids.end(), more.begin(), more.end());
+    addRandomEdges(graph, ids, 60, rng);
+    const size_t before = components.componentCount();
+    auto update = components.update();
+    EXPECT_FALSE(update.recomputed);
+    // Every new vertex adds a component and every merge removes one
+    const size_t merges = update.vertices_updated - 10;
+    EXPECT_EQ(components.componentCount(), before + 10 - merges);
+
+    graph_lib::IncrementalComponents fresh(graph);
+    EXPECT_EQ(components.componentCount(), fresh.componentCount());
+    for (auto a : ids)
+    {
+      EXPECT_EQ(components.connected(a, ids[0]), fresh.connected(a, ids[0]));
+      EXPECT_EQ(components.connected(a, ids[batch]), fresh.connected(a, ids[batch]));
+    }
+  }
+  EXPECT_FALSE(components.component(ids.back() + 100).has_value());
+}
+
+TEST(IncrementalTest, TestPageRankMatchesPowerIteration)
+{
+  std::mt19937 rng(3);
+  graph_lib::WeightedDirectedGraph<int> graph;
+  graph.enableJournal();
+  auto ids = addVertices(graph, 200);
+  std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+  for (int i = 0; i < 600; i++) { graph.addEdge(ids[pick(rng)], ids[pick(rng)], 1); }
+
+  graph_lib::IncrementalPageRank rank(graph, {.damping = 0.85, .tolerance = 1e-9});
+  for (int batch = 0; batch < 4; batch++)
+  {
+    // New vertices start dangling, some of them gain edges and old dangling vertices gain edges too
+    auto more = addVertices(graph, 8);
+    ids.insert(ids.end(), more.begin(), more.end());
+    std::uniform_int_distribution<size_t> any(0, ids.size() - 1);
+    for (int i = 0; i < 30; i++) { graph.addEdge(ids[any(rng)], ids[any(rng)], 1); }
+
+    auto update = rank.update();
+    EXPECT_FALSE(update.recomputed);
+    auto expected = referencePageRank(graph, 0.85);
+    double total = 0;
+    for (auto id : ids)
+    {
+      ASSERT_TRUE(rank.rank(id).has_value());
+      EXPECT_NEAR(*rank.rank(id), expected[id], 1e-7) << "vertex " << id;
+      total += *rank.rank(id);
+    }
+    EXPECT_NEAR(total, 1, 1e-6);
+  }
+}
+
+TEST(IncrementalTest, TestPageRankUpdateIsLocal)
+{
+  // Separate undirected cycles: no vertex is dangling, so an edge only affects its own cycle
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  graph.enableJournal();
+  std::vector<std::vector<unsigned int>> cycles;
+  for (int c = 0; c < 50; c++)
+  {
+    cycles.push_back(addVertices(graph, 20));
+    for (size_t i = 0; i < 20; i++) { graph.addEdge(cycles[c][i], cycles[c][(i + 1) % 20]); }
+  }
+  graph_lib::IncrementalPageRank rank(graph, {.tolerance = 1e-10});
+  auto before = rank.ranks();
+
+  graph.addEdge(cycles[3][0], cycles[3][10]);
+  auto update = rank.update();
+  EXPECT_EQ(update.mutations, 1u);
+  EXPECT_LE(update.vertices_updated, 20u);
+
+  auto after = rank.ranks();
+  auto expected = referencePageRank(graph, 0.85);
+  for (size_t c = 0; c < cycles.size(); c++)
+  {
+    for (auto id : cycles[c])
+    {
+      if (c != 3) { EXPECT_EQ(after[id], before[id]); }
+      EXPECT_NEAR(after[id], expected[id], 1e-8);
+    }
+  }
+  EXPECT_GT(after[cycles[3][0]], before[cycles[3][0]]);
+}
+
+TEST(IncrementalTest, TestPageRankInvalidOptions)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  EXPECT_THROW(graph_lib::IncrementalPageRank(graph, {.damping = 1}), std::invalid_argument);
+  EXPECT_THROW(graph_lib::IncrementalPageRank(graph, {.tolerance = 0}), std::invalid_argument);
+  graph_lib::IncrementalPageRank empty(graph);
+  EXPECT_TRUE(empty.ranks().empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/instrumentation.hpp>
+
+namespace instrumentation = graph_lib::instrumentation;
+
+
+class InstrumentationTest : public testing::Test
+{
+public:
+  graph_lib::UnweightedDirectedGraph<int> graph;
+
+  void SetUp()
+  {
+    auto id0 = graph.addVertex(0);
+    auto id1 = graph.addVertex(1);
+    auto id2 = graph.addVertex(2);
+
+    graph.addEdge(*id0, *id1);
+    graph.addEdge(*id1, *id2);
+    graph.addEdge(*id2, *id0);
+
+    instrumentation::reset();
+  }
+};
+
+TEST_F(InstrumentationTest, TestEnabled)
+{
+  EXPECT_TRUE(instrumentation::enabled);
+}
+
+TEST_F(InstrumentationTest, TestTraversalCounters)
+{
+  size_t count = 0;
+  for (auto itr = graph.dfs_begin(); itr != graph.dfs_end(); ++itr) { count++; }
+
+  auto snapshot = instrumentation::snapshot();
+  EXPECT_EQ(snapshot.get(instrumentation::Counter::VerticesVisited), count);
+  EXPECT_EQ(snapshot.get(instrumentation::Counter::EdgesScanned), 3u);
+  EXPECT_GT(snapshot.get(instrumentation::Counter::HashLookups), 0u);
+  EXPECT_GE(snapshot.get(instrumentation::Counter::Allocations), 2u);
+  EXPECT_EQ(snapshot.timings.count("dfs"), 1u);
+  EXPECT_EQ(snapshot.timings["dfs"].calls, 1u);
+}
+
+TEST_F(InstrumentationTest, TestMutationCounters)
+{
+  auto id = graph.addVertex(3);
+  graph.addEdge(*id, *id);
+
+  auto snapshot = instrumentation::snapshot();
+  // Payload and edge, plus from the tracking allocators the vertex, its node in the vertex
+  // set and the ID index, and the node and bucket array of its adjacency set
+  EXPECT_EQ(snapshot.get(instrumentation::Counter::Allocations), 7u);
+  EXPECT_GT(snapshot.get(instrumentation::Counter::BytesAllocated), 0u);
+}
+
+TEST_F(InstrumentationTest, TestReset)
+{
+  graph.getVertex(0);
+  EXPECT_EQ(instrumentation::snapshot().get(instrumentation::Counter::HashLookups), 1u);
+
+  instrumentation::reset();
+  EXPECT_EQ(instrumentation::snapshot().get(instrumentation::Counter::HashLookups), 0u);
+}
+
+TEST_F(InstrumentationTest, TestJson)
+{
+  {
+    GRAPH_LIB_SCOPED_TIMER("test");
+  }
+  std::ostringstream os;
+  instrumentation::writeJson(os);
+
+  EXPECT_NE(os.str().find("\"enabled\": true"), std::string::npos);
+  EXPECT_NE(os.str().find("\"vertices_visited\": 0"), std::string::npos);
+  EXPECT_NE(os.str().find("\"test\": {\"calls\": 1"), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
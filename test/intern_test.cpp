@@ -0,0 +1,116 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/intern.hpp>
+
+using graph_lib::InternedString;
+using graph_lib::StringInterner;
+
+
+TEST(InternTest, TestSameStringSameHandle)
+{
+  StringInterner interner;
+  std::string text = "vertex";
+  auto a = interner.intern(text);
+  auto b = interner.intern(std::string("vert") + "ex");
+  auto c = interner.intern("other");
+
+  EXPECT_EQ(a, b);
+  EXPECT_FALSE(a == c);
+  EXPECT_EQ(a.view(), "vertex");
+  EXPECT_EQ(a.hash(), std::hash<InternedString>()(b));
+  EXPECT_EQ(interner.size(), 2u);
+
+  // The interner keeps its own copy
+  text[0] = 'V';
+  EXPECT_EQ(a.view(), "vertex");
+}
+
+TEST(InternTest, TestFind)
+{
+  StringInterner interner;
+  EXPECT_FALSE(interner.find("missing").has_value());
+  auto a = interner.intern("present");
+  EXPECT_EQ(interner.find("present"), a);
+  EXPECT_FALSE(interner.find("missing").has_value());
+  EXPECT_EQ(interner.size(), 1u);
+}
+
+TEST(InternTest, TestEmptyString)
+{
+  StringInterner interner;
+  EXPECT_EQ(interner.intern(""), InternedString());
+  EXPECT_TRUE(interner.intern("").empty());
+  EXPECT_EQ(interner.find(""), InternedString());
+  EXPECT_EQ(interner.size(), 0u);
+}
+
+TEST(InternTest, TestManyStrings)
+{
+  StringInterner interner;
+  std::vector<InternedString> handles;
+  for (int i = 0; i < 20000; i++) { handles.push_back(interner.intern("key-" + std::to_string(i))); }
+  handles.push_back(interner.intern(std::string(100000, 'x')));
+
+  EXPECT_EQ(interner.size(), 20001u);
+  for (int i = 0; i < 20000; i++)
+  {
+    EXPECT_EQ(handles[i].view(), "key-" + std::to_string(i));
+    EXPECT_EQ(interner.intern("key-" + std::to_string(i)), handles[i]);
+  }
+  EXPECT_EQ(handles.back().size(), 100000u);
+  // Short strings share blocks, so the arena is far smaller than one allocation per string
+  EXPECT_LT(interner.arenaBytes(), 20000 * 32 + 100000);
+}
+
+TEST(InternTest, TestMovedFromInternerIsReusable)
+{
+  StringInterner interner;
+  auto hello = interner.intern("hello");
+  StringInterner moved(std::move(interner));
+  EXPECT_EQ(interner.size(), 0u);
+  EXPECT_EQ(interner.arenaBytes(), 0u);
+
+  // Reusing the moved-from interner must not write into the new owner's arena
+  auto world = interner.intern("WORLD");
+  EXPECT_EQ(hello.view(), "hello");
+  EXPECT_EQ(world.view(), "WORLD");
+  EXPECT_EQ(moved.find("hello"), hello);
+  EXPECT_FALSE(moved.find("WORLD").has_value());
+
+  StringInterner assigned;
+  assigned.intern("old");
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.size(), 1u);
+  EXPECT_EQ(moved.arenaBytes(), 0u);
+  auto again = moved.intern("AGAIN");
+  EXPECT_EQ(hello.view(), "hello");
+  EXPECT_EQ(again.view(), "AGAIN");
+}
+
+TEST(InternTest, TestGraphWithInternedKeys)
+{
+  StringInterner interner;
+  graph_lib::UnweightedDirectedGraph<InternedString> graph;
+  auto a = graph.addVertex(interner.intern("a"));
+  auto b = graph.addVertex(interner.intern("b"));
+  auto c = graph.addVertex(interner.intern("c"));
+  EXPECT_FALSE(graph.addVertex(interner.intern("a")).has_value());
+  EXPECT_TRUE(graph.addEdge(*a, *b));
+  EXPECT_TRUE(graph.addEdge(*b, *c));
+
+  EXPECT_EQ(graph.findVertex(*interner.find("b")), b);
+  EXPECT_FALSE(graph.findVertex(interner.intern("d")).has_value());
+
+  std::string order;
+  for (auto itr = graph.bfs_begin(); itr != graph.bfs_end(); ++itr) { order += (**itr).data->view(); }
+  EXPECT_EQ(order.size(), 3u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
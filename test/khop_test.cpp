@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/khop.hpp>
+#include <graph_lib/undirected_graph.hpp>
+#include <graph_lib/visitor.hpp>
+
+
+class KHopTestBasic : public testing::Test
+{
+public:
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+
+  //! \brief 0 -> 1 -> 2 -> 3, 0 -> 4 -> 3, and an isolated 5.
+  void SetUp()
+  {
+    for (int i = 0; i < 6; i++) { ids.push_back(*graph.addVertex(i)); }
+
+    graph.addEdge(ids[0], ids[1]);
+    graph.addEdge(ids[1], ids[2]);
+    graph.addEdge(ids[2], ids[3]);
+    graph.addEdge(ids[0], ids[4]);
+    graph.addEdge(ids[4], ids[3]);
+  }
+
+  std::set<unsigned int> idSet(std::initializer_list<int> values) const
+  {
+    std::set<unsigned int> result;
+    for (int value : values) { result.insert(ids[value]); }
+    return result;
+  }
+};
+
+TEST_F(KHopTestBasic, TestNeighborhoods)
+{
+  const std::vector<graph_lib::KHopQuery> queries{{ids[0], 0}, {ids[0], 1}, {ids[0], 2}, {ids[0], 9}, {ids[1], 1}, {ids[5], 3}};
+  auto results = graph_lib::kHopNeighborhoods(graph, queries, {.threads = 2, .hop_counts = true});
+
+  ASSERT_EQ(results.size(), queries.size());
+  auto set = [&](size_t i) { return std::set<unsigned int>(results.vertices(i).begin(), results.vertices(i).end()); };
+  EXPECT_EQ(set(0), idSet({0}));
+  EXPECT_EQ(set(1), idSet({0, 1, 4}));
+  EXPECT_EQ(set(2), idSet({0, 1, 2, 3, 4}));
+  EXPECT_EQ(set(3), idSet({0, 1, 2, 3, 4}));
+  EXPECT_EQ(set(4), idSet({1, 2}));
+  EXPECT_EQ(set(5), idSet({5}));
+
+  // Hop counts follow the vertices, seed first
+  auto vertices = results.vertices(2);
+  auto hops = results.hops(2);
+  ASSERT_EQ(hops.size(), vertices.size());
+  EXPECT_EQ(vertices[0], ids[0]);
+  for (size_t i = 0; i < vertices.size(); i++)
+  {
+    const unsigned expected = vertices[i] == ids[0] ? 0 : (vertices[i] == ids[1] || vertices[i] == ids[4]) ? 1 : 2;
+    EXPECT_EQ(hops[i], expected);
+  }
+}
+
+TEST_F(KHopTestBasic, TestMissingSeedAndNoHops)
+{
+  const std::vector<graph_lib::KHopQuery> queries{{ids.back() + 1000, 2}, {ids[2], 1}};
+  auto results = graph_lib::kHopNeighborhoods(graph, queries);
+  EXPECT_TRUE(results.vertices(0).empty());
+  EXPECT_EQ(results.vertices(1).size(), 2u);
+  EXPECT_TRUE(results.hops(1).empty());
+  EXPECT_EQ(results.totalVertices(), 2u);
+}
+
+TEST(KHopTest, TestMatchesVisitorOnRandomGraph)
+{
+  using Graph = graph_lib::UnweightedUndirectedGraph<unsigned int>;
+  auto graph = graph_lib::buildGraph<Graph>(graph_lib::erdosRenyiEdges(300, 900, {.seed = 7}));
+  const auto compact = graph_lib::CompactGraph::fromGraph(graph);
+
+  std::vector<graph_lib::KHopQuery> queries;
+  for (size_t i = 0; i < 200; i++) { queries.push_back({compact.externalId(i % 50), static_cast<unsigned>(i % 4)}); }
+  auto results = graph_lib::kHopNeighborhoods(compact, queries, {.threads = 4, .hop_counts = true});
+
+  for (size_t q = 0; q < queries.size(); q++)
+  {
+    std::set<unsigned int> expected;
+    struct
+    {
+      std::set<unsigned int>* found;
+      void discoverVertex(const Graph::VertexPtr& vertex, unsigned) { found->insert((*vertex).getID()); }
+    } visitor{&expected};
+    graph_lib::breadthFirstVisit(graph, queries[q].seed, visitor, queries[q].k);
+
+    auto vertices = results.vertices(q);
+    EXPECT_EQ(std::set<unsigned int>(vertices.begin(), vertices.end()), expected);
+    EXPECT_EQ(vertices.size(), expected.size());
+    EXPECT_TRUE(std::is_sorted(results.hops(q).begin(), results.hops(q).end()));
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
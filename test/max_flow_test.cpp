@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/max_flow.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::CompactGraph;
+using graph_lib::FlowMethod;
+using graph_lib::FlowNetwork;
+
+
+//! \brief Edmonds-Karp on an adjacency matrix, as a reference.
+static double referenceFlow(const CompactGraph& graph, size_t source, size_t sink)
+{
+  const size_t n = graph.vertexCount();
+  std::vector<std::vector<double>> residual(n, std::vector<double>(n, 0));
+  for (size_t v = 0; v < n; v++)
+  {
+    for (size_t i = 0; i < graph.degree(v); i++) { residual[v][graph.neighbors(v)[i]] += graph.weight(v, i); }
+  }
+  double total = 0;
+  while (true)
+  {
+    std::vector<size_t> parent(n, n);
+    std::vector<size_t> queue{source};
+    parent[source] = source;
+    for (size_t head = 0; head < queue.size() && parent[sink] == n; head++)
+    {
+      for (size_t u = 0; u < n; u++)
+      {
+        if (parent[u] == n && residual[queue[head]][u] > 0) { parent[u] = queue[head]; queue.push_back(u); }
+      }
+    }
+    if (parent[sink] == n) { return total; }
+    double bottleneck = std::numeric_limits<double>::infinity();
+    for (size_t v = sink; v != source; v = parent[v]) { bottleneck = std::min(bottleneck, residual[parent[v]][v]); }
+    for (size_t v = sink; v != source; v = parent[v]) { residual[parent[v]][v] -= bottleneck; residual[v][parent[v]] += bottleneck; }
+    total += bottleneck;
+  }
+}
+
+static void expectValidCut(const graph_lib::FlowResult& result, unsigned int source_id, unsigned int sink_id)
+{
+  EXPECT_NE(std::find(result.source_side.begin(), result.source_side.end(), source_id), result.source_side.end());
+  EXPECT_EQ(std::find(result.source_side.begin(), result.source_side.end(), sink_id), result.source_side.end());
+  double capacity = 0;
+  for (const auto& edge : result.cut_edges) { capacity += edge.capacity; }
+  EXPECT_NEAR(capacity, result.value, 1e-3);
+}
+
+TEST(MaxFlowTest, TestTextbookNetwork)
+{
+  // The network from Cormen et al., with a maximum flow of 23
+  const std::vector<std::tuple<size_t, size_t, float>> edges{
+    {0, 1, 16}, {0, 2, 13}, {1, 3, 12}, {2, 1, 4}, {2, 4, 14}, {3, 2, 9}, {3, 5, 20}, {4, 3, 7}, {4, 5, 4}};
+  FlowNetwork network(CompactGraph::fromEdges({100, 101, 102, 103, 104, 105}, edges, true, true));
+  EXPECT_EQ(network.arcCount(), 2 * edges.size());
+  for (auto method : {FlowMethod::PushRelabel, FlowMethod::Dinic})
+  {
+    auto result = network.maxFlow(100, 105, method);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_DOUBLE_EQ(result->value, 23);
+    expectValidCut(*result, 100, 105);
+  }
+}
+
+TEST(MaxFlowTest, TestMatchesEdmondsKarp)
+{
+  for (uint64_t seed : {1, 2, 3, 4})
+  {
+    auto list = graph_lib::erdosRenyiEdges(80, 400, {.seed = seed, .weights = graph_lib::WeightDistribution::uniform(1, 20)});
+    FlowNetwork network(CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<int>>(list)));
+    const auto& graph = network.graph();
+    for (CompactGraph::Index sink : {1, 17, 79})
+    {
+      const double expected = referenceFlow(graph, 0, sink);
+      for (auto method : {FlowMethod::PushRelabel, FlowMethod::Dinic})
+      {
+        auto result = network.maxFlow(graph.externalId(0), graph.externalId(sink), method);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_NEAR(result->value, expected, 1e-3);
+        expectValidCut(*result, graph.externalId(0), graph.externalId(sink));
+      }
+    }
+  }
+}
+
+TEST(MaxFlowTest, TestMethodsAgreeOnLargerGraph)
+{
+  // Large enough for global relabels and gaps to happen during push-relabel
+  auto list = graph_lib::rmatEdges(11, 20000, {}, {.seed = 9, .weights = graph_lib::WeightDistribution::uniform(1, 50)});
+  FlowNetwork network(CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<int>>(list)));
+  const auto& graph = network.graph();
+  for (CompactGraph::Index sink : {3, 500, 1500})
+  {
+    auto push_relabel = network.maxFlow(graph.externalId(0), graph.externalId(sink), FlowMethod::PushRelabel);
+    auto dinic = network.maxFlow(graph.externalId(0), graph.externalId(sink), FlowMethod::Dinic);
+    ASSERT_TRUE(push_relabel.has_value() && dinic.has_value());
+    EXPECT_NEAR(push_relabel->value, dinic->value, 1e-2);
+    expectValidCut(*push_relabel, graph.externalId(0), graph.externalId(sink));
+  }
+}
+
+TEST(MaxFlowTest, TestUndirectedGraph)
+{
+  // Two disjoint paths of bottleneck 2 and 3 between the ends of a ring
+  graph_lib::WeightedUndirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+  for (int i = 0; i < 4; i++) { ids.push_back(*graph.addVertex(i)); }
+  graph.addEdge(ids[0], ids[1], 2.0f);
+  graph.addEdge(ids[1], ids[2], 5.0f);
+  graph.addEdge(ids[2], ids[3], 3.0f);
+  graph.addEdge(ids[3], ids[0], 4.0f);
+
+  for (auto method : {FlowMethod::PushRelabel, FlowMethod::Dinic})
+  {
+    auto result = graph_lib::maxFlow(graph, ids[0], ids[2], method);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_DOUBLE_EQ(result->value, 5);
+    expectValidCut(*result, ids[0], ids[2]);
+  }
+}
+
+TEST(MaxFlowTest, TestUnreachableSink)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(0);
+  auto b = *graph.addVertex(1);
+  auto c = *graph.addVertex(2);
+  graph.addEdge(b, a, 7.0f);
+  graph.addEdge(a, c, 1.0f);
+
+  auto result = graph_lib::maxFlow(graph, a, b);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_DOUBLE_EQ(result->value, 0);
+  EXPECT_TRUE(result->cut_edges.empty());
+  EXPECT_EQ(result->source_side.size(), 2u);
+}
+
+TEST(MaxFlowTest, TestInvalidQueries)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(0);
+  auto b = *graph.addVertex(1);
+  graph.addEdge(a, b, 1.0f);
+  FlowNetwork network(CompactGraph::fromGraph(graph));
+  EXPECT_FALSE(network.maxFlow(a, a).has_value());
+  EXPECT_FALSE(network.maxFlow(a, b + 100).has_value());
+
+  graph.addEdge(b, a, -1.0f);
+  EXPECT_THROW(FlowNetwork(CompactGraph::fromGraph(graph)), std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/partitioning.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::CompactGraph;
+using graph_lib::GraphPartition;
+using graph_lib::PartitionMethod;
+
+static const PartitionMethod kMethods[] = {PartitionMethod::LinearDeterministicGreedy, PartitionMethod::Fennel};
+
+
+static CompactGraph gridGraph(unsigned side)
+{
+  return CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedUndirectedGraph<int>>(graph_lib::gridEdges(side, side)));
+}
+
+//! \brief Check the sizes and the edge cut against the assignment.
+static void expectConsistent(const CompactGraph& graph, const GraphPartition& partition, double imbalance)
+{
+  ASSERT_EQ(partition.assignment.size(), graph.vertexCount());
+  std::vector<size_t> sizes(partition.parts, 0);
+  for (auto part : partition.assignment)
+  {
+    ASSERT_LT(part, partition.parts);
+    sizes[part]++;
+  }
+  EXPECT_EQ(sizes, partition.sizes);
+  EXPECT_LE(partition.imbalance(), imbalance + static_cast<double>(partition.parts) / graph.vertexCount());
+
+  size_t cut = 0;
+  for (CompactGraph::Index v = 0; v < graph.vertexCount(); v++)
+  {
+    for (auto u : graph.neighbors(v)) { cut += partition.assignment[u] != partition.assignment[v]; }
+  }
+  EXPECT_EQ(partition.edge_cut, graph.isDirected() ? cut : cut / 2);
+}
+
+TEST(PartitioningTest, TestBalancedLowCutOnGrid)
+{
+  auto graph = gridGraph(40);
+  const size_t edges = graph.edgeCount() / 2;
+  for (auto method : kMethods)
+  {
+    auto partition = graph_lib::partitionGraph(graph, {.parts = 4, .method = method});
+    expectConsistent(graph, partition, 1.1);
+    // A random assignment would cut three quarters of the edges
+    EXPECT_LT(partition.edge_cut, edges / 5) << static_cast<int>(method);
+  }
+}
+
+TEST(PartitioningTest, TestRefinementNeverIncreasesCut)
+{
+  auto list = graph_lib::erdosRenyiEdges(2000, 8000, {.seed = 2});
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedUndirectedGraph<int>>(list));
+  for (auto method : kMethods)
+  {
+    auto streamed = graph_lib::partitionGraph(graph, {.parts = 8, .method = method, .refinement_rounds = 0});
+    auto refined = graph_lib::partitionGraph(graph, {.parts = 8, .method = method, .imbalance = 1.1});
+    expectConsistent(graph, streamed, 1.1);
+    expectConsistent(graph, refined, 1.1);
+    EXPECT_LE(refined.edge_cut, streamed.edge_cut);
+  }
+}
+
+TEST(PartitioningTest, TestDirectedGraph)
+{
+  auto list = graph_lib::rmatEdges(10, 6000, {}, {.seed = 5});
+  auto graph = graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list);
+  auto partition = graph_lib::partitionGraph(graph, {.parts = 3, .imbalance = 1.05});
+  expectConsistent(CompactGraph::fromGraph(graph), partition, 1.05);
+}
+
+TEST(PartitioningTest, TestSinglePart)
+{
+  auto graph = gridGraph(10);
+  auto partition = graph_lib::partitionGraph(graph, {.parts = 1});
+  EXPECT_EQ(partition.edge_cut, 0u);
+  EXPECT_EQ(partition.sizes, std::vector<size_t>{100});
+  EXPECT_DOUBLE_EQ(partition.imbalance(), 1.0);
+}
+
+TEST(PartitioningTest, TestMorePartsThanVertices)
+{
+  auto graph = gridGraph(2);
+  auto partition = graph_lib::partitionGraph(graph, {.parts = 6});
+  expectConsistent(graph, partition, 1.1);
+  EXPECT_EQ(*std::max_element(partition.sizes.begin(), partition.sizes.end()), 1u);
+}
+
+TEST(PartitioningTest, TestInvalidOptions)
+{
+  auto graph = gridGraph(3);
+  EXPECT_THROW(graph_lib::partitionGraph(graph, {.parts = 0}), std::invalid_argument);
+  EXPECT_THROW(graph_lib::partitionGraph(graph, {.imbalance = 0.5}), std::invalid_argument);
+  EXPECT_THROW(graph_lib::partitionGraph(graph, {.fennel_gamma = 0.5}), std::invalid_argument);
+  EXPECT_EQ(graph_lib::partitionGraph(CompactGraph(), {.parts = 3}).edge_cut, 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
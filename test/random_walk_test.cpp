@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/random_walk.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::CompactGraph;
+using graph_lib::RandomWalker;
+using Walks = std::vector<std::vector<unsigned int>>;
+
+
+//! \brief A snapshot over indices [0, n) whose external IDs are 100 + index.
+static CompactGraph compactFromEdges(size_t n, const std::vector<std::tuple<size_t, size_t, float>>& edges, bool directed, bool weighted)
+{
+  std::vector<unsigned int> ids(n);
+  std::iota(ids.begin(), ids.end(), 100u);
+  return CompactGraph::fromEdges(std::move(ids), edges, directed, weighted);
+}
+
+//! \brief Run the walks and collect them, sorted so that runs can be compared.
+static Walks collect(const RandomWalker& walker, const graph_lib::RandomWalkOptions& options)
+{
+  Walks walks;
+  std::mutex mutex;
+  walker.walk(options, [&](std::span<const unsigned int> walk, unsigned)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    walks.emplace_back(walk.begin(), walk.end());
+  });
+  std::sort(walks.begin(), walks.end());
+  return walks;
+}
+
+TEST(RandomWalkTest, TestWalksFollowEdges)
+{
+  auto list = graph_lib::erdosRenyiEdges(300, 3000, {.seed = 3});
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<int>>(list);
+  RandomWalker walker(CompactGraph::fromGraph(graph));
+  const auto& compact = walker.graph();
+
+  for (double p : {1.0, 0.5})
+  {
+    size_t vertices = 0;
+    auto walks = collect(walker, {.walk_length = 12, .walks_per_vertex = 3, .return_param = p, .seed = 9, .threads = 2});
+    ASSERT_EQ(walks.size(), 3 * compact.vertexCount());
+
+    std::vector<unsigned> starts(compact.vertexCount(), 0);
+    for (const auto& walk : walks)
+    {
+      ASSERT_FALSE(walk.empty());
+      ASSERT_LE(walk.size(), 12u);
+      vertices += walk.size();
+      starts[*compact.internalId(walk.front())]++;
+      for (size_t i = 0; i + 1 < walk.size(); i++)
+      {
+        auto row = compact.neighbors(*compact.internalId(walk[i]));
+        EXPECT_TRUE(std::binary_search(row.begin(), row.end(), *compact.internalId(walk[i + 1])));
+      }
+      // Only a dead end stops a walk early
+      if (walk.size() < 12) { EXPECT_EQ(compact.degree(*compact.internalId(walk.back())), 0u); }
+    }
+    EXPECT_TRUE(std::all_of(starts.begin(), starts.end(), [](unsigned count) { return count == 3; }));
+
+    size_t total = walker.walk({.walk_length = 12, .walks_per_vertex = 3, .return_param = p, .seed = 9}, [](auto, unsigned) {});
+    EXPECT_EQ(total, vertices);
+  }
+}
+
+TEST(RandomWalkTest, TestSameWalksForAnyThreadCount)
+{
+  auto list = graph_lib::barabasiAlbertEdges(200, 3, {.seed = 5});
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list);
+  RandomWalker walker(CompactGraph::fromGraph(graph), 3);
+
+  for (double q : {1.0, 2.0})
+  {
+    graph_lib::RandomWalkOptions options{.walk_length = 20, .walks_per_vertex = 2, .in_out_param = q, .seed = 11, .threads = 1};
+    auto serial = collect(walker, options);
+    options.threads = 4;
+    EXPECT_EQ(collect(walker, options), serial);
+    options.seed = 12;
+    EXPECT_NE(collect(walker, options), serial);
+  }
+}
+
+TEST(RandomWalkTest, TestWeightedSampling)
+{
+  // 0 -> 1, 2, 3 weighted 1, 2, 7, and 4 -> 5 weighted 0
+  auto compact = compactFromEdges(6, {{0, 1, 1.0f}, {0, 2, 2.0f}, {0, 3, 7.0f}, {4, 5, 0.0f}}, true, true);
+  RandomWalker walker(std::move(compact));
+
+  std::vector<size_t> counts(6, 0);
+  std::mutex mutex;
+  walker.walk({.walk_length = 2, .walks_per_vertex = 20000, .threads = 2, .internal_ids = true},
+              [&](std::span<const unsigned int> walk, unsigned)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (walk.front() == 0) { ASSERT_EQ(walk.size(), 2u); counts[walk[1]]++; }
+    else { EXPECT_EQ(walk.size(), 1u); }
+  });
+
+  EXPECT_NEAR(counts[1] / 20000.0, 0.1, 0.015);
+  EXPECT_NEAR(counts[2] / 20000.0, 0.2, 0.015);
+  EXPECT_NEAR(counts[3] / 20000.0, 0.7, 0.015);
+}
+
+TEST(RandomWalkTest, TestNode2VecBias)
+{
+  // Undirected 0 - 1, 0 - 2, 1 - 2, 1 - 3. After 0 -> 1, stepping back to 0 weighs 1 / p,
+  // to 2 (a neighbor of 0) weighs 1 and to 3 weighs 1 / q.
+  auto compact = compactFromEdges(4, {{0, 1, 1.0f}, {0, 2, 1.0f}, {1, 2, 1.0f}, {1, 3, 1.0f}}, false, false);
+  RandomWalker walker(std::move(compact));
+
+  std::vector<size_t> counts(4, 0);
+  size_t total = 0;
+  std::mutex mutex;
+  walker.walk({.walk_length = 3, .walks_per_vertex = 40000, .return_param = 4.0, .in_out_param = 0.5, .seed = 1, .internal_ids = true},
+              [&](std::span<const unsigned int> walk, unsigned)
+  {
+    if (walk[0] != 0 || walk[1] != 1) { return; }
+    std::lock_guard<std::mutex> lock(mutex);
+    counts[walk[2]]++;
+    total++;
+  });
+
+  ASSERT_GT(total, 10000u);
+  EXPECT_NEAR(static_cast<double>(counts[0]) / total, 1.0 / 13, 0.015);
+  EXPECT_NEAR(static_cast<double>(counts[2]) / total, 4.0 / 13, 0.015);
+  EXPECT_NEAR(static_cast<double>(counts[3]) / total, 8.0 / 13, 0.015);
+}
+
+TEST(RandomWalkTest, TestInvalidArguments)
+{
+  EXPECT_THROW(RandomWalker(compactFromEdges(2, {{0, 1, -1.0f}}, true, true)), std::invalid_argument);
+
+  RandomWalker walker(compactFromEdges(2, {{0, 1, 1.0f}}, true, false));
+  EXPECT_THROW(walker.walk({.return_param = 0}, [](auto, unsigned) {}), std::invalid_argument);
+  EXPECT_THROW(walker.walk({.in_out_param = -1}, [](auto, unsigned) {}), std::invalid_argument);
+  EXPECT_EQ(walker.walk({.walk_length = 0}, [](auto, unsigned) {}), 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
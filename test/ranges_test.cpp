@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <ranges>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+static_assert(std::ranges::view<graph_lib::DFSView<int>>);
+static_assert(std::ranges::view<graph_lib::BFSView<int>>);
+static_assert(std::ranges::input_range<graph_lib::DFSView<int>>);
+static_assert(std::ranges::view<graph_lib::NeighborView<int>>);
+static_assert(std::input_iterator<graph_lib::GraphIterator<int>>);
+
+
+class RangesTestBasic : public testing::Test
+{
+public:
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+
+  void SetUp()
+  {
+    for (int i = 0; i < 7; i++) { ids.push_back(*graph.addVertex(i)); }
+
+    graph.addEdge(ids[0], ids[1]);
+    graph.addEdge(ids[0], ids[3]);
+    graph.addEdge(ids[1], ids[2]);
+    graph.addEdge(ids[3], ids[2]);
+    graph.addEdge(ids[3], ids[4]);
+    graph.addEdge(ids[5], ids[6]);
+  }
+
+  template <typename R>
+  static std::vector<int> values(R&& range)
+  {
+    std::vector<int> result;
+    for (const auto& vertex : range) { result.push_back(*(*vertex).data); }
+    return result;
+  }
+};
+
+TEST_F(RangesTestBasic, TestVertices)
+{
+  auto all = values(graph.vertices());
+  EXPECT_EQ(all.size(), 7u);
+  EXPECT_EQ(std::ranges::distance(graph.vertices()), 7);
+}
+
+TEST_F(RangesTestBasic, TestNeighbors)
+{
+  auto adjacent = values(graph.neighbors(ids[3]));
+  EXPECT_EQ(std::set<int>(adjacent.begin(), adjacent.end()), (std::set<int>{2, 4}));
+  EXPECT_TRUE(std::ranges::empty(graph.neighbors(ids[4])));
+  EXPECT_TRUE(std::ranges::empty(graph.neighbors(-1)));
+}
+
+TEST_F(RangesTestBasic, TestTraversalsReachOnlyFromSource)
+{
+  auto dfs = values(graph.dfs(ids[0]));
+  auto bfs = values(graph.bfs(ids[0]));
+  EXPECT_EQ(std::set<int>(dfs.begin(), dfs.end()), (std::set<int>{0, 1, 2, 3, 4}));
+  EXPECT_EQ(dfs.size(), 5u);
+  EXPECT_EQ(bfs.size(), 5u);
+  EXPECT_EQ(bfs.front(), 0);
+  EXPECT_EQ(std::set<int>(bfs.begin() + 1, bfs.begin() + 3), (std::set<int>{1, 3}));
+
+  EXPECT_EQ(values(graph.bfs(ids[5])), (std::vector<int>{5, 6}));
+  EXPECT_TRUE(values(graph.dfs(-1)).empty());
+}
+
+TEST_F(RangesTestBasic, TestPipelineStopsEarly)
+{
+  auto odd = graph.bfs(ids[0])
+    | std::views::filter([](const auto& vertex) { return *(*vertex).data % 2 == 1; })
+    | std::views::transform([](const auto& vertex) { return *(*vertex).data; })
+    | std::views::take(1);
+
+  std::vector<int> result;
+  for (int value : odd) { result.push_back(value); }
+  EXPECT_EQ(result.size(), 1u);
+  EXPECT_TRUE(result[0] == 1 || result[0] == 3);
+}
+
+TEST(RangesTest, TestUndirectedDepthFirst)
+{
+  graph_lib::UnweightedUndirectedGraph<int> graph;
+  auto id0 = graph.addVertex(0);
+  auto id1 = graph.addVertex(1);
+  auto id2 = graph.addVertex(2);
+  graph.addEdge(*id0, *id1);
+  graph.addEdge(*id1, *id2);
+  graph.addEdge(*id2, *id0);
+
+  size_t count = 0;
+  for (const auto& vertex : graph.dfs(*id1)) { (void)vertex; count++; }
+  EXPECT_EQ(count, 3u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
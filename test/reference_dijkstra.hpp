@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <graph_lib/compact_graph.hpp>
+
+
+//! \brief Plain Dijkstra from one vertex over a whole snapshot, as a reference for the tests.
+//! Unweighted snapshots weigh every edge 1, so the distances are hop counts.
+//!
+//! \param [in] graph The snapshot.
+//! \param [in] source The internal index of the source.
+//! \return std::vector<float> The distance of every vertex by internal index, infinite when unreachable.
+inline std::vector<float> referenceDistances(const graph_lib::CompactGraph& graph, graph_lib::CompactGraph::Index source)
+{
+  using Entry = std::pair<float, graph_lib::CompactGraph::Index>;
+  std::vector<float> distance(graph.vertexCount(), std::numeric_limits<float>::infinity());
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap;
+  distance[source] = 0;
+  heap.emplace(0.0f, source);
+  while (!heap.empty())
+  {
+    auto [d, v] = heap.top();
+    heap.pop();
+    if (d > distance[v]) { continue; }
+    const auto row = graph.neighbors(v);
+    for (size_t i = 0; i < row.size(); i++)
+    {
+      const float candidate = d + graph.weight(v, i);
+      if (candidate < distance[row[i]]) { distance[row[i]] = candidate; heap.emplace(candidate, row[i]); }
+    }
+  }
+  return distance;
+}
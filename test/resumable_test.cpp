@@ -0,0 +1,123 @@
+#include <chrono>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/resumable.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::TraversalBudget;
+using graph_lib::TraversalStatus;
+
+
+class ResumableTestBasic : public testing::Test
+{
+public:
+  using Graph = graph_lib::UnweightedUndirectedGraph<unsigned int>;
+
+  //! \brief A 20x20 grid, vertex r * 20 + c storing its index.
+  Graph graph = graph_lib::buildGraph<Graph>(graph_lib::gridEdges(20, 20));
+  unsigned int source = idOf(0);
+
+  unsigned int idOf(unsigned int value) const
+  {
+    for (const auto& vertex : graph.getVertices()) { if (*(*vertex).data == value) { return (*vertex).getID(); } }
+    return 0;
+  }
+
+  //! \brief The values produced by running a traversal to the end in slices.
+  template <typename Traversal>
+  static std::vector<unsigned int> drain(Traversal& traversal, const TraversalBudget& budget, size_t& slices)
+  {
+    std::vector<unsigned int> values;
+    slices = 0;
+    while (!traversal.finished())
+    {
+      slices++;
+      for (const auto& vertex : traversal.run(budget)) { values.push_back(*(*vertex).data); }
+    }
+    return values;
+  }
+};
+
+TEST_F(ResumableTestBasic, TestSlicedBreadthFirstMatchesFullRun)
+{
+  std::vector<unsigned int> expected;
+  auto full = graph_lib::resumableBfs(graph, source);
+  EXPECT_EQ(full.run(TraversalBudget(), [&](const auto& vertex, unsigned) { expected.push_back(*(*vertex).data); }),
+            TraversalStatus::Finished);
+  EXPECT_EQ(expected.size(), 400u);
+
+  size_t slices;
+  auto sliced = graph_lib::resumableBfs(graph, source);
+  EXPECT_EQ(drain(sliced, TraversalBudget::ofEdges(7), slices), expected);
+  EXPECT_EQ(sliced.edgesScanned(), full.edgesScanned());
+  EXPECT_EQ(sliced.verticesProduced(), 400u);
+  EXPECT_GE(slices, full.edgesScanned() / 7);
+}
+
+TEST_F(ResumableTestBasic, TestSlicedDepthFirstMatchesFullRun)
+{
+  auto full = graph_lib::resumableDfs(graph, source);
+  auto expected = full.run(TraversalBudget());
+  EXPECT_TRUE(full.finished());
+
+  size_t slices;
+  auto sliced = graph_lib::resumableDfs(graph, source);
+  auto values = drain(sliced, TraversalBudget::ofEdges(1), slices);
+  ASSERT_EQ(values.size(), expected.size());
+  for (size_t i = 0; i < values.size(); i++) { EXPECT_EQ(values[i], *(*expected[i]).data); }
+  EXPECT_EQ(std::set<unsigned int>(values.begin(), values.end()).size(), 400u);
+}
+
+TEST_F(ResumableTestBasic, TestDepths)
+{
+  // In a grid the breadth first depth is the Manhattan distance from the corner
+  auto traversal = graph_lib::resumableBfs(graph, source);
+  traversal.run(TraversalBudget(), [](const auto& vertex, unsigned depth)
+  {
+    const unsigned int value = *(*vertex).data;
+    EXPECT_EQ(depth, value / 20 + value % 20);
+  });
+}
+
+TEST_F(ResumableTestBasic, TestTimeBudget)
+{
+  auto traversal = graph_lib::resumableBfs(graph, source);
+  size_t produced = 0;
+  while (traversal.run(TraversalBudget::ofTime(std::chrono::microseconds(1)), [&](const auto&, unsigned) { produced++; })
+         == TraversalStatus::Suspended) {}
+  EXPECT_TRUE(traversal.finished());
+  EXPECT_EQ(produced, 400u);
+}
+
+TEST_F(ResumableTestBasic, TestInterleaved)
+{
+  // Two traversals sharing one thread do not disturb each other
+  auto first = graph_lib::resumableBfs(graph, source);
+  auto second = graph_lib::resumableDfs(graph, idOf(399));
+  std::set<unsigned int> first_values, second_values;
+  while (!first.finished() || !second.finished())
+  {
+    for (const auto& vertex : first.run(TraversalBudget::ofEdges(5))) { first_values.insert(*(*vertex).data); }
+    for (const auto& vertex : second.run(TraversalBudget::ofEdges(3))) { second_values.insert(*(*vertex).data); }
+  }
+  EXPECT_EQ(first_values.size(), 400u);
+  EXPECT_EQ(second_values.size(), 400u);
+}
+
+TEST(ResumableTest, TestMissingSource)
+{
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  auto id = graph.addVertex(0);
+  auto traversal = graph_lib::resumableBfs(graph, *id + 1000);
+  EXPECT_TRUE(traversal.run(TraversalBudget::ofEdges(1)).empty());
+  EXPECT_TRUE(traversal.finished());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
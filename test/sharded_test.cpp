@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <graph_lib/compact_graph.hpp>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/sharded.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+#include "reference_dijkstra.hpp"
+
+using graph_lib::CompactGraph;
+using graph_lib::Shard;
+using graph_lib::ShardTransport;
+
+
+//! \brief Run a sharded search on one thread per shard and gather the distances by internal index of graph.
+template <typename Search, typename MakeTransport>
+static std::vector<float> runOnThreads(const CompactGraph& graph, const std::vector<Shard>& shards, Search search, MakeTransport make_transport, unsigned source_id)
+{
+  std::vector<std::vector<float>> results(shards.size());
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned s = 0; s < shards.size(); s++)
+    {
+      workers.emplace_back([&, s]
+      {
+        std::unique_ptr<ShardTransport> transport = make_transport(s);
+        results[s] = search(shards[s], *transport, source_id);
+      });
+    }
+  }
+
+  std::vector<float> distance(graph.vertexCount(), -1);
+  for (const auto& shard : shards)
+  {
+    EXPECT_EQ(results[shard.id].size(), shard.owned);
+    for (CompactGraph::Index v = 0; v < shard.owned; v++)
+    {
+      distance[*graph.internalId(shard.graph.externalId(v))] = results[shard.id][v];
+    }
+  }
+  return distance;
+}
+
+TEST(ShardedTest, TestGhostMaps)
+{
+  auto list = graph_lib::rmatEdges(9, 3000, {}, {.seed = 2});
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+  auto partition = graph_lib::partitionGraph(graph, {.parts = 3});
+  auto shards = graph_lib::buildShards(graph, partition);
+  ASSERT_EQ(shards.size(), 3u);
+
+  size_t owned = 0, edges = 0, ghost_edges = 0;
+  for (const auto& shard : shards)
+  {
+    EXPECT_EQ(shard.owned, partition.sizes[shard.id]);
+    owned += shard.owned;
+    edges += shard.graph.edgeCount();
+    ASSERT_EQ(shard.ghost_owner.size(), shard.graph.vertexCount() - shard.owned);
+    for (CompactGraph::Index v = 0; v < shard.graph.vertexCount(); v++)
+    {
+      const auto global = *graph.internalId(shard.graph.externalId(v));
+      if (!shard.isGhost(v))
+      {
+        EXPECT_EQ(partition.assignment[global], shard.id);
+        EXPECT_EQ(shard.graph.degree(v), graph.degree(global));
+        for (auto u : shard.graph.neighbors(v)) { ghost_edges += shard.isGhost(u); }
+        continue;
+      }
+      // The ghost map points at the same vertex in its owner
+      const size_t g = v - shard.owned;
+      const auto& owner = shards[shard.ghost_owner[g]];
+      EXPECT_NE(owner.id, shard.id);
+      EXPECT_FALSE(owner.isGhost(shard.ghost_index[g]));
+      EXPECT_EQ(owner.graph.externalId(shard.ghost_index[g]), shard.graph.externalId(v));
+      EXPECT_EQ(shard.graph.degree(v), 0u);
+    }
+  }
+  EXPECT_EQ(owned, graph.vertexCount());
+  EXPECT_EQ(edges, graph.edgeCount());
+  EXPECT_EQ(ghost_edges, partition.edge_cut);
+}
+
+TEST(ShardedTest, TestBfsOverSharedMemory)
+{
+  auto list = graph_lib::rmatEdges(10, 8000, {}, {.seed = 3});
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedDirectedGraph<int>>(list));
+  auto shards = graph_lib::buildShards(graph, graph_lib::partitionGraph(graph, {.parts = 4}));
+
+  for (CompactGraph::Index source : {0u, 33u})
+  {
+    graph_lib::SharedMemoryHub hub(4);
+    auto distance = runOnThreads(graph, shards, graph_lib::shardedBfs,
+                                 [&](unsigned s) { return std::make_unique<graph_lib::SharedMemoryTransport>(hub, s); },
+                                 graph.externalId(source));
+    EXPECT_EQ(distance, referenceDistances(graph, source));
+  }
+}
+
+TEST(ShardedTest, TestShortestPathsOverSockets)
+{
+  auto list = graph_lib::erdosRenyiEdges(600, 3000, {.seed = 4, .weights = graph_lib::WeightDistribution::uniform(1, 9)});
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list);
+  auto compact = CompactGraph::fromGraph(graph);
+  auto shards = graph_lib::buildShards(graph, {.parts = 3, .method = graph_lib::PartitionMethod::LinearDeterministicGreedy});
+
+  auto mesh = graph_lib::socketMesh(3);
+  auto distance = runOnThreads(compact, shards, graph_lib::shardedShortestPaths,
+                               [&](unsigned s) { return std::make_unique<graph_lib::SocketTransport>(s, mesh[s]); },
+                               compact.externalId(7));
+  auto expected = referenceDistances(compact, 7);
+  for (size_t v = 0; v < expected.size(); v++) { EXPECT_FLOAT_EQ(distance[v], expected[v]) << "vertex " << v; }
+}
+
+TEST(ShardedTest, TestTransportsDeliverToSelf)
+{
+  // Each shard sends (rank, destination) to every shard, itself included
+  auto run = [](const std::function<std::unique_ptr<graph_lib::ShardTransport>(unsigned)>& make)
+  {
+    std::vector<std::vector<graph_lib::ShardMessage>> received(3);
+    std::vector<std::thread> threads;
+    for (unsigned s = 0; s < 3; s++)
+    {
+      threads.emplace_back([&, s]
+      {
+        auto transport = make(s);
+        std::vector<std::vector<graph_lib::ShardMessage>> outgoing(3);
+        for (unsigned to = 0; to < 3; to++) { outgoing[to].push_back({s, static_cast<float>(to)}); }
+        EXPECT_TRUE(transport->exchange(outgoing, received[s]));
+      });
+    }
+    for (auto& thread : threads) { thread.join(); }
+    return received;
+  };
+
+  graph_lib::SharedMemoryHub hub(3);
+  auto shared = run([&](unsigned s) { return std::make_unique<graph_lib::SharedMemoryTransport>(hub, s); });
+  auto mesh = graph_lib::socketMesh(3);
+  auto sockets = run([&](unsigned s) { return std::make_unique<graph_lib::SocketTransport>(s, mesh[s]); });
+  for (unsigned s = 0; s < 3; s++)
+  {
+    ASSERT_EQ(shared[s].size(), 3u);
+    ASSERT_EQ(sockets[s].size(), 3u);
+    for (unsigned from = 0; from < 3; from++)
+    {
+      EXPECT_EQ(shared[s][from].target, from);
+      EXPECT_EQ(sockets[s][from].target, from);
+      EXPECT_EQ(sockets[s][from].value, static_cast<float>(s));
+    }
+  }
+}
+
+TEST(ShardedTest, TestMissingSource)
+{
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedUndirectedGraph<int>>(graph_lib::gridEdges(5, 5)));
+  auto shards = graph_lib::buildShards(graph, graph_lib::partitionGraph(graph, {.parts = 2}));
+  graph_lib::SharedMemoryHub hub(2);
+  auto distance = runOnThreads(graph, shards, graph_lib::shardedBfs,
+                               [&](unsigned s) { return std::make_unique<graph_lib::SharedMemoryTransport>(hub, s); },
+                               1u << 30);
+  for (float d : distance) { EXPECT_TRUE(std::isinf(d)); }
+}
+
+TEST(ShardedTest, TestWorkerProcesses)
+{
+  auto list = graph_lib::rmatEdges(9, 4000, {}, {.seed = 6, .weights = graph_lib::WeightDistribution::uniform(1, 4)});
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<int>>(list));
+  auto shards = graph_lib::buildShards(graph, graph_lib::partitionGraph(graph, {.parts = 3}));
+  const size_t n = graph.vertexCount();
+
+  // Each worker writes the distances of its vertices into memory shared with the parent
+  void* shared = ::mmap(nullptr, n * sizeof(float), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(shared, MAP_FAILED);
+  auto* distance = static_cast<float*>(shared);
+  std::fill(distance, distance + n, -1.0f);
+
+  auto mesh = graph_lib::socketMesh(3);
+  std::vector<pid_t> children;
+  for (unsigned s = 0; s < 3; s++)
+  {
+    const pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid != 0) { children.push_back(pid); continue; }
+
+    for (unsigned other = 0; other < 3; other++)
+    {
+      if (other == s) { continue; }
+      for (int fd : mesh[other]) { if (fd >= 0) { ::close(fd); } }
+    }
+    int status = 0;
+    try
+    {
+      graph_lib::SocketTransport transport(s, mesh[s]);
+      auto result = graph_lib::shardedShortestPaths(shards[s], transport, graph.externalId(0));
+      for (CompactGraph::Index v = 0; v < shards[s].owned; v++) { distance[*graph.internalId(shards[s].graph.externalId(v))] = result[v]; }
+    }
+    catch (...) { status = 1; }
+    ::_exit(status);
+  }
+
+  for (auto& row : mesh) { for (int fd : row) { if (fd >= 0) { ::close(fd); } } }
+  for (pid_t pid : children)
+  {
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  auto expected = referenceDistances(graph, 0);
+  for (size_t v = 0; v < n; v++) { EXPECT_FLOAT_EQ(distance[v], expected[v]) << "vertex " << v; }
+  ::munmap(shared, n * sizeof(float));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/shortest_path.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+#include "reference_dijkstra.hpp"
+
+using graph_lib::CompactGraph;
+
+
+//! \brief Check that a path exists in the graph and has the reported length.
+static void expectValidPath(const CompactGraph& graph, const graph_lib::PathResult& result)
+{
+  float length = 0;
+  for (size_t i = 0; i + 1 < result.path.size(); i++)
+  {
+    const auto v = *graph.internalId(result.path[i]);
+    const auto u = *graph.internalId(result.path[i + 1]);
+    float best = std::numeric_limits<float>::infinity();
+    for (size_t e = 0; e < graph.degree(v); e++) { if (graph.neighbors(v)[e] == u) { best = std::min(best, graph.weight(v, e)); } }
+    ASSERT_TRUE(std::isfinite(best));
+    length += best;
+  }
+  EXPECT_NEAR(length, result.distance, 1e-3);
+}
+
+template <typename G>
+static void checkAgainstReference()
+{
+  auto list = graph_lib::erdosRenyiEdges(200, 600, {.seed = 11, .weights = graph_lib::WeightDistribution::uniform(1, 10)});
+  graph_lib::ShortestPathEngine engine(CompactGraph::fromGraph(graph_lib::buildGraph<G>(list)));
+  const auto& graph = engine.graph();
+  graph_lib::PathSearchState state;
+
+  for (CompactGraph::Index source = 0; source < 20; source++)
+  {
+    const auto expected = referenceDistances(graph, source);
+    for (CompactGraph::Index target = 0; target < graph.vertexCount(); target += 7)
+    {
+      auto result = engine.bidirectionalDijkstra(graph.externalId(source), graph.externalId(target), state);
+      auto astar = engine.aStar(graph.externalId(source), graph.externalId(target), [](unsigned int, unsigned int) { return 0.0f; }, state);
+      if (std::isinf(expected[target]))
+      {
+        EXPECT_FALSE(result.found());
+        EXPECT_FALSE(astar.found());
+        continue;
+      }
+      EXPECT_NEAR(result.distance, expected[target], 1e-3);
+      EXPECT_NEAR(astar.distance, expected[target], 1e-3);
+      EXPECT_EQ(result.path.front(), graph.externalId(source));
+      EXPECT_EQ(result.path.back(), graph.externalId(target));
+      expectValidPath(graph, result);
+      expectValidPath(graph, astar);
+    }
+  }
+}
+
+TEST(ShortestPathTest, TestDirectedMatchesDijkstra)
+{
+  checkAgainstReference<graph_lib::WeightedDirectedGraph<unsigned int>>();
+}
+
+TEST(ShortestPathTest, TestUndirectedMatchesDijkstra)
+{
+  checkAgainstReference<graph_lib::WeightedUndirectedGraph<unsigned int>>();
+}
+
+TEST(ShortestPathTest, TestAStarOnGrid)
+{
+  // On a unit grid the Manhattan distance is admissible and exact
+  constexpr unsigned kSide = 30;
+  auto graph = graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<unsigned int>>(graph_lib::gridEdges(kSide, kSide));
+  graph_lib::ShortestPathEngine engine(CompactGraph::fromGraph(graph));
+  const auto& compact = engine.graph();
+
+  // Internal indices follow the external IDs, which follow the grid index
+  auto cell = [&](unsigned int id) { return *compact.internalId(id); };
+  auto manhattan = [&](unsigned int a, unsigned int b)
+  {
+    const unsigned ca = cell(a), cb = cell(b);
+    return static_cast<float>(std::abs(int(ca / kSide) - int(cb / kSide)) + std::abs(int(ca % kSide) - int(cb % kSide)));
+  };
+
+  const unsigned int source = compact.externalId(0), target = compact.externalId(kSide - 1);
+  auto guided = engine.aStar(source, target, manhattan);
+  auto blind = engine.aStar(source, target, [](unsigned int, unsigned int) { return 0.0f; });
+  auto bidirectional = engine.bidirectionalDijkstra(source, target);
+
+  EXPECT_FLOAT_EQ(guided.distance, kSide - 1);
+  EXPECT_FLOAT_EQ(blind.distance, guided.distance);
+  EXPECT_FLOAT_EQ(bidirectional.distance, guided.distance);
+  EXPECT_EQ(guided.path.size(), kSide);
+  EXPECT_LT(guided.settled, blind.settled);
+}
+
+TEST(ShortestPathTest, TestEdgeCases)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto id0 = graph.addVertex(0);
+  auto id1 = graph.addVertex(1);
+  auto id2 = graph.addVertex(2);
+  graph.addEdge(*id0, *id1, 2.0f);
+  graph.addEdge(*id1, *id2, 3.0f);
+  graph.addEdge(*id0, *id2, 9.0f);
+  graph_lib::ShortestPathEngine engine(CompactGraph::fromGraph(graph));
+
+  auto path = engine.bidirectionalDijkstra(*id0, *id2);
+  EXPECT_FLOAT_EQ(path.distance, 5.0f);
+  EXPECT_EQ(path.path, (std::vector<unsigned int>{*id0, *id1, *id2}));
+
+  auto same = engine.bidirectionalDijkstra(*id1, *id1);
+  EXPECT_FLOAT_EQ(same.distance, 0.0f);
+  EXPECT_EQ(same.path, (std::vector<unsigned int>{*id1}));
+
+  EXPECT_FALSE(engine.bidirectionalDijkstra(*id2, *id0).found());
+  EXPECT_TRUE(std::isinf(engine.aStar(*id2, *id0, [](unsigned int, unsigned int) { return 0.0f; }).distance));
+  EXPECT_FALSE(engine.bidirectionalDijkstra(*id0, *id2 + 1000).found());
+}
+
+TEST(ShortestPathTest, TestConcurrentQueries)
+{
+  auto list = graph_lib::erdosRenyiEdges(300, 1200, {.seed = 3, .weights = graph_lib::WeightDistribution::uniform(1, 5)});
+  graph_lib::ShortestPathEngine engine(CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedDirectedGraph<unsigned int>>(list)));
+  const auto& graph = engine.graph();
+
+  std::vector<float> expected, serial(4 * 50), parallel(4 * 50);
+  for (size_t i = 0; i < serial.size(); i++)
+  {
+    serial[i] = engine.bidirectionalDijkstra(graph.externalId(i % 300), graph.externalId((i * 37) % 300)).distance;
+  }
+  {
+    std::vector<std::jthread> threads;
+    for (size_t t = 0; t < 4; t++)
+    {
+      threads.emplace_back([&, t]()
+      {
+        for (size_t i = t * 50; i < (t + 1) * 50; i++)
+        {
+          parallel[i] = engine.bidirectionalDijkstra(graph.externalId(i % 300), graph.externalId((i * 37) % 300)).distance;
+        }
+      });
+    }
+  }
+  EXPECT_EQ(serial, parallel);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/generators.hpp>
+#include <graph_lib/spanning_forest.hpp>
+#include <graph_lib/undirected_graph.hpp>
+
+using graph_lib::CompactGraph;
+
+
+//! \brief Union-find over internal IDs, for the reference and for checking forests.
+struct DisjointSets
+{
+  std::vector<size_t> parent;
+
+  explicit DisjointSets(size_t n): parent(n) { std::iota(parent.begin(), parent.end(), size_t{0}); }
+
+  size_t find(size_t v) { while (parent[v] != v) { v = parent[v] = parent[parent[v]]; } return v; }
+
+  bool unite(size_t a, size_t b)
+  {
+    a = find(a);
+    b = find(b);
+    if (a == b) { return false; }
+    parent[a] = b;
+    return true;
+  }
+};
+
+//! \brief Kruskal's algorithm, as a reference.
+static double referenceWeight(const CompactGraph& graph)
+{
+  std::vector<std::tuple<float, size_t, size_t>> edges;
+  for (size_t v = 0; v < graph.vertexCount(); v++)
+  {
+    for (size_t i = 0; i < graph.degree(v); i++) { edges.emplace_back(graph.weight(v, i), v, graph.neighbors(v)[i]); }
+  }
+  std::sort(edges.begin(), edges.end());
+  DisjointSets sets(graph.vertexCount());
+  double total = 0;
+  for (const auto& [weight, a, b] : edges) { if (sets.unite(a, b)) { total += weight; } }
+  return total;
+}
+
+//! \brief Check that the forest is acyclic and has one tree per connected component.
+static void expectSpanningForest(const CompactGraph& graph, const graph_lib::SpanningForest& forest)
+{
+  DisjointSets forest_sets(graph.vertexCount());
+  for (const auto& edge : forest.edges)
+  {
+    EXPECT_TRUE(forest_sets.unite(*graph.internalId(edge.origin), *graph.internalId(edge.dest)));
+  }
+  DisjointSets graph_sets(graph.vertexCount());
+  size_t components = graph.vertexCount();
+  for (size_t v = 0; v < graph.vertexCount(); v++)
+  {
+    for (auto u : graph.neighbors(v)) { components -= graph_sets.unite(v, u); }
+  }
+  EXPECT_EQ(forest.trees, components);
+  EXPECT_EQ(forest.edges.size(), graph.vertexCount() - components);
+}
+
+TEST(SpanningForestTest, TestMatchesKruskal)
+{
+  for (uint64_t seed : {1, 2, 3})
+  {
+    auto list = graph_lib::erdosRenyiEdges(500, 1500, {.seed = seed, .weights = graph_lib::WeightDistribution::uniform(1, 100)});
+    auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::WeightedUndirectedGraph<int>>(list));
+    for (unsigned threads : {1u, 4u})
+    {
+      auto forest = graph_lib::minimumSpanningForest(graph, {.threads = threads});
+      expectSpanningForest(graph, forest);
+      EXPECT_NEAR(forest.total_weight, referenceWeight(graph), 1e-2);
+    }
+  }
+}
+
+TEST(SpanningForestTest, TestEqualWeights)
+{
+  // Every edge ties, so only the tie break keeps the picked edges acyclic
+  auto list = graph_lib::gridEdges(20, 20, {.seed = 1});
+  auto graph = CompactGraph::fromGraph(graph_lib::buildGraph<graph_lib::UnweightedUndirectedGraph<int>>(list));
+  auto forest = graph_lib::minimumSpanningForest(graph, {.threads = 4});
+  expectSpanningForest(graph, forest);
+  EXPECT_EQ(forest.trees, 1u);
+  EXPECT_DOUBLE_EQ(forest.total_weight, 399);
+}
+
+TEST(SpanningForestTest, TestDisconnectedGraph)
+{
+  graph_lib::WeightedUndirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+  for (int i = 0; i < 7; i++) { ids.push_back(*graph.addVertex(i)); }
+  // Triangle 0-1-2, edge 3-4, isolated 5 and 6
+  graph.addEdge(ids[0], ids[1], 3.0f);
+  graph.addEdge(ids[1], ids[2], 1.0f);
+  graph.addEdge(ids[0], ids[2], 2.0f);
+  graph.addEdge(ids[3], ids[4], -4.0f);
+
+  auto forest = graph_lib::minimumSpanningForest(graph);
+  EXPECT_EQ(forest.trees, 4u);
+  ASSERT_EQ(forest.edges.size(), 3u);
+  EXPECT_DOUBLE_EQ(forest.total_weight, -1);
+  for (const auto& edge : forest.edges) { EXPECT_NE(edge.weight, 3.0f); }
+}
+
+TEST(SpanningForestTest, TestRejectsDirectedGraph)
+{
+  graph_lib::WeightedDirectedGraph<int> graph;
+  auto a = *graph.addVertex(0);
+  auto b = *graph.addVertex(1);
+  graph.addEdge(a, b, 1.0f);
+  EXPECT_THROW(graph_lib::minimumSpanningForest(graph), std::invalid_argument);
+}
+
+TEST(SpanningForestTest, TestEmptyGraph)
+{
+  auto forest = graph_lib::minimumSpanningForest(graph_lib::WeightedUndirectedGraph<int>());
+  EXPECT_TRUE(forest.edges.empty());
+  EXPECT_EQ(forest.trees, 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
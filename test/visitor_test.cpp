@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <graph_lib/directed_graph.hpp>
+#include <graph_lib/graph_view.hpp>
+#include <graph_lib/undirected_graph.hpp>
+#include <graph_lib/visitor.hpp>
+
+using graph_lib::VisitAction;
+
+
+class VisitorTestBasic : public testing::Test
+{
+public:
+  using VertexPtr = std::shared_ptr<graph_lib::Vertex<int>>;
+
+  graph_lib::UnweightedDirectedGraph<int> graph;
+  std::vector<unsigned int> ids;
+
+  //! \brief A chain 0 -> 1 -> 2 -> 3 -> 4, with a branch 1 -> 5 and an unreachable 6.
+  void SetUp()
+  {
+    for (int i = 0; i < 7; i++) { ids.push_back(*graph.addVertex(i)); }
+
+    graph.addEdge(ids[0], ids[1]);
+    graph.addEdge(ids[1], ids[2]);
+    graph.addEdge(ids[2], ids[3]);
+    graph.addEdge(ids[3], ids[4]);
+    graph.addEdge(ids[1], ids[5]);
+  }
+};
+
+//! \brief Records every callback.
+struct RecordingVisitor
+{
+  std::map<int, unsigned> depths;
+  std::vector<int> finished;
+  size_t edges = 0;
+
+  void discoverVertex(const VisitorTestBasic::VertexPtr& vertex, unsigned depth) { depths[*(*vertex).data] = depth; }
+  void examineEdge(const VisitorTestBasic::VertexPtr&, const VisitorTestBasic::VertexPtr&, float) { edges++; }
+  void finishVertex(const VisitorTestBasic::VertexPtr& vertex) { finished.push_back(*(*vertex).data); }
+};
+
+TEST_F(VisitorTestBasic, TestBreadthFirstDepths)
+{
+  RecordingVisitor visitor;
+  auto summary = graph_lib::breadthFirstVisit(graph, ids[0], visitor);
+
+  EXPECT_FALSE(summary.stopped);
+  EXPECT_EQ(summary.vertices_discovered, 6u);
+  EXPECT_EQ(summary.edges_examined, 5u);
+  EXPECT_EQ(visitor.edges, 5u);
+  EXPECT_EQ(visitor.depths, (std::map<int, unsigned>{{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 2}}));
+  EXPECT_EQ(visitor.finished.size(), 6u);
+  EXPECT_EQ(visitor.finished.front(), 0);
+}
+
+TEST_F(VisitorTestBasic, TestDepthFirstPostOrder)
+{
+  RecordingVisitor visitor;
+  auto summary = graph_lib::depthFirstVisit(graph, ids[0], visitor);
+
+  EXPECT_FALSE(summary.stopped);
+  EXPECT_EQ(summary.vertices_discovered, 6u);
+  EXPECT_EQ(visitor.depths.at(4), 4u);
+  ASSERT_EQ(visitor.finished.size(), 6u);
+  EXPECT_EQ(visitor.finished.back(), 0);
+  EXPECT_EQ(visitor.finished[visitor.finished.size() - 2], 1);
+
+  // Every vertex finishes after its descendants
+  auto position = [&](int value) { return std::find(visitor.finished.begin(), visitor.finished.end(), value) - visitor.finished.begin(); };
+  EXPECT_LT(position(4), position(3));
+  EXPECT_LT(position(3), position(2));
+  EXPECT_LT(position(5), position(1));
+}
+
+TEST_F(VisitorTestBasic, TestDepthLimit)
+{
+  RecordingVisitor bfs, dfs;
+  graph_lib::breadthFirstVisit(graph, ids[0], bfs, 2);
+  graph_lib::depthFirstVisit(graph, ids[0], dfs, 2);
+
+  EXPECT_EQ(bfs.depths, (std::map<int, unsigned>{{0, 0}, {1, 1}, {2, 2}, {5, 2}}));
+  EXPECT_EQ(dfs.depths, bfs.depths);
+  EXPECT_EQ(bfs.edges, 3u);
+  EXPECT_EQ(dfs.edges, 3u);
+}
+
+TEST_F(VisitorTestBasic, TestStopOnTarget)
+{
+  for (bool depth_first : {false, true})
+  {
+    size_t discovered = 0;
+    struct
+    {
+      size_t* discovered;
+      VisitAction discoverVertex(const VertexPtr& vertex, unsigned)
+      {
+        (*discovered)++;
+        return *(*vertex).data == 2 ? VisitAction::Stop : VisitAction::Continue;
+      }
+    } visitor{&discovered};
+
+    auto summary = depth_first ? graph_lib::depthFirstVisit(graph, ids[0], visitor)
+                               : graph_lib::breadthFirstVisit(graph, ids[0], visitor);
+    EXPECT_TRUE(summary.stopped);
+    EXPECT_EQ(summary.vertices_discovered, discovered);
+    EXPECT_LE(discovered, 4u);
+  }
+}
+
+TEST_F(VisitorTestBasic, TestSkip)
+{
+  // Skipping vertex 1 prunes everything below it
+  struct
+  {
+    std::vector<int> seen;
+    VisitAction discoverVertex(const VertexPtr& vertex, unsigned)
+    {
+      seen.push_back(*(*vertex).data);
+      return *(*vertex).data == 1 ? VisitAction::Skip : VisitAction::Continue;
+    }
+  } prune;
+  graph_lib::depthFirstVisit(graph, ids[0], prune);
+  EXPECT_EQ(prune.seen, (std::vector<int>{0, 1}));
+
+  // Skipping the edge 1 -> 2 keeps 5 reachable
+  struct
+  {
+    std::vector<int> seen;
+    void discoverVertex(const VertexPtr& vertex, unsigned) { seen.push_back(*(*vertex).data); }
+    VisitAction examineEdge(const VertexPtr&, const VertexPtr& dest, float)
+    {
+      return *(*dest).data == 2 ? VisitAction::Skip : VisitAction::Continue;
+    }
+  } skip_edge;
+  graph_lib::breadthFirstVisit(graph, ids[0], skip_edge);
+  EXPECT_EQ(skip_edge.seen, (std::vector<int>{0, 1, 5}));
+}
+
+TEST_F(VisitorTestBasic, TestMissingSource)
+{
+  RecordingVisitor visitor;
+  auto summary = graph_lib::breadthFirstVisit(graph, ids.back() + 1000, visitor);
+  EXPECT_EQ(summary.vertices_discovered, 0u);
+  EXPECT_TRUE(visitor.depths.empty());
+}
+
+TEST(VisitorTest, TestWeightedView)
+{
+  graph_lib::WeightedUndirectedGraph<int> graph;
+  auto id0 = graph.addVertex(0);
+  auto id1 = graph.addVertex(1);
+  auto id2 = graph.addVertex(2);
+  graph.addEdge(*id0, *id1, 1.0f);
+  graph.addEdge(*id1, *id2, 5.0f);
+  graph.addEdge(*id0, *id2, 9.0f);
+
+  // Only light edges are followed through the view
+  auto light = graph_lib::filterEdges(graph, [](const auto&, const auto&, float weight) { return weight < 6.0f; });
+  struct
+  {
+    float total = 0;
+    void examineEdge(const std::shared_ptr<graph_lib::Vertex<int>>&, const std::shared_ptr<graph_lib::Vertex<int>>&, float weight) { total += weight; }
+  } visitor;
+  auto summary = graph_lib::breadthFirstVisit(light, *id0, visitor);
+
+  EXPECT_EQ(summary.vertices_discovered, 3u);
+  EXPECT_EQ(summary.edges_examined, 4u);
+  EXPECT_FLOAT_EQ(visitor.total, 12.0f);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}